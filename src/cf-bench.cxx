@@ -0,0 +1,639 @@
+/*\
+ * cf-bench.cxx
+ *
+ * Copyright (c) 2014 - Geoff R. McLane
+ * Licence: GNU GPL version 2
+ *
+\*/
+/*\
+ * Micro-benchmarks of the hot paths, run over a synthetic packet stream
+ * of position messages, with the full property tail of raw-log -t.
+ * BM_Decode_Property decodes that whole tail per iteration, so its
+ * items/s is properties decoded per second.
+ * Each benchmark is run for a doubling count of iterations until it
+ * takes at least the minimum time, like google benchmark, and reports
+ * ns per iteration, and items per second. --json gives the results
+ * in the google benchmark json layout, for comparing runs.
+\*/
+
+#include <stdio.h>
+#include <stdlib.h> // for atoi(), ...
+#include <string.h> // for strdup(), ...
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include "sprtf.hxx"
+#include "cf_misc.hxx"
+#include "cf_clock.hxx"
+#include "fg_geometry.hxx"
+#include "cf_euler.hxx"
+#include "cf_models.hxx"
+#include "mpMsgs.hxx"
+#include "tiny_xdr.hxx"
+#include "mp-props.hxx"
+#include "cf-log.hxx"
+#include "cf-pilot.hxx"
+
+static const char *module = "cf-bench";
+
+static const char *def_log = "tempcfbench.txt";
+
+// globals cf-pilot expects from cf-log
+int verbosity = 0;
+const char *raw_log = 0;
+double raw_bgn_secs = 0.0;
+double app_bgn_secs = 0.0;
+uint64_t raw_bytes_done = 0;
+bool time_decode = false;
+double decode_secs = 0.0;
+extern const char *json_file; // in cf-pilot.cxx
+
+static bool out_json = false;
+static const char *filter = 0;
+static double min_time = 0.5;   // seconds per benchmark
+static int num_pilots = 100;
+static int num_steps = 100;     // position updates per pilot
+
+#ifndef ISDIGIT
+#define ISDIGIT(a) ((a >= '0') && (a <= '9'))
+#endif
+#ifndef DEG2RAD
+#define DEG2RAD (M_PI / 180.0)
+#endif
+#define F2M 0.3048
+
+///////////////////////////////////////////////////////////////////////////
+// synthetic packet stream
+// fixed stride of MAX_PACKET_SIZE, in time order, all pilots per step
+// =======================================================================
+static std::vector<char> vPackets;
+static std::vector<int> vPktLens;
+static int pkt_count = 0;
+
+static const char *models[] = {
+    "Aircraft/c172p/Models/c172p.xml",
+    "Aircraft/777/Models/777-200.xml",
+    "Aircraft/A320/Models/A320.neo.xml",
+    "Aircraft/ufo/Models/ufo.ac"
+};
+#define NUM_MODELS (int)(sizeof(models) / sizeof(models[0]))
+
+typedef struct tagGENPILOT {
+    char callsign[MAX_CALLSIGN_LEN];
+    const char *model;
+    double lat, lon, alt_ft, hdg, spd_kt, t0;
+    bool park;
+}GENPILOT, *PGENPILOT;
+
+static double rand_range( double bgn, double end )
+{
+    return bgn + ((double)rand() / (double)RAND_MAX) * (end - bgn);
+}
+
+static void gen_packets( int pilots, int steps )
+{
+    char tmp[MAX_PACKET_SIZE];
+    int partcount[4];
+    std::vector<uint32_t> vIdsAdded;
+    std::vector<GENPILOT> vGen;
+    GENPILOT gp;
+    char cs[16];
+    double xyz[3];
+    double dist, ang;
+    int i, k, hz = 10;
+    size_t msgHdr = sizeof(T_MsgHdr);
+    size_t posMsg = sizeof(T_PositionMsg);
+
+    // the same property tail for every packet
+    memset(tmp,0,sizeof(tmp));
+    memset(partcount,0,sizeof(partcount));
+    unsigned int msgLen = Build_Prop_Packet( tmp, 2, false, vIdsAdded, partcount );
+
+    srand(1);
+    for (i = 0; i < pilots; i++) {
+        memset(&gp,0,sizeof(gp));
+        sprintf(cs,"BN%05d", i % 100000);
+        memcpy(gp.callsign, cs, MAX_CALLSIGN_LEN - 1);
+        gp.model = models[i % NUM_MODELS];
+        gp.lat = rand_range(-60.0, 60.0);
+        gp.lon = rand_range(-170.0, 170.0);
+        gp.alt_ft = rand_range(0.0, 10000.0);
+        gp.hdg = rand_range(0.0, 360.0);
+        gp.spd_kt = rand_range(0.0, 250.0);
+        gp.t0 = rand_range(100.0, 5000.0);
+        gp.park = ((i % 3) == 0);
+        vGen.push_back(gp);
+    }
+
+    pkt_count = pilots * steps;
+    vPackets.resize((size_t)pkt_count * MAX_PACKET_SIZE);
+    vPktLens.resize(pkt_count);
+    char *packet = &vPackets[0];
+    int n = 0;
+    for (k = 0; k < steps; k++) {
+        for (i = 0; i < pilots; i++) {
+            PGENPILOT pg = &vGen[i];
+            if (!pg->park) {
+                dist = pg->spd_kt * 0.5144 / hz;
+                pg->lat += dist * cos(pg->hdg * DEG2RAD) / 111000.0;
+                pg->lon += dist * sin(pg->hdg * DEG2RAD) /
+                    (111000.0 * fmax(0.1, cos(pg->lat * DEG2RAD)));
+                if ((k % 50) == 0)
+                    pg->hdg = fmod(pg->hdg + rand_range(-5.0, 5.0) + 360.0, 360.0);
+            }
+            sgGeodToCart(pg->lat * DEG2RAD, pg->lon * DEG2RAD, pg->alt_ft * F2M, xyz);
+            ang = pg->hdg * DEG2RAD;
+
+            memcpy(packet, tmp, msgLen);
+            PT_MsgHdr MsgHdr = (PT_MsgHdr)packet;
+            T_PositionMsg *PosMsg = (T_PositionMsg *)(packet + msgHdr);
+            memset(packet, 0, msgHdr + posMsg);
+            MsgHdr->Magic = XDR_encode_uint32(RELAY_MAGIC);
+            MsgHdr->Version = XDR_encode_uint32(PROTO_VER);
+            MsgHdr->MsgId = XDR_encode_uint32(POS_DATA_ID);
+            MsgHdr->MsgLen = XDR_encode_uint32(msgLen);
+            MsgHdr->ReplyAddress = XDR_encode_uint32(0x7f000001);
+            MsgHdr->ReplyPort = XDR_encode_uint32(5000);
+            memcpy(MsgHdr->Callsign, pg->callsign, MAX_CALLSIGN_LEN);
+            strncpy(PosMsg->Model, pg->model, MAX_MODEL_NAME_LEN - 1);
+            PosMsg->time = XDR_encode_double(pg->t0 + (double)k / hz);
+            PosMsg->lag = XDR_encode_double(0.1);
+            PosMsg->position[X] = XDR_encode_double(xyz[0]);
+            PosMsg->position[Y] = XDR_encode_double(xyz[1]);
+            PosMsg->position[Z] = XDR_encode_double(xyz[2]);
+            // crude angle-axis orientation
+            PosMsg->orientation[X] = XDR_encode_float((float)(0.1 * cos(ang)));
+            PosMsg->orientation[Y] = XDR_encode_float(0.2f);
+            PosMsg->orientation[Z] = XDR_encode_float((float)(2.0 * sin(ang / 2.0)));
+            PosMsg->linearVel[X] = XDR_encode_float(pg->park ? 0.0f : (float)(pg->spd_kt * 0.5144));
+            PosMsg->linearVel[Y] = XDR_encode_float(0.0f);
+            PosMsg->linearVel[Z] = XDR_encode_float(0.0f);
+            vPktLens[n++] = (int)msgLen;
+            packet += MAX_PACKET_SIZE;
+        }
+    }
+    SPRTF("%s: Generated %d packets, %d pilots, %d steps, each %d bytes, %d props.\n", module,
+        pkt_count, pilots, steps, (int)msgLen, (int)vIdsAdded.size());
+}
+
+#define PACKET(n) (&vPackets[(size_t)(n) * MAX_PACKET_SIZE])
+
+///////////////////////////////////////////////////////////////////////////
+// benchmark harness
+// =======================================================================
+typedef void (*BENCH_FN)( uint64_t iters );
+
+typedef struct tagBENCH {
+    const char *name;
+    BENCH_FN fn;
+    int items;          // items processed per iteration
+    uint64_t iters;     // results
+    double secs;
+}BENCH, *PBENCH;
+
+static volatile double bench_sink = 0.0; // keep results alive
+
+static void run_bench( PBENCH pb )
+{
+    uint64_t iters = 1;
+    double secs, mult;
+    for (;;) {
+        double bgn = clock_mono();
+        pb->fn(iters);
+        secs = clock_mono() - bgn;
+        if ((secs >= min_time) || (iters >= 1000000000ULL))
+            break;
+        // aim for 1.4 x min_time, but never more than 10 x per round
+        mult = (secs > 0.0) ? (min_time * 1.4 / secs) : 10.0;
+        if (mult > 10.0)
+            mult = 10.0;
+        if (mult < 2.0)
+            mult = 2.0;
+        iters = (uint64_t)(iters * mult);
+    }
+    pb->iters = iters;
+    pb->secs = secs;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// the benchmarks
+// =======================================================================
+static void BM_XDR_decode_uint32( uint64_t iters )
+{
+    uint32_t sum = 0;
+    for (uint64_t i = 0; i < iters; i++) {
+        PT_MsgHdr MsgHdr = (PT_MsgHdr)PACKET(i % pkt_count);
+        sum += XDR_decode<uint32_t> (MsgHdr->Magic);
+        sum += XDR_decode<uint32_t> (MsgHdr->MsgId);
+        sum += XDR_decode<uint32_t> (MsgHdr->MsgLen);
+        sum += XDR_decode<uint32_t> (MsgHdr->Version);
+    }
+    bench_sink += sum;
+}
+
+static void BM_XDR_decode64_double( uint64_t iters )
+{
+    double sum = 0.0;
+    for (uint64_t i = 0; i < iters; i++) {
+        T_PositionMsg *PosMsg = (T_PositionMsg *)(PACKET(i % pkt_count) + sizeof(T_MsgHdr));
+        sum += XDR_decode64<double> (PosMsg->position[X]);
+        sum += XDR_decode64<double> (PosMsg->position[Y]);
+        sum += XDR_decode64<double> (PosMsg->position[Z]);
+        sum += XDR_decode64<double> (PosMsg->time);
+    }
+    bench_sink += sum;
+}
+
+// all the numeric fields of the position message, in one pass
+static void BM_XDR_decode_position( uint64_t iters )
+{
+    T_PositionNative pn;
+    double sum = 0.0;
+    for (uint64_t i = 0; i < iters; i++) {
+        T_PositionMsg *PosMsg = (T_PositionMsg *)(PACKET(i % pkt_count) + sizeof(T_MsgHdr));
+        XDR_decode_position(PosMsg, &pn);
+        sum += pn.position[X] + pn.orientation[Z] + pn.angularAccel[Z];
+    }
+    bench_sink += sum;
+}
+
+static std::vector<Point3D> vCart;
+static std::vector<double> vEuler; // lat, lon, ox, oy, oz per packet
+
+static void prep_geometry()
+{
+    Point3D geod;
+    vCart.resize(pkt_count);
+    vEuler.resize((size_t)pkt_count * 5);
+    for (int n = 0; n < pkt_count; n++) {
+        T_PositionMsg *PosMsg = (T_PositionMsg *)(PACKET(n) + sizeof(T_MsgHdr));
+        vCart[n].Set( XDR_decode64<double> (PosMsg->position[X]),
+            XDR_decode64<double> (PosMsg->position[Y]),
+            XDR_decode64<double> (PosMsg->position[Z]) );
+        sgCartToGeod(vCart[n], geod);
+        double *pe = &vEuler[(size_t)n * 5];
+        pe[0] = geod.GetX();
+        pe[1] = geod.GetY();
+        pe[2] = XDR_decode<float> (PosMsg->orientation[X]);
+        pe[3] = XDR_decode<float> (PosMsg->orientation[Y]);
+        pe[4] = XDR_decode<float> (PosMsg->orientation[Z]);
+    }
+}
+
+static void BM_sgCartToGeod( uint64_t iters )
+{
+    Point3D geod;
+    double sum = 0.0;
+    for (uint64_t i = 0; i < iters; i++) {
+        sgCartToGeod(vCart[i % pkt_count], geod);
+        sum += geod.GetZ();
+    }
+    bench_sink += sum;
+}
+
+static void BM_euler_get( uint64_t iters )
+{
+    double hdg, pitch, roll, sum = 0.0;
+    for (uint64_t i = 0; i < iters; i++) {
+        double *pe = &vEuler[(size_t)(i % pkt_count) * 5];
+        euler_get( pe[0], pe[1], pe[2], pe[3], pe[4], &hdg, &pitch, &roll );
+        sum += hdg;
+    }
+    bench_sink += sum;
+}
+
+// raw Model path to id, as each position packet does
+static void BM_model_intern( uint64_t iters )
+{
+    int sum = 0;
+    for (uint64_t i = 0; i < iters; i++) {
+        T_PositionMsg *PosMsg = (T_PositionMsg *)(PACKET(i % pkt_count) + sizeof(T_MsgHdr));
+        sum += model_intern(PosMsg->Model, MAX_MODEL_NAME_LEN);
+    }
+    bench_sink += sum;
+}
+
+// clear the pilot list, with its summary to the log file only
+static void reset_pilots()
+{
+    int out = add_std_out(0);
+    clean_up_pilots(true);
+    add_std_out(out);
+}
+
+// the stream is replayed from the start, with a clean pilot list, each wrap
+static void BM_Deal_With_Packet( uint64_t iters )
+{
+    int n = 0;
+    reset_pilots();
+    for (uint64_t i = 0; i < iters; i++) {
+        if (n >= pkt_count) {
+            reset_pilots();
+            n = 0;
+        }
+        Deal_With_Packet( PACKET(n), vPktLens[n] );
+        n++;
+    }
+}
+
+// json for num_pilots active pilots, no file write
+static void prep_json()
+{
+    reset_pilots();
+    for (int n = 0; n < pkt_count; n++)
+        Deal_With_Packet( PACKET(n), vPktLens[n] );
+}
+
+static void BM_Write_JSON( uint64_t iters )
+{
+    for (uint64_t i = 0; i < iters; i++)
+        Write_JSON();
+}
+
+static void BM_Get_JSON( uint64_t iters )
+{
+    char *pbuf;
+    int sum = 0;
+    for (uint64_t i = 0; i < iters; i++)
+        sum += Get_JSON(&pbuf);
+    bench_sink += sum;
+}
+
+// every id in the table, plus as many misses
+static std::vector<unsigned> vPropIds;
+static std::vector<unsigned> vPropIds1;
+
+static void prep_props()
+{
+    unsigned i;
+    for (i = 0; i < numProperties; i++) {
+        vPropIds.push_back(sIdPropertyList[i].id);
+        vPropIds.push_back(sIdPropertyList[i].id + 100000);
+    }
+    for (i = 0; i < numProperties1; i++) {
+        vPropIds1.push_back(sIdPropertyList1[i].id);
+        vPropIds1.push_back(sIdPropertyList1[i].id + 100000);
+    }
+}
+
+static void BM_findProperty( uint64_t iters )
+{
+    size_t max = vPropIds.size();
+    int found = 0;
+    for (uint64_t i = 0; i < iters; i++) {
+        if (findProperty(vPropIds[i % max]))
+            found++;
+    }
+    bench_sink += found;
+}
+
+static void BM_findProperty1( uint64_t iters )
+{
+    size_t max = vPropIds1.size();
+    int found = 0;
+    for (uint64_t i = 0; i < iters; i++) {
+        if (findProperty1(vPropIds1[i % max]))
+            found++;
+    }
+    bench_sink += found;
+}
+
+// the full property tail of one packet per iteration
+static int props_per_packet = 0;
+
+static void prep_decode()
+{
+    MP_PROP_VAL pv;
+    char *packet = PACKET(0);
+    xdr_data_t *xdr = (xdr_data_t *)(packet + sizeof(T_MsgHdr) + sizeof(T_PositionMsg));
+    xdr_data_t *msgEnd = (xdr_data_t *)(packet + vPktLens[0]);
+    props_per_packet = 0;
+    while (xdr < msgEnd) {
+        xdr = Decode_Property(xdr, &pv);
+        props_per_packet++;
+    }
+}
+
+static void BM_Decode_Property( uint64_t iters )
+{
+    MP_PROP_VAL pv;
+    int sum = 0;
+    for (uint64_t i = 0; i < iters; i++) {
+        char *packet = PACKET(i % pkt_count);
+        xdr_data_t *xdr = (xdr_data_t *)(packet + sizeof(T_MsgHdr) + sizeof(T_PositionMsg));
+        xdr_data_t *msgEnd = (xdr_data_t *)(packet + vPktLens[i % pkt_count]);
+        while (xdr < msgEnd) {
+            xdr = Decode_Property(xdr, &pv);
+            sum += pv.ival;
+        }
+    }
+    bench_sink += sum;
+}
+
+static BENCH sBenchs[] = {
+    { "BM_XDR_decode_uint32", BM_XDR_decode_uint32, 4, 0, 0.0 },
+    { "BM_XDR_decode64_double", BM_XDR_decode64_double, 4, 0, 0.0 },
+    { "BM_XDR_decode_position", BM_XDR_decode_position, 20, 0, 0.0 },
+    { "BM_sgCartToGeod", BM_sgCartToGeod, 1, 0, 0.0 },
+    { "BM_euler_get", BM_euler_get, 1, 0, 0.0 },
+    { "BM_model_intern", BM_model_intern, 1, 0, 0.0 },
+    { "BM_Deal_With_Packet", BM_Deal_With_Packet, 1, 0, 0.0 },
+    { "BM_Write_JSON", BM_Write_JSON, 1, 0, 0.0 },
+    { "BM_Get_JSON", BM_Get_JSON, 1, 0, 0.0 },
+    { "BM_findProperty", BM_findProperty, 1, 0, 0.0 },
+    { "BM_findProperty1", BM_findProperty1, 1, 0, 0.0 },
+    { "BM_Decode_Property", BM_Decode_Property, 1, 0, 0.0 },
+    // last
+    { 0, 0, 0, 0, 0.0 }
+};
+
+///////////////////////////////////////////////////////////////////////////
+// output
+// =======================================================================
+static void show_results()
+{
+    PBENCH pb;
+    SPRTF("%-28s %14s %14s %14s\n", "Benchmark", "Time(ns)", "Iterations", "Items/s");
+    SPRTF("----------------------------------------------------------------------------\n");
+    for (pb = sBenchs; pb->name; pb++) {
+        if (!pb->iters)
+            continue;
+        double ns = pb->secs * 1e9 / (double)pb->iters;
+        double ips = (double)pb->iters * pb->items / pb->secs;
+        SPRTF("%-28s %14.2f %14llu %13.3fM\n", pb->name, ns,
+            (unsigned long long)pb->iters, ips / 1e6);
+    }
+}
+
+static void show_json()
+{
+    PBENCH pb;
+    char date[64];
+    time_t now = time(0);
+    bool first = true;
+    strftime(date,sizeof(date),"%Y-%m-%dT%H:%M:%S",localtime(&now));
+    printf("{\n");
+    printf("  \"context\": {\n");
+    printf("    \"date\": \"%s\",\n", date);
+    printf("    \"executable\": \"%s\",\n", module);
+    printf("    \"version\": \"%s\",\n", CF_LOG_VERSION);
+    printf("    \"pilots\": %d,\n", num_pilots);
+    printf("    \"packets\": %d,\n", pkt_count);
+    printf("    \"min_time\": %f\n", min_time);
+    printf("  },\n");
+    printf("  \"benchmarks\": [");
+    for (pb = sBenchs; pb->name; pb++) {
+        if (!pb->iters)
+            continue;
+        double ns = pb->secs * 1e9 / (double)pb->iters;
+        printf("%s\n    {\n", first ? "" : ",");
+        printf("      \"name\": \"%s\",\n", pb->name);
+        printf("      \"iterations\": %llu,\n", (unsigned long long)pb->iters);
+        printf("      \"real_time\": %f,\n", ns);
+        printf("      \"time_unit\": \"ns\",\n");
+        printf("      \"items_per_second\": %f\n", (double)pb->iters * pb->items / pb->secs);
+        printf("    }");
+        first = false;
+    }
+    printf("\n  ]\n}\n");
+}
+
+///////////////////////////////////////////////////////////////////////////
+void give_help( char *name )
+{
+    printf("\n");
+    printf("Usage: date " CF_LOG_DATE " version " CF_LOG_VERSION "\n");
+    printf(" %s [options]\n", module);
+    printf("\n");
+    printf("Options:\n");
+    printf(" --help     (-h or -?) = This help and exit(0)\n");
+    printf(" --verb[n]        (-v) = Bump or set verbosity to n. (def=%d)\n", verbosity);
+    printf(" --json           (-j) = Output results as json, to stdout. (def=table)\n");
+    printf(" --filter <stg>   (-f) = Only run benchmarks with this in the name. (def=all)\n");
+    printf(" --min-time <secs> (-m) = Minimum run time of each benchmark. (def=%g)\n", min_time);
+    printf(" --pilots <num>   (-p) = Pilots in the synthetic stream. (def=%d)\n", num_pilots);
+    printf(" --steps <num>    (-s) = Position updates per pilot. (def=%d)\n", num_steps);
+    printf("\n");
+    printf("Description:\n");
+    printf(" Run micro-benchmarks of packet decode, geometry, pilot update, json feed,\n");
+    printf(" and property lookup, over a synthetic position packet stream.\n");
+    printf("\n");
+}
+
+int parse_args( int argc, char **argv )
+{
+    int i,i2,c;
+    char *arg, *sarg;
+    for (i = 1; i < argc; i++) {
+        arg = argv[i];
+        i2 = i + 1;
+        if (*arg == '-') {
+            sarg = &arg[1];
+            while (*sarg == '-')
+                sarg++;
+            c = *sarg;
+            switch (c) {
+            case 'h':
+            case '?':
+                give_help(argv[0]);
+                return 2;
+            case 'v':
+                verbosity++;
+                sarg++;
+                while (*sarg) {
+                    if (ISDIGIT(*sarg)) {
+                        verbosity = atoi(sarg);
+                        break;
+                    }
+                    if (*sarg == 'v')
+                        verbosity++;
+                    sarg++;
+                }
+                break;
+            case 'j':
+                out_json = true;
+                break;
+            case 'f':
+            case 'm':
+            case 'p':
+            case 's':
+                if (i2 < argc) {
+                    i++;
+                    sarg = argv[i];
+                    if (c == 'f')
+                        filter = strdup(sarg);
+                    else if (c == 'm')
+                        min_time = atof(sarg);
+                    else if (c == 'p')
+                        num_pilots = atoi(sarg);
+                    else
+                        num_steps = atoi(sarg);
+                } else {
+                    SPRTF("%s: Expected value to follow '%s'!\n", module, arg);
+                    return 1;
+                }
+                break;
+            default:
+                SPRTF("%s: Unknown argument '%s'. Try -? for help...\n", module, arg);
+                return 1;
+            }
+        } else {
+            SPRTF("%s: Unknown argument '%s'. Try -? for help...\n", module, arg);
+            return 1;
+        }
+    }
+    if ((num_pilots < 1) || (num_steps < 1) || (min_time <= 0.0)) {
+        SPRTF("%s: Pilots, steps, and min time must all be greater than zero!\n", module);
+        return 1;
+    }
+    return 0;
+}
+
+// main() OS entry
+int main( int argc, char **argv )
+{
+    int iret;
+    PBENCH pb;
+    set_log_file((char *)def_log, false);
+    iret = parse_args(argc,argv);
+    if (iret) {
+        if (iret == 2)
+            iret = 0;
+        return iret;
+    }
+    if (out_json)
+        add_std_out(0); // keep stdout for the json
+    app_bgn_secs = get_seconds();
+    json_file = 0;  // build the feed, but no file writes
+    clock_tick();
+
+    gen_packets(num_pilots, num_steps);
+    prep_geometry();
+    prep_props();
+    prep_decode();
+    for (pb = sBenchs; pb->name; pb++) {
+        if (pb->fn == BM_Decode_Property)
+            pb->items = props_per_packet;
+    }
+    for (pb = sBenchs; pb->name; pb++) {
+        if (filter && !strstr(pb->name, filter))
+            continue;
+        if ((pb->fn == BM_Write_JSON) || (pb->fn == BM_Get_JSON)) {
+            prep_json();
+            Write_JSON();
+        }
+        if (VERB1)
+            SPRTF("%s: Running %s...\n", module, pb->name);
+        run_bench(pb);
+    }
+    reset_pilots();
+
+    if (out_json)
+        show_json();
+    else
+        show_results();
+    return 0;
+}
+
+// eof - cf-bench.cxx
@@ -27,6 +27,17 @@
 #include "cf_misc.hxx"
 #include "sprtf.hxx"
 #include "mpKeyboard.hxx"
+#include "cf_trace.hxx"
+#include "cf_tracker.hxx"
+#include "cf_tracks.hxx"
+#include "cf_rawframe.hxx"
+#include "cf_reclog.hxx"
+#ifdef USE_BLOCK_LOG
+#include "cf_blklog.hxx"
+#endif
+#include "cf_clock.hxx"
+#include "cf_pacer.hxx"
+#include "cf_metrics.hxx"
 #include "cf-pilot.hxx"
 #include "cf-server.hxx"
 #include "cf-log.hxx"
@@ -74,21 +85,45 @@ int check_keyboard()
     return 0;
 }
 
-// get first block of raw udp data
-#define MAX_RAW_LOG 2048
+// raw udp data, framed, and read ahead on a background thread
 static size_t raw_log_size, raw_log_remaining;
-static FILE *raw_log_fp = 0;
-static char *raw_log_buffer = 0;
-static size_t raw_block_size, raw_data_size;
+static PRAWFRAME raw_frame = 0;
+static char *raw_packet = 0;    // the current packet
+static int raw_len = 0;
 double raw_bgn_secs, app_bgn_secs;
+uint64_t raw_bytes_done = 0;    // bytes passed to Deal_With_Packet()
+bool time_decode = false;       // accumulate decode_secs - fast replay stats
+double decode_secs = 0.0;
+static PRECLOG rec_log = 0;     // the raw log is a compact recording
+#ifdef USE_BLOCK_LOG
+static PBLKLOG blk_log = 0;     // or a block compressed log
+#endif
+static bool rec_input = false;  // one of them is open
+static char *rec_packet = 0;    // its next packet
+static int rec_len = 0;
+double log_start_secs = 0.0;    // replay from this offset into the log
 void clean_up_log() 
 {
-    if (raw_log_fp)
-        fclose(raw_log_fp);
-    raw_log_fp = 0;
-    if (raw_log_buffer)
-        free(raw_log_buffer);
-    raw_log_buffer = 0;
+    if (rec_log)
+        reclog_close(rec_log);
+    rec_log = 0;
+#ifdef USE_BLOCK_LOG
+    if (blk_log) {
+        if (VERB1)
+            blklog_show_stats(blk_log);
+        blklog_close(blk_log);
+    }
+    blk_log = 0;
+#endif
+    rec_input = false;
+    rec_len = 0;
+    if (raw_frame) {
+        if (VERB1 || rawframe_has_damage(raw_frame))
+            rawframe_show_stats(raw_frame);
+        rawframe_close(raw_frame);
+    }
+    raw_frame = 0;
+    raw_len = 0;
 }
 
 /////////////////////////////////////////////////////////////////
@@ -99,8 +134,10 @@ void clean_up_log()
 // whihc 'decodes' the udp packet, and stores the 'live'
 // pilots into the vector vPilots.
 //
-// Then will read any remaining data from the file to re-fill
-// the buffer, and search for the 'next' udp packet.
+// Then will frame the 'next' udp packet, by its MsgLen, skipping, and
+// counting, any damage, see cf_rawframe.hxx, in the buffer the
+// read-ahead thread filled, so this only waits on i/o when decode is
+// faster than the disk.
 //
 // If fails to find 'next' udp packet will return 0 - sort of
 // like end of file.
@@ -119,64 +156,91 @@ void clean_up_log()
 //
 /////////////////////////////////////////////////////////////////
 
-int get_next_block()
+// each decode is timed into a histogram, for the /metrics scrape
+static int met_decode = -1;
+
+static void deal_with_block( char *cp, size_t len )
 {
-    int key = 0;
     Packet_Type pt;
-    size_t i, j, size = raw_data_size;  // MAX_RAW_LOG;
-    char *cp = raw_log_buffer;
-    if (cp && raw_block_size) {
-        pt = Deal_With_Packet( cp, raw_block_size );
-        packet_cnt++;
-        if (pt < pkt_Max) sPktStr[pt].count++;  // set the packet stats
-        j = 0;
-        for (i = raw_block_size; i < size; i++) {
-            cp[j++] = cp[i];
-        }
-        raw_log_remaining -= raw_block_size;    // reduce remaining in raw log
-        raw_data_size = raw_data_size - raw_block_size;  // set size of remaining raw data after this packet
-        if (raw_log_fp) {
-            size = raw_block_size;  // size to read at end of buffer
-            if (raw_log_remaining < size) {
-                size = raw_log_remaining;
-            }
-            // load more dat at offset of used bloc size, potentially fill buffer
-            size_t rd = fread( &cp[raw_data_size], 1, size, raw_log_fp );
-            raw_block_size = 0;
-            if (rd == size) {
-                raw_data_size += size;  // bump by this read
-                i = 0;
-                // this has to be true - just a debug check
-                if ( !((cp[i+0] == 'S') && (cp[i+1] == 'F') &&
-                      (cp[i+2] == 'G') && (cp[i+3] == 'F')) ) {
-                    goto Bad_Read;
-                }
-                for (i = 4; i < raw_data_size; i++) {
-                    if ((cp[i+0] == 'S') && (cp[i+1] == 'F') &&
-                        (cp[i+2] == 'G') && (cp[i+3] == 'F')) {
-                        break;
-                    }
-                }
-                raw_block_size = i; // either found next, or out of data, 
-                key = 1;    // but have next block
-            } else {
-Bad_Read:
-                fclose(raw_log_fp);
-                raw_log_fp = 0;
-                free(raw_log_buffer);
-                raw_log_buffer = 0;
-                SPRTF("%s: Failed to get the next raw block!\n", module );
-            }
-        }
+    uint64_t t1 = clock_mono_nsecs();
+    pkt_ingest_ns = t1;
+    pt = Deal_With_Packet( cp, len );
+    uint64_t ns = clock_mono_nsecs() - t1;
+    met_hist_add( met_decode, ns );
+    if (time_decode)
+        decode_secs += (double)ns / 1e9;
+    raw_bytes_done += len;
+    packet_cnt++;
+    if (pt < pkt_Max) sPktStr[pt].count++;  // set the packet stats
+}
+
+static int read_rec_packet( uint64_t *parrival )
+{
+#ifdef USE_BLOCK_LOG
+    if (blk_log)
+        return blklog_read( blk_log, &rec_packet, parrival );
+#endif
+    return reclog_read( rec_log, &rec_packet, parrival );
+}
+
+// get_next_block() of a compact recording, or block compressed log -
+// packets are length prefixed, or indexed, so there is no scan for the
+// next magic
+static int get_next_rec()
+{
+    if (!rec_len)
+        return 0;
+    deal_with_block( rec_packet, rec_len );
+    rec_len = read_rec_packet( 0 );
+    if (rec_len <= 0) {
+        if (rec_len < 0)
+            SPRTF("%s: Failed to get the next recorded packet!\n", module );
+        clean_up_log();
+        return 0;
     }
-    return key;
+    return 1;
+}
+
+int get_next_block()
+{
+    if (rec_input)
+        return get_next_rec();
+    if (!raw_len)
+        return 0;
+    deal_with_block( raw_packet, raw_len );
+    raw_log_remaining -= raw_len;   // reduce remaining in raw log
+    raw_len = rawframe_next( raw_frame, &raw_packet );
+    if (raw_len <= 0) {
+        if (raw_len < 0)
+            SPRTF("%s: Failed to get the next raw block!\n", module );
+        raw_len = 0;
+        return 0;
+    }
+    return 1;   // have next block
+}
+
+/////////////////////////////////////////////////////////////////
+// bool get_next_elapsed( double *pelapsed )
+//
+// Peek at the elapsed sim time of the block the next
+// get_next_block() will process, to pace it. False if not known.
+/////////////////////////////////////////////////////////////////
+bool get_next_elapsed( double *pelapsed )
+{
+    if (rec_input && rec_len)
+        return Get_Packet_Elapsed( rec_packet, rec_len, pelapsed );
+    if (raw_len)
+        return Get_Packet_Elapsed( raw_packet, raw_len, pelapsed );
+    return false;
 }
 
 /////////////////////////////////////////////////////////////////
 // int open_raw_log()
 // 
-// Open the raw log 'rb', allocate a read buffer, and
-// search for the first udp block.
+// Open the raw log, start its read-ahead, and frame the first
+// udp block. A compact recording, see
+// cf_reclog.hxx, or block compressed log, see cf_blklog.hxx, is
+// opened and its first packet, at log_start_secs, read instead.
 //
 // If successful return 0, else 1 is an error
 //
@@ -185,82 +249,83 @@ Bad_Read:
 //
 ////////////////////////////////////////////////////////////////
 
+static int open_rec_log( const char *tf, bool is_blk, size_t size )
+{
+    uint64_t first = 0, arrival;
+    uint64_t start = (uint64_t)(log_start_secs * 1000000.0);
+#ifdef USE_BLOCK_LOG
+    if (is_blk) {
+        blk_log = blklog_open(tf);
+        if (!blk_log)
+            return 1;
+        if (start && blklog_seek(blk_log, log_start_secs)) {
+            SPRTF("%s: Failed to seek to %.1f secs in '%s'!\n", module, log_start_secs, tf);
+            clean_up_log();
+            return 1;
+        }
+        start = 0;  // done by the index
+    } else
+#endif
+    {
+        rec_log = reclog_open(tf);
+        if (!rec_log)
+            return 1;
+    }
+    rec_input = true;
+    rec_len = read_rec_packet(&first);
+    arrival = first;    // the offset is relative, whatever the time base
+    // a recording has no index, so read up to the offset
+    while ((rec_len > 0) && start && (arrival - first < start))
+        rec_len = read_rec_packet(&arrival);
+    if (rec_len <= 0) {
+        SPRTF("%s: Failed to read the first packet of '%s'!\n", module, tf);
+        clean_up_log();
+        return 1;
+    }
+    if (log_start_secs > 0.0)
+        SPRTF("%s: Replay from %.1f secs into '%s'\n", module, log_start_secs, tf);
+    raw_log_size = size;
+    raw_log_remaining = size;
+    raw_bgn_secs = get_seconds();   // start of raw log reading
+    return 0;
+}
+
 int open_raw_log()
 {
     const char *tf = raw_log;
+    if (met_decode < 0)
+        met_decode = met_hist_new("cf_decode_seconds", 0, "Time to decode a packet, and update its pilot.");
+    init_pilot_metrics();
     if (stat(tf,&sbuf)) {
         SPRTF("%s: Failed to stat '%s'!\n", module, tf);
         return 1;
     }
     size_t size = sbuf.st_size;
-    if (size <= MAX_RAW_LOG) {
-        SPRTF("%s: Files '%s' too small! Only %u bytes!\n", module, tf, (int)size);
+#ifdef USE_BLOCK_LOG
+    if (blklog_is_blk(tf))
+        return open_rec_log(tf, true, size);
+#endif
+    if (reclog_is_rec(tf))
+        return open_rec_log(tf, false, size);
+    if (log_start_secs > 0.0)
+        SPRTF("%s: A raw log has no times, --at ignored\n", module);
+    if (!size) {
+        SPRTF("%s: Files '%s' has no size!\n", module, tf);
         return 1;
-
     }
     raw_log_size = size;
     raw_log_remaining = size;
-    if (size > MAX_RAW_LOG) {
-        size = MAX_RAW_LOG;
-    }
-    char *cp = (char *) malloc( size );
-    if (!cp) {
-        SPRTF("%s: memory allocation FAILED\n", module);
+    raw_frame = rawframe_open(tf, VERB2 ? 100 : 0);
+    if (!raw_frame)
         return 1;
-    }
-    FILE *fp = fopen( tf, "rb" );
-    if (!fp) {
-        SPRTF("%s: Failed to open '%s'!\n", module, tf);
-        free(cp);
+    raw_len = rawframe_next(raw_frame, &raw_packet);
+    if (raw_len <= 0) {
+        SPRTF("%s: Failed find fisrt udp packet in '%s'!\n", module, tf);
+        clean_up_log();
         return 1;
     }
-    size_t rd = fread(cp,1,size,fp);
-    if (rd != size) {
-        SPRTF("%s: Failed read of '%s'! Req %u, got %u?\n", module, tf, (int)size, (int)rd);
-        fclose(fp);
-        free(cp);
-        return 1;
-    }
-
-    size_t i, j, bgn;
-    for (i = 0; i < size; i++) {
-        if ((cp[i+0] == 'S') && (cp[i+1] == 'F') &&
-            (cp[i+2] == 'G') && (cp[i+3] == 'F')) {
-            if (i) {
-                // UGH, not at head - move ALL data up to head
-                bgn = i;
-                j = 0;
-                for ( ; i < size; i++) {
-                    cp[j++] = cp[i];
-                }
-                rd = fread(&cp[j],1,bgn,fp);    // top up the buffer from the file
-                if (rd != bgn) {
-                    SPRTF("%s: Failed read of '%s'! Req %u, got %u?\n", module, tf, (int)bgn, (int)rd);
-                    fclose(fp);
-                    free(cp);
-                    return 1;
-                }
-            }
-            // search for next
-            for (i = 4; i < size; i++) {
-                if ((cp[i+0] == 'S') && (cp[i+1] == 'F') &&
-                    (cp[i+2] == 'G') && (cp[i+3] == 'F')) {
-                    // end of first block
-                    raw_log_fp = fp;
-                    raw_log_buffer = cp;
-                    raw_block_size = i;
-                    raw_data_size = size;
-                    raw_bgn_secs = get_seconds();   // start of raw log reading
-                    return 0;
-                }
-            }
-        }
-    }
-    free(cp);
-    if (fp)
-        fclose(fp);
-    SPRTF("%s: Failed find fisrt udp packet in '%s'!\n", module, tf);
-    return 1;
+    raw_bgn_secs = get_seconds();   // start of raw log reading
+    return 0;
 }
 
 int open_raw_log_whole()
@@ -271,9 +336,10 @@ int open_raw_log_whole()
     size_t i, bgn;
     bgn = 0;
     Packet_Type pt;
-    double bgn_secs = get_seconds();
+    double pace_sim = elapsed_sim_time;
     pilot_ttl = m_PlayerExpires;
-    curr = last_expire = time(0);
+    clock_tick();
+    curr = last_expire = clock_now();
     last_json = 0;
     size_t rd = 0;
     
@@ -311,13 +377,12 @@ int open_raw_log_whole()
         if ((cp[i+0] == 'S') && (cp[i+1] == 'F') &&
             (cp[i+2] == 'G') && (cp[i+3] == 'F')) {
             if (packet_cnt) {
-                if (use_sim_time && got_sim_time) {
-                    double secs = get_seconds() - bgn_secs;
-                    while ((secs < elapsed_sim_time)&&(key == 0)) {
-                        SLEEP(DEF_MS);
+                if (use_sim_time) {
+                    double elap;
+                    if (Get_Packet_Elapsed( &cp[bgn], (int)(i - bgn), &elap ) && (elap > pace_sim))
+                        pace_sim = elap;
+                    while (!pacer_wait(pace_sim, DEF_MS) && (key == 0))
                         key = check_keyboard();
-                        secs = get_seconds() - bgn_secs;
-                    }
                 }
                 if (key) break;
                 SPRTF("%s: Packet %d is length %u\n", module, (int)packet_cnt, (int)(i - bgn));
@@ -326,7 +391,8 @@ int open_raw_log_whole()
             }
             bgn = i;
             packet_cnt++;
-            curr = time(0);
+            clock_tick();
+            curr = clock_now();
             key = check_keyboard();
             if (key)
                 break;
@@ -361,6 +427,7 @@ exit:
 }
 
 
+// see cf-split for cutting a log by time, callsign, id, area, or model
 int split_raw_log_whole( char *new_log, size_t count, size_t begin )
 {
     int key = 0;
@@ -502,6 +569,9 @@ int main( int argc, char **argv )
     int iret = server_main( argc, argv );
     clean_up_log();
     clean_up_pilots();
+    trace_close();
+    tracker_close();
+    tracks_close();
     SPRTF("%s: Ran for %s, exit(%d)\n", module, get_seconds_stg( get_seconds() - app_bgn_secs ), iret);
     return iret;
 }
@@ -8,6 +8,7 @@
 
 #ifndef _CF_LOG_HXX_
 #define _CF_LOG_HXX_
+#include <stdint.h>
 
 extern int verbosity;
 
@@ -18,7 +19,12 @@ extern int verbosity;
 
 extern const char *raw_log;
 extern double raw_bgn_secs, app_bgn_secs;
+extern uint64_t raw_bytes_done;
+extern bool time_decode;
+extern double decode_secs;
+extern double log_start_secs;
 extern int get_next_block();
+extern bool get_next_elapsed( double *pelapsed );
 extern int open_raw_log();
 extern void clean_up_log(); 
 
@@ -0,0 +1,162 @@
+/*\
+ * cf-pgtest.cxx
+ *
+ * Copyright (c) 2014 - Geoff R. McLane
+ * Licence: GNU GPL version 2
+ *
+\*/
+/*\
+ * Round trip of the PostgreSQL flight tracker - write one batch of
+ * flights and positions through tracker_add(), the pipelined inserts,
+ * and the binary COPY, then read back the row counts, and sums of the
+ * values, and delete the rows again.
+ * Opt-in - needs a server, so it only runs if CF_PG_CONNINFO is set to
+ * a libpq connection string, like "host=127.0.0.1 dbname=crossfeed",
+ * else it returns 77, which ctest shows as skipped.
+\*/
+
+#include <stdio.h>
+#include <stdlib.h> // for getenv(), ...
+#include <string.h>
+#include <math.h>
+#include <string>
+#include "sprtf.hxx"
+#include "cf_misc.hxx"
+#include "cf_tracker.hxx"
+#include "cf_postgres.hxx"
+
+static const char *module = "cf-pgtest";
+
+static const char *def_log = "tempcfpgtest.txt";
+static const char *env_conninfo = "CF_PG_CONNINFO";
+
+#define PGT_SKIP        77  // ctest SKIP_RETURN_CODE
+#define PGT_FLIGHTS     3
+#define PGT_POSITIONS   1000    // per flight, so the COPY buffer fills more than once
+
+typedef struct tagPGT_SUMS {
+    long long flights, positions, alt, hdg;
+    double lat;
+}PGT_SUMS, *PPGT_SUMS;
+
+static int sum_cb( void *vp, int cols, char **argv, char **names )
+{
+    double *pd = (double *)vp;
+    int i;
+    for (i = 0; i < cols; i++)
+        pd[i] = argv[i] ? atof(argv[i]) : 0.0;
+    return 0;
+}
+
+static void set_pos( PTRACK_REC pr, uint64_t fid, int64_t epoch, int i )
+{
+    memset(pr, 0, sizeof(TRACK_REC));
+    pr->flight_id = fid;
+    pr->epoch = epoch + i;
+    pr->lat = -37.5 + (i * 0.001);
+    pr->lon = 145.25 - (i * 0.001);
+    pr->alt = (float)(1000 + i);
+    pr->speed = 120.0f;
+    pr->heading = (uint16_t)(i % 360);
+    pr->event = tkv_Position;
+}
+
+// write the batch, and what the table sums should be
+static int write_batch( const char *conninfo, uint64_t base, int64_t epoch, PPGT_SUMS ps )
+{
+    std::string spec("pg:");
+    TRACK_REC rec;
+    int f, i;
+    spec += conninfo;
+    if (tracker_open(spec.c_str())) {
+        SPRTF("%s: Failed to open the tracker with '%s'!\n", module, conninfo);
+        return 1;
+    }
+    memset(ps, 0, sizeof(PGT_SUMS));
+    for (f = 0; f < PGT_FLIGHTS; f++) {
+        set_pos(&rec, base + f, epoch, 0);
+        rec.event = tkv_Connect;
+        sprintf(rec.callsign, "PGT%03d", f);
+        strcpy(rec.model, "c172p");
+        tracker_add(&rec);
+        ps->flights++;
+        for (i = 0; i < PGT_POSITIONS; i++) {
+            set_pos(&rec, base + f, epoch, i);
+            tracker_add(&rec);
+            ps->positions++;
+            ps->alt += (long long)(rec.alt + 0.5f);
+            ps->hdg += rec.heading;
+            ps->lat += rec.lat;
+        }
+        set_pos(&rec, base + f, epoch, PGT_POSITIONS);
+        rec.event = tkv_Disconnect;
+        tracker_add(&rec);
+    }
+    tracker_close();    // writes all queued
+    return 0;
+}
+
+// read back, compare, and delete the test rows
+static int check_batch( const char *conninfo, uint64_t base, PPGT_SUMS ps )
+{
+    cf_postgres pg;
+    char range[128], sql[256];
+    double flights[1], pos[4];
+    int iret = 0;
+    pg.set_conninfo(conninfo);
+    if (pg.db_open()) {
+        SPRTF("%s: Failed to connect with '%s'!\n", module, conninfo);
+        return 1;
+    }
+    sprintf(range, "fid BETWEEN %lld AND %lld", (long long)base, (long long)(base + PGT_FLIGHTS - 1));
+    flights[0] = 0.0;
+    sprintf(sql, "SELECT count(*) FROM flights WHERE %s AND status='CLOSED';", range);
+    iret |= pg.db_exec(sql, sum_cb, flights);
+    memset(pos, 0, sizeof(pos));
+    sprintf(sql, "SELECT count(*), sum(alt_ft), sum(hdg), sum(lat) FROM positions WHERE %s;", range);
+    iret |= pg.db_exec(sql, sum_cb, pos);
+    if (iret) {
+        SPRTF("%s: Failed to read back the rows!\n", module);
+    } else if (((long long)flights[0] != ps->flights) || ((long long)pos[0] != ps->positions) ||
+        ((long long)pos[1] != ps->alt) || ((long long)pos[2] != ps->hdg) ||
+        (fabs(pos[3] - ps->lat) > 1e-6)) {
+        SPRTF("%s: FAILED: flights %lld, positions %lld, alt %lld, hdg %lld, lat %f\n", module,
+            (long long)flights[0], (long long)pos[0], (long long)pos[1], (long long)pos[2], pos[3]);
+        SPRTF("%s: expected flights %lld, positions %lld, alt %lld, hdg %lld, lat %f\n", module,
+            ps->flights, ps->positions, ps->alt, ps->hdg, ps->lat);
+        iret = 1;
+    } else {
+        SPRTF("%s: Read back %lld closed flights, %lld positions, all as written\n", module,
+            ps->flights, ps->positions);
+    }
+    sprintf(sql, "DELETE FROM positions WHERE %s;", range);
+    pg.db_exec(sql);
+    sprintf(sql, "DELETE FROM flights WHERE %s;", range);
+    pg.db_exec(sql);
+    pg.db_close();
+    return iret;
+}
+
+// main() OS entry
+int main( int argc, char **argv )
+{
+    int iret;
+    PGT_SUMS sums;
+    set_log_file((char *)def_log, false);
+    const char *conninfo = getenv(env_conninfo);
+    if (!conninfo || !*conninfo) {
+        SPRTF("%s: %s not set, so skipped. Set it to a libpq connection string to run.\n", module,
+            env_conninfo);
+        return PGT_SKIP;
+    }
+    // fids that no real flight has - real ones are epoch secs * 1000 plus a count
+    uint64_t base = get_epoch_usecs() * 10;
+    int64_t epoch = (int64_t)(base / 10000000);
+    iret = write_batch(conninfo, base, epoch, &sums);
+    if (!iret)
+        iret = check_batch(conninfo, base, &sums);
+    SPRTF("%s: %s\n", module, iret ? "FAILED" : "passed");
+    return iret;
+}
+
+// eof - cf-pgtest.cxx
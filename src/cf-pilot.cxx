@@ -13,6 +13,7 @@
 #include <string.h> // for strcpy(), ...
 #include <stdlib.h> // for abs(), ...
 #endif // !_MSC_VER
+#include <math.h> // for sqrt(), ...
 #ifdef USE_SIMGEAR
 // so use SGMath.hxx
 #include <simgear/compiler.h>
@@ -29,6 +30,12 @@
 #include "sprtf.hxx"
 #include "cf_misc.hxx"
 #include "mpMsgs.hxx"
+#include "cf_trace.hxx"
+#include "cf_clock.hxx"
+#include "cf_metrics.hxx"
+#include "cf_models.hxx"
+#include "cf_tracker.hxx"
+#include "cf_tracks.hxx"
 #ifdef USE_SIMGEAR
 #include "xdr_lib/tiny_xdr.hxx"
 #else
@@ -45,14 +52,59 @@ static size_t pos_cnt = 0;
 static size_t chat_cnt = 0;
 static size_t failed_cnt = 0;
 static size_t discard_cnt = 0;
+static size_t early_cnt = 0;    // discards decided before the geodetic and Euler work
 size_t packet_cnt = 0;
 double elapsed_sim_time = 0.0;
 bool got_sim_time = false;
 
+uint64_t pkt_ingest_ns = 0;
+
+// feed build times, and the latency of each stage from a packet's
+// ingest to it being in a sent json feed, for the /metrics scrape
+enum Stage_Type {
+    st_Decode,      // ingest to the packet decoded
+    st_Update,      // decoded to its pilot updated
+    st_Publish,     // updated to in a json feed
+    st_Send,        // json feed built to sent, per send
+    st_Visible,     // ingest to the first send of a json feed with it
+    st_Max
+};
+static const char *stage_stg[st_Max] = {
+    "stage=\"decode\"",
+    "stage=\"update\"",
+    "stage=\"publish\"",
+    "stage=\"send\"",
+    "stage=\"visible\""
+};
+static int met_stage[st_Max] = { -1, -1, -1, -1, -1 };
+static int met_json_build = -1;
+static int met_xml_build = -1;
+static uint64_t json_publish_ns = 0;
+static bool json_feed_served = false;   // the current json feed has been sent
+void init_pilot_metrics()
+{
+    static bool done = false;
+    int i;
+    if (done)
+        return;
+    done = true;
+    for (i = 0; i < st_Max; i++)
+        met_stage[i] = met_hist_new("cf_stage_seconds", stage_stg[i], "Latency of each stage, from packet ingest to a sent json feed.");
+    met_json_build = met_hist_new("cf_feed_build_seconds", "feed=\"json\"", "Time to build a feed snapshot.");
+    met_xml_build = met_hist_new("cf_feed_build_seconds", "feed=\"xml\"", "Time to build a feed snapshot.");
+}
+
+void Get_Discard_Counts( size_t *pearly, size_t *pcompare, size_t *pfailed )
+{
+    *pearly = early_cnt;
+    *pcompare = discard_cnt - early_cnt;
+    *pfailed = failed_cnt;
+}
+
 void show_packets()
 {
-    SPRTF("%s: Packets %d, pos %d, discard %d, failed %d, chat %d.\n", module,
-        (int)packet_cnt, (int)pos_cnt, (int)discard_cnt, (int)failed_cnt, (int)chat_cnt);
+    SPRTF("%s: Packets %d, pos %d, discard %d (early %d), failed %d, chat %d.\n", module,
+        (int)packet_cnt, (int)pos_cnt, (int)discard_cnt, (int)early_cnt, (int)failed_cnt, (int)chat_cnt);
     if (VERB1) {
         double elap = get_seconds() - app_bgn_secs;
         if (elap > 0.0) {
@@ -101,8 +153,9 @@ typedef struct tagCF_Pilot {
     bool            expired;
     time_t          curr_time, prev_time, first_time;    // rough seconds
     double          sim_time, prev_sim_time, first_sim_time; // sim time from packet
+    double          sim_offset;  // elapsed_sim_time when first_sim_time was set
     char            callsign[MAX_CALLSIGN_LEN];
-    char            aircraft[MAX_MODEL_NAME_LEN];
+    int             model_id;   // interned aircraft model, see cf_models.hxx
     double          lat, lon;    // degrees
     double          alt;         // feet
     float           ox, oy, oz;
@@ -123,6 +176,11 @@ typedef struct tagCF_Pilot {
     double          total_nm, cumm_nm;   // total distance since start
     time_t          exp_time;    // time expired - epoch secs
     time_t          last_seen;  // last packet seen - epoch secs
+    // stage latency, monotonic nano-seconds, see Write_JSON()
+    uint64_t        ingest_ns, update_ns;   // of the last update
+    uint64_t        pub_ingest_ns;  // of the update in the last json feed
+    bool            pub_pending;    // updated since the last json feed
+    bool            pub_served;     // the last json feed has been sent
 }CF_Pilot, *PCF_Pilot;
 
 typedef std::vector<CF_Pilot> vCFP;
@@ -142,6 +200,68 @@ static int m_ExpiredCnt = 0;    // total of expired in vector
 static int m_MaxExpired = 100;
 #define ADD_VECTOR_ERASE
 
+// stamp the pilot update of a packet, ingested and decoded at these times
+static void stage_update( PCF_Pilot pp, uint64_t ingest, uint64_t decoded )
+{
+    if (!ingest)
+        return;
+    pp->ingest_ns = ingest;
+    pp->update_ns = clock_mono_nsecs();
+    pp->pub_pending = true;
+    met_hist_add(met_stage[st_Decode], decoded - ingest);
+    met_hist_add(met_stage[st_Update], pp->update_ns - decoded);
+}
+
+// the json feed was just built, so its pilot updates are published
+static void stage_publish()
+{
+    size_t ii, max = vPilots.size();
+    PCF_Pilot pp;
+    json_publish_ns = clock_mono_nsecs();
+    json_feed_served = false;
+    for (ii = 0; ii < max; ii++) {
+        pp = &vPilots[ii];
+        if (pp->expired || !pp->pub_pending)
+            continue;
+        met_hist_add(met_stage[st_Publish], json_publish_ns - pp->update_ns);
+        pp->pub_ingest_ns = pp->ingest_ns;
+        pp->pub_pending = false;
+        pp->pub_served = false;
+    }
+}
+
+void Stage_JSON_Sent()
+{
+    size_t ii, max = vPilots.size();
+    PCF_Pilot pp;
+    uint64_t now = clock_mono_nsecs();
+    if (!json_publish_ns)
+        return;
+    met_hist_add(met_stage[st_Send], now - json_publish_ns);
+    if (json_feed_served)
+        return;     // only its first send makes its updates visible
+    json_feed_served = true;
+    for (ii = 0; ii < max; ii++) {
+        pp = &vPilots[ii];
+        if (pp->pub_served || !pp->pub_ingest_ns)
+            continue;
+        met_hist_add(met_stage[st_Visible], now - pp->pub_ingest_ns);
+        pp->pub_served = true;
+    }
+}
+
+void Get_Pilot_Counts( int *plive, int *pexpired )
+{
+    size_t ii, max = vPilots.size();
+    int exp = 0;
+    for (ii = 0; ii < max; ii++) {
+        if (vPilots[ii].expired)
+            exp++;
+    }
+    *plive = (int)max - exp;
+    *pexpired = exp;
+}
+
 void clean_up_pilots( bool clear )
 {
     size_t exp, ii, max = vPilots.size();
@@ -160,40 +280,11 @@ void clean_up_pilots( bool clear )
     }
     if (clear) {
         vPilots.clear();
+        model_clear();  // no pilot holds a model id now
     }
 
 }
 
-//////////////////////////////////////////////////////////////////////
-// Rather rough service to remove leading PATH
-// and remove trailing file extension
-char *get_Model( char *pm )
-{
-    static char _s_buf[MAX_MODEL_NAME_LEN+4];
-    int i, c, len;
-    char *cp = _s_buf;
-    char *model = pm;
-    len = MAX_MODEL_NAME_LEN;
-    for (i = 0; i < len; i++) {
-        c = pm[i];
-        if (c == '/')
-            model = &pm[i+1];
-        else if (c == 0)
-            break;
-    }
-    strcpy(cp,model);
-    len = (int)strlen(cp);
-    model = 0;
-    for (i = 0; i < len; i++) {
-        c = cp[i];
-        if (c == '.')
-            model = &cp[i];
-    }
-    if (model)
-        *model = 0;
-    return cp;
-}
-
 ///////////////////////////////////////////////////////////////////////////
 // Essentially just a DEBUG service
 #define ADD_ORIENTATION
@@ -215,7 +306,7 @@ void print_pilot(PCF_Pilot pp, char *pm, Pilot_Type pt)
     sprintf(cp,"%s %s at %f,%f,%d, orien %f,%f,%f, in %s hdg=%d spd=%d pkts=%d/%d ", pm, pp->callsign,
         dlat, dlon, ialt,
         pp->ox, pp->oy, pp->oz,
-        pp->aircraft, 
+        model_name(pp->model_id), 
         (int)(pp->heading + 0.5),
         (int)(pp->speed + 0.5),
         pp->packetCount, pp->packetsDiscarded );
@@ -223,7 +314,7 @@ void print_pilot(PCF_Pilot pp, char *pm, Pilot_Type pt)
 #else
     sprintf(cp,"%s %s at %f,%f,%d, %s pkts=%d/%d hdg=%d spd=%d ", pm, pp->callsign,
         dlat, dlon, ialt,
-        pp->aircraft, 
+        model_name(pp->model_id), 
         pp->packetCount, pp->packetsDiscarded,
         (int)(pp->heading + 0.5),
         (int)(pp->speed + 0.5) );
@@ -244,6 +335,68 @@ void print_pilot(PCF_Pilot pp, char *pm, Pilot_Type pt)
     SPRTF(cp);
 }
 
+///////////////////////////////////////////////////////////////////////////
+// Add the pilot event to the binary journal, if one is open
+// This is a fixed record, so no text formatting on the packet path
+static void trace_pilot(PCF_Pilot pp, Trace_Event ev, Trace_Reason reason, int value)
+{
+    CF_TRACE_REC rec;
+    if (!trace_on)
+        return;
+    rec.epoch_usecs = clock_now_usecs();  // cached, virtual in a fast replay
+    rec.sim_time    = pp->sim_time;
+    rec.flight_id   = pp->flight_id;
+    memcpy(rec.callsign,pp->callsign,CF_TRACE_CS_LEN);
+    rec.lat         = pp->lat;
+    rec.lon         = pp->lon;
+    rec.alt         = (float)pp->alt;
+    rec.speed       = (float)pp->speed;
+    rec.value       = value;
+    rec.event       = (uint8_t)ev;
+    rec.reason      = (uint8_t)reason;
+    rec.heading     = (uint16_t)(int)(pp->heading + 0.5);
+    trace_add(&rec);
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Add the flight event to the track store, if kept, and queue it for
+// the tracker database, if recording
+static void track_pilot(PCF_Pilot pp, Track_Event ev)
+{
+    TRACK_REC rec;
+    if (tracks_on) {
+        if (ev == tkv_Disconnect)
+            tracks_end(pp->flight_id);
+        else
+            tracks_add(pp->flight_id, pp->callsign, pp->curr_time, pp->sim_time,
+                pp->lat, pp->lon, pp->alt, pp->speed, pp->heading);
+    }
+    if (!tracker_on)
+        return;
+    rec.flight_id = pp->flight_id;
+    rec.epoch     = (int64_t)((ev == tkv_Disconnect) ? pp->exp_time : pp->curr_time);
+    rec.lat       = pp->lat;
+    rec.lon       = pp->lon;
+    rec.alt       = (float)pp->alt;
+    rec.speed     = (float)pp->speed;
+    rec.heading   = (uint16_t)(int)(pp->heading + 0.5);
+    rec.event     = (uint8_t)ev;
+    if (ev == tkv_Connect) {
+        strncpy(rec.callsign, pp->callsign, TRACK_CS_LEN);
+        rec.callsign[TRACK_CS_LEN] = 0;
+        strncpy(rec.model, model_name(pp->model_id), TRACK_MODEL_LEN - 1);
+        rec.model[TRACK_MODEL_LEN - 1] = 0;
+    } else {
+        rec.callsign[0] = 0;
+        rec.model[0] = 0;
+    }
+    tracker_add(&rec);
+}
+
+#define Pilot_Tracker_Connect(pp)    track_pilot(pp, tkv_Connect)
+#define Pilot_Tracker_Position(pp)   track_pilot(pp, tkv_Position)
+#define Pilot_Tracker_Disconnect(pp) track_pilot(pp, tkv_Disconnect)
+
 
 
 // Hmmm, in a testap it appears abs() can take 0.1 to 30% longer than test and subtract in _MSC_VER, Sooooooo
@@ -263,7 +416,108 @@ void print_pilot(PCF_Pilot pp, char *pm, Pilot_Type pt)
 #define SETPREVPOS(p1,p2) { p1->PrevPos.Set( p2->SenderPosition.GetX(), p2->SenderPosition.GetY(), p2->SenderPosition.GetZ() ); }
 #endif // USE_SIMGEAR y/n
 
-#define SAME_FLIGHT(pp1,pp2)  ((strcmp(pp2->callsign, pp1->callsign) == 0)&&(strcmp(pp2->aircraft, pp1->aircraft) == 0))
+#define SAME_FLIGHT(pp1,pp2)  ((pp2->model_id == pp1->model_id)&&(strcmp(pp2->callsign, pp1->callsign) == 0))
+
+static PCF_Pilot find_flight( PCF_Pilot pp )
+{
+    size_t max = vPilots.size();
+    for (size_t ii = 0; ii < max; ii++) {
+        PCF_Pilot pp2 = &vPilots[ii]; // search list for this pilots
+        if (SAME_FLIGHT(pp,pp2))
+            return pp2;
+    }
+    return 0;
+}
+
+// advance the rough sim time line, from this flight's packet
+static void update_elapsed( PCF_Pilot pp, PCF_Pilot pp2 )
+{
+    double sseconds = pp2->sim_offset + (pp->sim_time - pp2->first_sim_time);
+    if (sseconds > elapsed_sim_time) {
+        double add = sseconds - elapsed_sim_time;
+        if (VERB9) {
+            SPRTF("%s: Update elapsed from %lf by %lf to %lf, from cs %s, model %s\n", module,
+                elapsed_sim_time, add, sseconds, 
+                pp->callsign, model_name(pp->model_id) );
+        }
+        elapsed_sim_time = sseconds;
+        got_sim_time = true;    // we have a rough sim time
+    }
+}
+
+#if !defined(USE_SIMGEAR) && !defined(USE_GeographicLib)
+///////////////////////////////////////////////////////////////////////
+// static bool early_discard( PCF_Pilot pp, PCF_Pilot pp2 )
+//
+// Phase one of the position decode. At this point pp only has the
+// sim time, raw ECEF position, orientation and speed. The TIME, DIST
+// and SPDC tests are done as below. For HDGC and ALTC, bound how far
+// the geodetic height and Euler heading can move, from the distance
+// travelled and the change in the orientation angle-axis, and if the
+// bound is below the threshold the packet must be a discard, so
+// sgCartToGeod(), euler_get(), ... need never be run for it.
+// Returns false on any doubt, and the full decode decides.
+///////////////////////////////////////////////////////////////////////
+#define ADD_EARLY_DISCARD
+#define ED_MIN_RADIUS   6.0e6   // below any ellipsoid radius of curvature, less height (m)
+#define ED_MAX_DIST     10000.0 // beyond this, just do the full decode (m)
+#define ED_MAX_PITCH    60.0    // heading is ill conditioned nearer to +/-90 (deg)
+#define ED_HDG_FACTOR   2.5     // > 1/cos(pitch) up to ED_MAX_PITCH, plus a bit
+
+static bool early_discard( PCF_Pilot pp, PCF_Pilot pp2 )
+{
+    double sseconds = pp->sim_time - pp2->sim_time;
+    if ((time_t)sseconds >= m_PlayerExpires)
+        return false;   // TIME
+    double dist_m = (Distance ( pp2->SenderPosition, pp->SenderPosition ) * SG_NM_TO_METER);
+    if ((dist_m > m_MinDistance_m) || (dist_m > ED_MAX_DIST))
+        return false;   // DIST
+    if (SPD_CHANGE(pp,pp2) > m_MinSpdChange_kt)
+        return false;   // SPDC
+
+    // ALTC - height moves by the travel along the old normal,
+    // plus at most d^2/2R for the curvature
+    double dx = pp->SenderPosition.GetX() - pp2->SenderPosition.GetX();
+    double dy = pp->SenderPosition.GetY() - pp2->SenderPosition.GetY();
+    double dz = pp->SenderPosition.GetZ() - pp2->SenderPosition.GetZ();
+    double d  = sqrt(dx*dx + dy*dy + dz*dz);
+    double lat_rad = pp2->lat * SG_DEGREES_TO_RADIANS;
+    double lon_rad = pp2->lon * SG_DEGREES_TO_RADIANS;
+    double clat = cos(lat_rad);
+    double dh = fabs((clat * cos(lon_rad) * dx) + (clat * sin(lon_rad) * dy) + (sin(lat_rad) * dz));
+    dh = (dh + (d * d / (2.0 * ED_MIN_RADIUS)) + 0.01) * M2F;
+    if (dh >= (double)m_MinAltChange_ft)
+        return false;
+    if ((pp2->alt - dh - 1.0) <= -9990.0)
+        return false;   // may be pkt_InvHgt
+
+    // HDGC - the body to local frame rotation moves by no more than
+    // the change in the angle-axis, plus the change in lat and lon
+    if (fabs(pp2->pitch) >= ED_MAX_PITCH)
+        return false;
+    double ox = pp->ox - pp2->ox;
+    double oy = pp->oy - pp2->oy;
+    double oz = pp->oz - pp2->oz;
+    double n1 = sqrt((double)pp->ox * pp->ox + pp->oy * pp->oy + pp->oz * pp->oz);
+    double n2 = sqrt((double)pp2->ox * pp2->ox + pp2->oy * pp2->oy + pp2->oz * pp2->oz);
+    if ((n1 < 0.001) || (n2 < 0.001))
+        return false;   // fromAngleAxis() degenerates
+    double r1 = sqrt(pp->SenderPosition.GetX() * pp->SenderPosition.GetX() +
+                     pp->SenderPosition.GetY() * pp->SenderPosition.GetY());
+    double r2 = sqrt(pp2->SenderPosition.GetX() * pp2->SenderPosition.GetX() +
+                     pp2->SenderPosition.GetY() * pp2->SenderPosition.GetY());
+    double rmin = (r1 < r2) ? r1 : r2;
+    if (rmin < 1.0)
+        return false;   // on the pole
+    double da = sqrt(ox*ox + oy*oy + oz*oz) + (d / ED_MIN_RADIUS) + (SG_PI * 0.5 * d / rmin);
+    double dhdg = da * ED_HDG_FACTOR * SG_RADIANS_TO_DEGREES;
+    if (dhdg >= (double)m_MinHdgChange_deg)
+        return false;
+    if (((pp2->heading - dhdg) < 0.5) || ((pp2->heading + dhdg) > 359.5))
+        return false;   // may wrap through north
+    return true;
+}
+#endif // !USE_SIMGEAR && !USE_GeographicLib
 
 Packet_Type Deal_With_Packet( char *packet, int len )
 {
@@ -274,20 +528,26 @@ Packet_Type Deal_With_Packet( char *packet, int len )
     uint32_t        MsgLen;
     uint32_t        MsgProto;
     T_PositionMsg*  PosMsg;
+#ifndef USE_SIMGEAR
+    T_PositionNative PosNat;
+#endif
     PT_MsgHdr       MsgHdr;
     PCF_Pilot       pp, pp2;
-    size_t          max, ii;
     char           *upd_by;
     double          sseconds;
     char           *tb = _s_tdchk;
     bool            revived;
-    time_t          curr_time = time(0);
+    Trace_Reason    reason;
+    int             rval = 0;
+    time_t          curr_time = clock_now();
+    uint64_t        ingest = pkt_ingest_ns;     // 0 if not stamped
+    uint64_t        decoded;
     double          lat, lon, alt;
     double          px, py, pz;
     char           *pcs;
     int             i;
-    char           *pm;
 
+    pkt_ingest_ns = 0;
     pp = &_s_new_pilot;
     memset(pp,0,sizeof(CF_Pilot)); // ensure new is ALL zero
     MsgHdr    = (PT_MsgHdr)packet;
@@ -338,10 +598,10 @@ Packet_Type Deal_With_Packet( char *packet, int len )
 #ifdef USE_SIMGEAR
         pp->sim_time = XDR_decode_double(PosMsg->time); // get SIM time
 #else
-        pp->sim_time = XDR_decode64<double> (PosMsg->time); // get SIM time
+        XDR_decode_position(PosMsg, &PosNat); // all the numeric fields, in one pass
+        pp->sim_time = PosNat.time; // get SIM time
 #endif
-        pm = get_Model(PosMsg->Model);
-        strcpy(pp->aircraft,pm);
+        pp->model_id = model_intern(PosMsg->Model, MAX_MODEL_NAME_LEN);
 
         // SPRTF("%s: POS Packet %d of len %d, buf %d, cs %s, mod %s, time %lf\n", module, packet_cnt, MsgLen, len, pcs, pm, pp->sim_time);
         // get Sender address and port - need patch in fgms to pass this
@@ -357,20 +617,41 @@ Packet_Type Deal_With_Packet( char *packet, int len )
 #else
         pp->SenderAddress = XDR_decode<uint32_t> (MsgHdr->ReplyAddress);
         pp->SenderPort    = XDR_decode<uint32_t> (MsgHdr->ReplyPort);
-        px = XDR_decode64<double> (PosMsg->position[X]);
-        py = XDR_decode64<double> (PosMsg->position[Y]);
-        pz = XDR_decode64<double> (PosMsg->position[Z]);
-        pp->ox = XDR_decode<float> (PosMsg->orientation[X]);
-        pp->oy = XDR_decode<float> (PosMsg->orientation[Y]);
-        pp->oz = XDR_decode<float> (PosMsg->orientation[Z]);
+        px = PosNat.position[X];
+        py = PosNat.position[Y];
+        pz = PosNat.position[Z];
+        pp->ox = PosNat.orientation[X];
+        pp->oy = PosNat.orientation[Y];
+        pp->oz = PosNat.orientation[Z];
+        pp->linearVel.Set (
+          PosNat.linearVel[X],
+          PosNat.linearVel[Y],
+          PosNat.linearVel[Z]
+            );
+        pp->speed = cf_norm(pp->linearVel) * SG_METER_TO_NM * 3600.0;
 #endif
         if ( (px == 0.0) || (py == 0.0) || (pz == 0.0)) {   
             failed_cnt++;
             return pkt_InvPos;
         }
+        pp->SenderPosition.Set(px, py, pz);
+        decoded = ingest ? clock_mono_nsecs() : 0;
+        pp2 = find_flight(pp);
+#ifdef ADD_EARLY_DISCARD
+        // if this packet is going to be discarded, decide it now,
+        // unless the DISC details are to be shown or traced
+        if (pp2 && !pp2->expired && !VERB9 && !trace_on && early_discard(pp,pp2)) {
+            pos_cnt++;
+            pp2->last_seen = curr_time;
+            update_elapsed(pp,pp2);
+            discard_cnt++;
+            early_cnt++;
+            pp2->packetsDiscarded++;
+            return pkt_Discards;
+        }
+#endif // ADD_EARLY_DISCARD
         // speed in this read raw log app is *not* of the essence
         // so ALWAYS do the 'alternate' matchs FIRST
-        pp->SenderPosition.Set(px, py, pz);
         sgCartToGeod(pp->SenderPosition, pp->GeodPoint);
         lat = pp->GeodPoint.GetX();
         lon = pp->GeodPoint.GetY();
@@ -438,139 +719,146 @@ Packet_Type Deal_With_Packet( char *packet, int len )
         euler_get( lat, lon, pp->ox, pp->oy, pp->oz,
             &pp->heading, &pp->pitch, &pp->roll );
 
-        pp->linearVel.Set (
-          XDR_decode<float> (PosMsg->linearVel[X]),
-          XDR_decode<float> (PosMsg->linearVel[Y]),
-          XDR_decode<float> (PosMsg->linearVel[Z])
-            );
         pp->angularVel.Set (
-          XDR_decode<float> (PosMsg->angularVel[X]),
-          XDR_decode<float> (PosMsg->angularVel[Y]),
-          XDR_decode<float> (PosMsg->angularVel[Z])
+          PosNat.angularVel[X],
+          PosNat.angularVel[Y],
+          PosNat.angularVel[Z]
             );
         pp->linearAccel.Set (
-          XDR_decode<float> (PosMsg->linearAccel[X]),
-          XDR_decode<float> (PosMsg->linearAccel[Y]),
-          XDR_decode<float> (PosMsg->linearAccel[Z])
+          PosNat.linearAccel[X],
+          PosNat.linearAccel[Y],
+          PosNat.linearAccel[Z]
             );
         pp->angularAccel.Set (
-          XDR_decode<float> (PosMsg->angularAccel[X]),
-          XDR_decode<float> (PosMsg->angularAccel[Y]),
-          XDR_decode<float> (PosMsg->angularAccel[Z])
+          PosNat.angularAccel[X],
+          PosNat.angularAccel[Y],
+          PosNat.angularAccel[Z]
             );
-        pp->speed = cf_norm(pp->linearVel) * SG_METER_TO_NM * 3600.0;
 #endif // #ifdef USE_SIMGEAR
 
         pos_cnt++;
         pp->expired = false;
-        max = vPilots.size();
         upd_by = 0;
-        for (ii = 0; ii < max; ii++) {
-            pp2 = &vPilots[ii]; // search list for this pilots
-            if (SAME_FLIGHT(pp,pp2)) {
-                pp2->last_seen = curr_time; // ALWAYS update 'last_seen'
-                //seconds = curr_time - pp2->curr_time; // seconds since last PACKET
-                sseconds = pp->sim_time - pp2->first_sim_time;
-                if (sseconds > elapsed_sim_time) {
-                    double add = sseconds - elapsed_sim_time;
-                    if (VERB9) {
-                        SPRTF("%s: Update elapsed from %lf by %lf to %lf, from cs %s, model %s\n", module,
-                            elapsed_sim_time, add, sseconds, 
-                            pp->callsign, pp->aircraft );
-                    }
-                    elapsed_sim_time = sseconds;
-                    got_sim_time = true;    // we have a rough sim time
-                }
-                sseconds = pp->sim_time - pp2->sim_time; // curr packet sim time minus last packet sim time
-                int spdchg = SPD_CHANGE(pp,pp2); // change_in_speed( pp, pp2 );
-                int hdgchg = HDG_CHANGE(pp,pp2); // change_in_heading( pp, pp2 );
-                int altchg = ALT_CHANGE(pp,pp2); // change_in_altitude( pp, pp2 );
-                revived = false;
-                pp->pt = pt_Pos;
-                if (pp2->expired) {
-                    pp2->expired = false;
-                    pp->pt = pt_Revived;
-                    sprintf(tb,"REVIVED=%d", (int)sseconds);
-                    upd_by = tb;    // (char *)"TIME";
-                    revived = true;
-                    pp->dist_m = 0.0;
-                } else {
+        if (pp2) {
+            pp2->last_seen = curr_time; // ALWAYS update 'last_seen'
+            //seconds = curr_time - pp2->curr_time; // seconds since last PACKET
+            update_elapsed(pp,pp2);
+            sseconds = pp->sim_time - pp2->sim_time; // curr packet sim time minus last packet sim time
+            int spdchg = SPD_CHANGE(pp,pp2); // change_in_speed( pp, pp2 );
+            int hdgchg = HDG_CHANGE(pp,pp2); // change_in_heading( pp, pp2 );
+            int altchg = ALT_CHANGE(pp,pp2); // change_in_altitude( pp, pp2 );
+            revived = false;
+            reason = trr_None;
+            pp->pt = pt_Pos;
+            if (pp2->expired) {
+                pp2->expired = false;
+                pp->pt = pt_Revived;
+                rval = (int)sseconds;
+                if (VERB9) sprintf(tb,"REVIVED=%d", rval);
+                upd_by = tb;    // (char *)"TIME";
+                revived = true;
+                pp->dist_m = 0.0;
+            } else {
 #ifdef USE_SIMGEAR  // TOCHECK - SG to get diatance
-                    SGVec3d p1(pp->px,pp->py,pp->pz);       // current position
-                    SGVec3d p2(pp2->px,pp2->py,pp2->pz);    // previous position
-                    pp->dist_m = length(p2 - p1); // * SG_METER_TO_NM;
+                SGVec3d p1(pp->px,pp->py,pp->pz);       // current position
+                SGVec3d p2(pp2->px,pp2->py,pp2->pz);    // previous position
+                pp->dist_m = length(p2 - p1); // * SG_METER_TO_NM;
 #else // !#ifdef USE_SIMGEAR
-                    pp->dist_m = (Distance ( pp2->SenderPosition, pp->SenderPosition ) * SG_NM_TO_METER); /** Nautical Miles to Meters */
+                pp->dist_m = (Distance ( pp2->SenderPosition, pp->SenderPosition ) * SG_NM_TO_METER); /** Nautical Miles to Meters */
 #endif // #ifdef USE_SIMGEAR y/n
-                    if ((time_t)sseconds >= m_PlayerExpires) {
-                        sprintf(tb,"TIME=%d", (int)sseconds);
-                        upd_by = tb;    // (char *)"TIME";
-                    } else if (pp->dist_m > m_MinDistance_m) {
-                        sprintf(tb,"DIST=%d/%d", (int)(pp->dist_m+0.5), (int)sseconds);
-                        upd_by = tb; // (char *)"DIST";
-                    } else if (spdchg > m_MinSpdChange_kt) {
-                        sprintf(tb,"SPDC=%d", spdchg);
-                        upd_by = tb;    // (char *)"TIME";
-                    } else if (hdgchg > m_MinHdgChange_deg) {
-                        sprintf(tb,"HDGC=%d", hdgchg);
-                        upd_by = tb;    // (char *)"TIME";
-                    } else if (altchg > m_MinAltChange_ft) {
-                        sprintf(tb,"ALTC=%d", altchg);
-                        upd_by = tb;    // (char *)"TIME";
-                    }
+                // only format the reason text if it is going to be shown
+                if ((time_t)sseconds >= m_PlayerExpires) {
+                    reason = trr_TIME;
+                    rval = (int)sseconds;
+                    if (VERB9) sprintf(tb,"TIME=%d", rval);
+                    upd_by = tb;    // (char *)"TIME";
+                } else if (pp->dist_m > m_MinDistance_m) {
+                    reason = trr_DIST;
+                    rval = (int)(pp->dist_m+0.5);
+                    if (VERB9) sprintf(tb,"DIST=%d/%d", rval, (int)sseconds);
+                    upd_by = tb; // (char *)"DIST";
+                } else if (spdchg > m_MinSpdChange_kt) {
+                    reason = trr_SPDC;
+                    rval = spdchg;
+                    if (VERB9) sprintf(tb,"SPDC=%d", spdchg);
+                    upd_by = tb;    // (char *)"TIME";
+                } else if (hdgchg > m_MinHdgChange_deg) {
+                    reason = trr_HDGC;
+                    rval = hdgchg;
+                    if (VERB9) sprintf(tb,"HDGC=%d", hdgchg);
+                    upd_by = tb;    // (char *)"TIME";
+                } else if (altchg > m_MinAltChange_ft) {
+                    reason = trr_ALTC;
+                    rval = altchg;
+                    if (VERB9) sprintf(tb,"ALTC=%d", altchg);
+                    upd_by = tb;    // (char *)"TIME";
                 }
-                if (upd_by) {
-                    if (revived) {
-                        pp->flight_id      = get_epoch_id(); // establish NEW UNIQUE ID for flight
-                        pp->first_sim_time = pp->sim_time;   // restart first sim time
-                        pp->cumm_nm       += pp2->total_nm;  // get cummulative nm
-                        pp2->total_nm      = 0.0;            // restart nm
-                    } else {
-                        pp->flight_id      = pp2->flight_id; // use existing FID
-                        pp->first_sim_time = pp2->first_sim_time; // keep first sim time
-                        pp->first_time     = pp2->first_time; // keep first epoch time
-                    }
-                    pp->expired          = false;
-                    pp->packetCount      = pp2->packetCount + 1;
-                    pp->packetsDiscarded = pp2->packetsDiscarded;
-                    pp->prev_sim_time    = pp2->sim_time;
-                    pp->prev_time        = pp2->curr_time;
-                    // accumulate total distance travelled (in nm)
-                    pp->total_nm         = pp2->total_nm + (pp->dist_m * SG_METER_TO_NM);
-                    SETPREVPOS(pp,pp2);  // copy POS to PrevPos to get distance travelled
-                    pp->curr_time        = curr_time; // set CURRENT packet time
-                    *pp2 = *pp;     // UPDATE the RECORD with latest info
-                    print_pilot(pp2,upd_by,pt_Pos);
-                    //if (revived)
-                    //    Pilot_Tracker_Connect(pp2);
-                    //else
-                    //    Pilot_Tracker_Position(pp2);
-
+            }
+            if (upd_by) {
+                if (revived) {
+                    pp->flight_id      = get_epoch_id(); // establish NEW UNIQUE ID for flight
+                    pp->first_sim_time = pp->sim_time;   // restart first sim time
+                    pp->sim_offset     = elapsed_sim_time;
+                    pp->cumm_nm       += pp2->total_nm;  // get cummulative nm
+                    pp2->total_nm      = 0.0;            // restart nm
                 } else {
+                    pp->flight_id      = pp2->flight_id; // use existing FID
+                    pp->first_sim_time = pp2->first_sim_time; // keep first sim time
+                    pp->sim_offset     = pp2->sim_offset;
+                    pp->first_time     = pp2->first_time; // keep first epoch time
+                }
+                pp->expired          = false;
+                pp->packetCount      = pp2->packetCount + 1;
+                pp->packetsDiscarded = pp2->packetsDiscarded;
+                pp->prev_sim_time    = pp2->sim_time;
+                pp->prev_time        = pp2->curr_time;
+                // accumulate total distance travelled (in nm)
+                pp->total_nm         = pp2->total_nm + (pp->dist_m * SG_METER_TO_NM);
+                SETPREVPOS(pp,pp2);  // copy POS to PrevPos to get distance travelled
+                pp->curr_time        = curr_time; // set CURRENT packet time
+                pp->pub_ingest_ns    = pp2->pub_ingest_ns; // until the next json feed
+                pp->pub_served       = pp2->pub_served;
+                stage_update(pp, ingest, decoded);
+                *pp2 = *pp;     // UPDATE the RECORD with latest info
+                print_pilot(pp2,upd_by,pt_Pos);
+                trace_pilot(pp2, (revived ? tev_Revived : tev_Pos), reason, rval);
+                if (revived)
+                    Pilot_Tracker_Connect(pp2);
+                else
+                    Pilot_Tracker_Position(pp2);
+
+            } else {
+                if (VERB9) {
                     sprintf(tb,"DISC T=%d,D=%d/%d,S=%d,H=%d,A=%d", (int)sseconds,
                         (int)(pp->dist_m+0.5), (int)sseconds,
                         spdchg, hdgchg, altchg);
                     print_pilot(pp2,tb,pt_Pos);
-                    discard_cnt++;
-                    pp2->packetsDiscarded++;
-                    return pkt_Discards;
                 }
+                pp->flight_id = pp2->flight_id;
+                trace_pilot(pp, tev_Disc, trr_None, (int)(pp->dist_m+0.5));
+                discard_cnt++;
+                pp2->packetsDiscarded++;
+                return pkt_Discards;
+            }
 
-                return pkt_Pos;
+            return pkt_Pos;
 
-            }
         }
         pp->packetCount = 1;
         pp->packetsDiscarded = 0;
         pp->first_sim_time = pp->prev_sim_time = pp->sim_time;
+        pp->sim_offset = elapsed_sim_time;  // joins the sim time line now
         SETPREVPOS(pp,pp); // set as SAME as current
         pp->curr_time  = curr_time; // set CURRENT packet time
         pp->pt = pt_New;
         pp->flight_id = get_epoch_id(); // establish UNIQUE ID for flight
         pp->dist_m = 0.0;
         pp->total_nm = 0.0;
+        stage_update(pp, ingest, decoded);
         vPilots.push_back(*pp);
         print_pilot(pp,(char *)"NEW ",pt_Pos);
+        trace_pilot(pp, tev_New, trr_None, 0);
+        Pilot_Tracker_Connect(pp);
         return pkt_First;
 
     } else if (MsgId == CHAT_MSG_ID) {
@@ -583,6 +871,42 @@ Packet_Type Deal_With_Packet( char *packet, int len )
     return pkt_Invalid;
 }
 
+///////////////////////////////////////////////////////////////////////
+// bool Get_Packet_Elapsed( char *packet, int len, double *pelapsed )
+//
+// Peek at the next packet, without changing any state, and get the
+// elapsed sim time it will represent, for the replay pacer.
+// Returns false if not a position packet, or the flight is not yet
+// known, in which case it is due now.
+///////////////////////////////////////////////////////////////////////
+bool Get_Packet_Elapsed( char *packet, int len, double *pelapsed )
+{
+    PT_MsgHdr MsgHdr = (PT_MsgHdr)packet;
+    T_PositionMsg *PosMsg;
+    PCF_Pilot pp2;
+    size_t max, ii;
+    double sim_time;
+    int model_id;
+    if (len < (int)(sizeof(T_MsgHdr) + sizeof(T_PositionMsg)))
+        return false;
+    if (XDR_decode_uint32(MsgHdr->MsgId) != POS_DATA_ID)
+        return false;
+    PosMsg = (T_PositionMsg *) (packet + sizeof(T_MsgHdr));
+    sim_time = XDR_decode_double(PosMsg->time);
+    model_id = model_intern(PosMsg->Model, MAX_MODEL_NAME_LEN);
+    max = vPilots.size();
+    for (ii = 0; ii < max; ii++) {
+        pp2 = &vPilots[ii];
+        if ((pp2->model_id == model_id) &&
+            (strncmp(pp2->callsign, MsgHdr->Callsign, MAX_CALLSIGN_LEN) == 0)) {
+            if (pp2->expired)
+                return false;
+            *pelapsed = pp2->sim_offset + (sim_time - pp2->first_sim_time);
+            return true;
+        }
+    }
+    return false;
+}
 
 PKTSTR sPktStr[pkt_Max] = {
     { pkt_Invalid, "Invalid",     0, 0, 0 },
@@ -642,7 +966,7 @@ void Expire_Pilots()
     vCFP *pvlist = &vPilots;
     size_t max, ii, xcnt, nxcnt;
     PCF_Pilot pp;
-    time_t curr = time(0);  // get current epoch seconds
+    time_t curr = clock_now();  // get current epoch seconds
     time_t diff;
     int idiff, iExp;
     iExp = (int)m_PlayerExpires;
@@ -665,7 +989,8 @@ void Expire_Pilots()
                 sprintf(tb,"EXPIRED %d",idiff); 
                 //print_pilot(pp,"EXPIRED");
                 print_pilot(pp, tb, pt_Expired);
-                //Pilot_Tracker_Disconnect(pp);
+                trace_pilot(pp, tev_Expired, trr_None, idiff);
+                Pilot_Tracker_Disconnect(pp);
                 nxcnt++;
             }
         }
@@ -707,16 +1032,74 @@ bool is_json_file_disabled()
 ///////////////////////////////////////////////////////////////////////
 // A simple buffer, reallocated to suit json string size
 // to hold the full json string
+// While an HTTP send references it, it is pinned, and the next
+// write moves to a new buffer. The last Release_Feed() frees it.
 // =====================================================
 typedef struct tagJSONSTR {
     int size;
     int used;
     char *buf;
+    int refs;       // sends still in progress
+    bool retired;   // no longer the current feed
 }JSONSTR, *PJSONSTR;
 
 static PJSONSTR _s_pJsonStg = 0;
 static PJSONSTR _s_pXmlStg = 0;
 
+#ifndef DEF_JSON_SIZE
+#define DEF_JSON_SIZE 1024 // 16 for testing
+#endif
+
+// get the buffer to write the feed into
+static PJSONSTR Get_Feed_Stg( PJSONSTR *ppjs )
+{
+    PJSONSTR pjs = *ppjs;
+    int size = DEF_JSON_SIZE;
+    if (pjs && pjs->refs) {
+        size = pjs->size;   // start at the size it grew to
+        pjs->retired = true;
+        pjs = 0;
+    }
+    if (!pjs) {
+        pjs = new JSONSTR;
+        pjs->size = size;
+        pjs->buf = (char *)malloc(pjs->size);
+        if (!pjs->buf) {
+            SPRTF("%s: ERROR: Failed in memory allocation! Size %d. Aborting\n", mod_name, pjs->size);
+            exit(1);
+        }
+        pjs->buf[0] = 0;
+        pjs->used = 0;
+        pjs->refs = 0;
+        pjs->retired = false;
+        *ppjs = pjs;
+    }
+    return pjs;
+}
+
+static int Get_Feed_Ref( PJSONSTR pjs, char **pbuf, void **pref )
+{
+    if (pjs && pjs->used) {
+        pjs->refs++;
+        *pbuf = pjs->buf;
+        *pref = pjs;
+        return pjs->used;
+    }
+    return 0;
+}
+
+void Release_Feed( void *ref )
+{
+    PJSONSTR pjs = (PJSONSTR)ref;
+    if (pjs && pjs->refs) {
+        pjs->refs--;
+        if (!pjs->refs && pjs->retired) {
+            free(pjs->buf);
+            delete pjs;
+        }
+    }
+}
+
 const char *header = "{\"success\":true,\"source\":\"cf-client\",\"last_updated\":\"%s\",\"flights\":[\n";
 const char *tail   = "],\"count\":%u}\n";
 const char*json_stg_org = "{\"fid\":\"%s\",\"callsign\":\"%s\",\"lat\":\"%f\",\"lon\":\"%f\",\"alt_ft\":\"%d\",\"model\":\"%s\",\"spd_kts\":\"%d\",\"hdg\":\"%d\",\"dist_nm\":\"%d\"}";
@@ -762,10 +1145,6 @@ int Add_JSON_Head(PJSONSTR pjs)
 time_t show_time = 0;
 time_t show_delay = 300;
 long write_count = 0;
-#ifndef DEF_JSON_SIZE
-#define DEF_JSON_SIZE 1024; // 16 for testing
-#endif
-
 ////////////////////////////////////////////////////////////////////////////
 // XML Feed - FIX20130404 - Add XML feed
 int Get_XML( char **pbuf )
@@ -777,6 +1156,11 @@ int Get_XML( char **pbuf )
     }
     return 0;
 }
+
+int Get_XML_Ref( char **pbuf, void **pref )
+{
+    return Get_Feed_Ref(_s_pXmlStg, pbuf, pref);
+}
 /* ------------------------------------
 <?xml version="1.0" encoding="UTF-8"?>
  <fg_server pilot_cnt="35">
@@ -795,23 +1179,12 @@ const char *x_open = "<fg_server pilot_cnt=\"%d\">\n";
 const char *x_mark = "<marker spd_kt=\"%d\" heading=\"%d\" alt=\"%d\" lng=\"%.6f\" lat=\"%.6f\" model=\"%s\" server_ip=\"%s\" callsign=\"%s\"/>\n";
 const char *x_tail = "</fg_server>\n";
 
-int Write_XML() // FIX20130404 - Add XML feed
+static int build_xml()
 {
     struct in_addr in;
     static char _s_xbuf[1028];
-    PJSONSTR pxs = _s_pXmlStg;
+    PJSONSTR pxs = Get_Feed_Stg(&_s_pXmlStg);
     char *paddr;
-    if (!pxs) {
-        pxs = new JSONSTR;
-        pxs->size = DEF_JSON_SIZE;
-        pxs->buf = (char *)malloc(pxs->size);
-        if (!pxs->buf) {
-            SPRTF("%s: ERROR: Failed in memory allocation! Size %d. Aborting\n", mod_name, pxs->size);
-            exit(1);
-        }
-        pxs->used = 0;
-        _s_pXmlStg = pxs;
-    }
     vCFP *pvlist = &vPilots;
     size_t max, ii;
     PCF_Pilot pp;
@@ -854,7 +1227,7 @@ int Write_XML() // FIX20130404 - Add XML feed
             (int)(pp->alt + 0.5),
             pp->lon,
             pp->lat,
-            get_Model(pp->aircraft),
+            model_name(pp->model_id),
             paddr,
             pp->callsign );
         Append_2_Buf( pxs, pb );
@@ -863,6 +1236,15 @@ int Write_XML() // FIX20130404 - Add XML feed
     return 0;
 }
 
+int Write_XML() // FIX20130404 - Add XML feed
+{
+    init_pilot_metrics();
+    uint64_t bgn = clock_mono_nsecs();
+    int iret = build_xml();
+    met_hist_add(met_xml_build, clock_mono_nsecs() - bgn);
+    return iret;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////
 
@@ -876,13 +1258,18 @@ int Get_JSON( char **pbuf )
     return 0;
 }
 
+int Get_JSON_Ref( char **pbuf, void **pref )
+{
+    return Get_Feed_Ref(_s_pJsonStg, pbuf, pref);
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // int Write_JSON()
 // Format the JSON string into a buffer ready to be collected
 // 20121125 - Added the unique flight id to the output
 // 20121127 - Added total distance (nm) to output
 // =======================================================================
-int Write_JSON()
+static int build_json()
 {
     static char _s_jbuf[1028];
     static char _s_epid[264];
@@ -891,18 +1278,7 @@ int Write_JSON()
     PCF_Pilot pp;
     int len, wtn, count, total_cnt;
     // struct in_addr in;
-    PJSONSTR pjs = _s_pJsonStg;
-    if (!pjs) {
-        pjs = new JSONSTR;
-        pjs->size = DEF_JSON_SIZE;
-        pjs->buf = (char *)malloc(pjs->size);
-        if (!pjs->buf) {
-            SPRTF("%s: ERROR: Failed in memory allocation! Size %d. Aborting\n", mod_name, pjs->size);
-            exit(1);
-        }
-        pjs->used = 0;
-        _s_pJsonStg = pjs;
-    }
+    PJSONSTR pjs = Get_Feed_Stg(&_s_pJsonStg);
     Add_JSON_Head(pjs);
     max = pvlist->size();
     char *tb = _s_jbuf; // buffer for each json LINE;
@@ -921,7 +1297,7 @@ int Write_JSON()
                 pp->callsign, 
                 pp->lat, pp->lon, 
                 (int) (pp->alt + 0.5),
-                pp->aircraft,
+                model_name(pp->model_id),
                 (int)(pp->speed + 0.5),
                 (int)(pp->heading + 0.5),
                 (int)(pp->total_nm + 0.5) );
@@ -970,7 +1346,7 @@ int Write_JSON()
             return 1;
         }
         write_count++;
-        time_t curr = time(0);
+        time_t curr = clock_now();
         if (curr > show_time) {
             SPRTF("%s: Written %s, %d times, last with %d of %d pilots\n", mod_name, pjson, write_count, count, total_cnt);
             show_time = curr + show_delay;
@@ -979,6 +1355,16 @@ int Write_JSON()
     return 0;
 }
 
+int Write_JSON()
+{
+    init_pilot_metrics();
+    uint64_t bgn = clock_mono_nsecs();
+    int iret = build_json();
+    met_hist_add(met_json_build, clock_mono_nsecs() - bgn);
+    stage_publish();
+    return iret;
+}
+
 
 
 // eof = cf-pilot.cxx
@@ -30,6 +30,7 @@ enum Packet_Type {
 
 
 extern Packet_Type Deal_With_Packet( char *packet, int len );
+extern bool Get_Packet_Elapsed( char *packet, int len, double *pelapsed ); // peek, for pacing
 extern void Expire_Pilots();
 extern int Write_JSON();
 extern int Write_XML(); // FIX20130404 - Add XML feed
@@ -49,13 +50,24 @@ extern PPKTSTR Get_Pkt_Str();
 
 extern time_t m_PlayerExpires;     // standard expiration period (seconds)
 extern size_t packet_cnt;
+extern uint64_t pkt_ingest_ns;  // set just before Deal_With_Packet(), for stage latency
 extern double elapsed_sim_time;
 extern bool got_sim_time;
 
 // get the data
 extern int Get_JSON( char **pbuf );
 extern int Get_XML( char **pbuf );
+// get the data pinned, for a send by reference, until Release_Feed( ref )
+extern int Get_JSON_Ref( char **pbuf, void **pref );
+extern int Get_XML_Ref( char **pbuf, void **pref );
+extern void Release_Feed( void *ref );
 extern void clean_up_pilots( bool clear = true );
+// for the /metrics scrape
+extern void init_pilot_metrics();   // register the stage and feed build histograms
+extern void Stage_JSON_Sent();      // a json feed was queued to send
+extern void Get_Pilot_Counts( int *plive, int *pexpired );  // in the list
+// discards decided early, or after the full compare, and failed packets
+extern void Get_Discard_Counts( size_t *pearly, size_t *pcompare, size_t *pfailed );
 
 
 #endif // #ifndef _CF_PILOT_HXX_
@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <string.h> // for strlen(), strdup(), ...
 #include <time.h>
+#include <errno.h>
 #ifndef _MSC_VER
 #include <stdlib.h> // for atoi(), ...
 #include <unistd.h> // usleep(), ...
@@ -19,6 +20,13 @@
 #include "cf-pilot.hxx"
 #include "sprtf.hxx"
 #include "mpKeyboard.hxx"
+#include "cf_trace.hxx"
+#include "cf_clock.hxx"
+#include "cf_pacer.hxx"
+#include "cf_metrics.hxx"
+#include "cf_models.hxx"
+#include "cf_tracker.hxx"
+#include "cf_tracks.hxx"
 #include "cf-server.hxx"
 
 static const char *module = "cf-server";
@@ -28,6 +36,7 @@ void http_close();
 void send_extra_headers(struct mg_connection *conn);
 
 static bool use_sim_time2 = true;
+static bool fast_replay = false;
 
 #ifndef DEF_SERVER_PORT
 #define DEF_SERVER_PORT 5555
@@ -40,6 +49,20 @@ static bool use_sim_time2 = true;
 #define DEF_TIMEOUT_MS 50   // was 500
 #endif
 
+// HTTP connection limits, see mongoose options
+#ifndef DEF_MAX_CONNS
+#define DEF_MAX_CONNS 256   // accepted connections, then 503
+#endif
+#ifndef DEF_IDLE_SECS
+#define DEF_IDLE_SECS 30    // close a connection idle this long
+#endif
+#ifndef DEF_OUT_MAX_KB
+#define DEF_OUT_MAX_KB 1024 // output per connection before requests are deferred
+#endif
+#ifndef RATE_SECS
+#define RATE_SECS 10        // request rate over this many seconds
+#endif
+
 #ifndef SLEEP
 #ifdef _MSC_VER
 #define SLEEP(x) Sleep(x)
@@ -53,21 +76,72 @@ static int port = DEF_SERVER_PORT;
 static int sleep_ms = DEF_SLEEP_MS;
 static int timeout_ms = DEF_TIMEOUT_MS;
 static const char *log_file = "temphttp.txt";
+static int max_conns = DEF_MAX_CONNS;
+static int idle_secs = DEF_IDLE_SECS;
+static int out_max_kb = DEF_OUT_MAX_KB;
 
 static size_t cb_cnt = 0;
 static size_t http_cnt = 0;
 static size_t json_cnt = 0;
 static size_t xml_cnt = 0;
 static size_t info_cnt = 0;
+static size_t track_cnt = 0;
+static size_t metrics_cnt = 0;
+static size_t other_cnt = 0;   // not found
+static size_t reuse_cnt = 0;    // requests on a kept-alive connection
+static time_t rate_secs[RATE_SECS];
+static int rate_cnts[RATE_SECS];
+
+static struct mg_server *server;    // Set by http_init()
+
+// count a request in its second of the rate ring
+static void add_request_rate()
+{
+    time_t now = clock_now();   // cached at the last clock_tick()
+    int i = (int)(now % RATE_SECS);
+    if (rate_secs[i] != now) {
+        rate_secs[i] = now;
+        rate_cnts[i] = 0;
+    }
+    rate_cnts[i]++;
+}
+
+// requests per second, over the last RATE_SECS full seconds
+static double get_request_rate()
+{
+    time_t now = clock_now();
+    int i, cnt = 0;
+    for (i = 0; i < RATE_SECS; i++) {
+        if ((rate_secs[i] < now) && ((now - rate_secs[i]) <= RATE_SECS))
+            cnt += rate_cnts[i];
+    }
+    return (double)cnt / (double)RATE_SECS;
+}
+
+static double get_reuse_pct()
+{
+    return http_cnt ? (double)reuse_cnt * 100.0 / (double)http_cnt : 0.0;
+}
 
 void show_http_stats()
 {
-    SPRTF("%s: %d cb, %d http get, %d json, %d xml, %d info.\n", module,
+    struct mg_conn_stats cs;
+    SPRTF("%s: %d cb, %d http get, %d json, %d xml, %d info, %d track, %d metrics, %d other.\n", module,
         (int)cb_cnt,
         (int)http_cnt,
         (int)json_cnt,
         (int)xml_cnt,
-        (int)info_cnt );
+        (int)info_cnt,
+        (int)track_cnt,
+        (int)metrics_cnt,
+        (int)other_cnt );
+    if (server) {
+        mg_get_conn_stats(server, &cs);
+        SPRTF("%s: conns %d active, %d peak, %lu accepted, %lu rejected, %lu idle closed, %lu flood closed.\n", module,
+            cs.active, cs.peak, cs.accepted, cs.rejected, cs.idle_closed, cs.flood_closed );
+        SPRTF("%s: keep-alive reuse %.1f%%, %d deferred, %.1f req/s.\n", module,
+            get_reuse_pct(), (int)cs.deferred, get_request_rate() );
+    }
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -118,15 +192,35 @@ static void give_help( char *name )
     //      123456789112345678921
     printf(" --help   (-h or -?) = This help and exit(2)\n");
     printf(" --port <num>   (-p) = Set port (def=%d)\n", port);
+    printf(" --conns <num>  (-c) = Set max HTTP connections, then 503. 0 for no limit. (def=%d)\n", max_conns);
+    printf(" --idle <secs>  (-i) = Set seconds before an idle HTTP connection is closed. (def=%d)\n", idle_secs);
+    printf(" --outmax <KB>  (-o) = Set KB of output per HTTP connection before further, or\n");
+    printf("                       pipelined, requests wait. 0 for no limit. (def=%d)\n", out_max_kb);
     printf(" --raw <file>   (-r) = Set the raw udp log file to use. \n Default is '%s'\n", raw_log);
+    printf("                       It can also be a compact recording, from raw-log --convert,\n");
+    printf("                       or a block compressed log, from raw-log --zip.\n");
+    printf(" --at <secs>    (-a) = Replay from secs into a recording, or block compressed log. (def=0)\n");
     printf(" --log <file>   (-l) = Set output log file. (def=%s, in CWD if relative)\n", log_file);
-    printf(" --sleep <ms>   (-s) = Set milliseconds sleep in loop. 0 for none. (def=%d)\n", sleep_ms);
+    printf(" --sleep <ms>   (-s) = Set milliseconds sleep each second, when there is no packet\n");
+    printf("                       deadline to pace to, as before the log replays again. 0 for none. (def=%d)\n", sleep_ms);
     printf(" --timeout <ms> (-t) = Set milliseconds timeout for select(). (def=%d)\n", timeout_ms);
     printf(" --verb[num]    (-v) = Bump or set verbosity. (def=%d)\n", verbosity);
+    printf(" --mult <x>     (-m) = Set replay speed multiplier, %g to %g. (def=%g)\n", PACER_MIN_SPEED,
+        PACER_MAX_SPEED, pacer_get_speed());
+    printf(" --fast         (-f) = Replay the raw log once, at max speed, with no HTTP server,\n");
+    printf("                       expiry and feeds driven by sim time, and show throughput.\n");
+    printf(" --journal <file> (-j) = Write a binary journal of pilot events. (def=none)\n");
+    printf("                  Use cf-trace to render it as text or csv.\n");
+    printf(" --db <file>    (-d) = Record flights and positions to a sqlite3 database. (def=none)\n");
+    printf("                       Or 'pg:<conninfo>' for PostgreSQL, like 'pg:dbname=crossfeed'.\n");
+    printf("                       Needs a build configured with USE_SQLITE_TRACKER, or USE_PG_TRACKER, ON.\n");
+    printf(" --keep <dir>   (-k) = Keep a track store of every flight in the directory. (def=none)\n");
     printf("\n");
     printf("Will establish a HTTP server on the port, and respond to GET with -\n");
     printf("/flights.json - return json list of current flights, updated each second\n");
     printf("/flights.xml  - return xml  list of current flights, updated each second\n");
+    printf("/track.json?fid=<id> - return the stored track of a flight, if --keep\n");
+    printf("/metrics      - return counters, and latency histograms, in Prometheus text format\n");
     printf("\n");
     printf("All others will return 400 - command error, or 404 - file not found\n");
     printf("\n");
@@ -165,13 +259,104 @@ static int parse_commands( int argc, char **argv )
                     goto Bad_CMD;
                 }
                 break;
+            case 'a':
+                if (i2 < argc) {
+                    i++;
+                    sarg = argv[i];
+                    log_start_secs = atof(sarg);
+                    SPRTF("%s: Set replay start to %.1f secs into the log\n", module, log_start_secs);
+                } else {
+                    SPRTF("%s: Expected seconds to follow %s!\n", module, arg );
+                    goto Bad_CMD;
+                }
+                break;
             case 'h':
             case '?':
                 give_help( get_file_name(argv[0]) );
                 return 2;
+            case 'f':
+                fast_replay = true;
+                break;
+            case 'c':
+                if (i2 < argc) {
+                    i++;
+                    sarg = argv[i];
+                    max_conns = atoi(sarg);
+                    SPRTF("%s: Set max connections to %d\n", module, max_conns);
+                } else {
+                    SPRTF("%s: Expected max connections to follow %s!\n", module, arg );
+                    goto Bad_CMD;
+                }
+                break;
+            case 'i':
+                if (i2 < argc) {
+                    i++;
+                    sarg = argv[i];
+                    idle_secs = atoi(sarg);
+                    SPRTF("%s: Set idle timeout to %d secs\n", module, idle_secs);
+                } else {
+                    SPRTF("%s: Expected idle seconds to follow %s!\n", module, arg );
+                    goto Bad_CMD;
+                }
+                break;
+            case 'o':
+                if (i2 < argc) {
+                    i++;
+                    sarg = argv[i];
+                    out_max_kb = atoi(sarg);
+                    SPRTF("%s: Set output budget to %d KB per connection\n", module, out_max_kb);
+                } else {
+                    SPRTF("%s: Expected output KB to follow %s!\n", module, arg );
+                    goto Bad_CMD;
+                }
+                break;
+            case 'j':
+                if (i2 < argc) {
+                    i++;
+                    sarg = argv[i];
+                    if (trace_open(sarg))
+                        goto Bad_CMD;
+                } else {
+                    SPRTF("%s: Expected journal file name to follow %s!\n", module, arg );
+                    goto Bad_CMD;
+                }
+                break;
+            case 'd':
+                if (i2 < argc) {
+                    i++;
+                    sarg = argv[i];
+                    if (tracker_open(sarg))
+                        goto Bad_CMD;
+                } else {
+                    SPRTF("%s: Expected database file name to follow %s!\n", module, arg );
+                    goto Bad_CMD;
+                }
+                break;
+            case 'k':
+                if (i2 < argc) {
+                    i++;
+                    sarg = argv[i];
+                    if (tracks_open(sarg))
+                        goto Bad_CMD;
+                } else {
+                    SPRTF("%s: Expected track store directory to follow %s!\n", module, arg );
+                    goto Bad_CMD;
+                }
+                break;
             case 'l':
                 i++;    // log file already checked and handled
                 break;
+            case 'm':
+                if (i2 < argc) {
+                    i++;
+                    sarg = argv[i];
+                    pacer_set_speed(atof(sarg));
+                    SPRTF("%s: Set replay speed to %gx\n", module, pacer_get_speed());
+                } else {
+                    SPRTF("%s: Expected speed multiplier to follow %s!\n", module, arg );
+                    goto Bad_CMD;
+                }
+                break;
             case 'p':
                 if (i2 < argc) {
                     i++;
@@ -297,9 +482,12 @@ static char info[] =
     "<ul>"
     "<li>/flights.json - Return a json encoded list of current pilots</li>"
     "<li>/flights.xml - The same list xml encoded list of current pilots</li>"
+    "<li>/track.json?fid=&lt;id&gt; - The stored track of a flight, if kept</li>"
+    "<li>/metrics - Counters, and latency histograms, in Prometheus text format</li>"
     "<li>/ or /info - Returns this page</li>"
     "</ul>"
-    "<p><strong>All others will return 400 bad command, or 404 not found</strong></p>"
+    "<p><strong>All others will return 400 bad command, or 404 not found</strong></p>";
+static char info_end[] =
     "</body>"
     "</html>";
 
@@ -308,20 +496,40 @@ static int showOptions(struct mg_connection *conn)
     int iret = MG_FALSE;
     char *cp = info;
     int len = strlen(cp);
+    struct mg_conn_stats cs;
     if (len) {
         mg_send_header(conn,"Content-Type","text/html");
         mg_send_data(conn,cp,len);
+        mg_get_conn_stats(server, &cs);
+        mg_printf_data(conn,
+            "<h2>Connections</h2>"
+            "<ul>"
+            "<li>Active %d, peak %d, of max %d</li>"
+            "<li>Accepted %lu, rejected %lu, idle closed %lu, flood closed %lu</li>"
+            "<li>Requests %d, %.1f per second, keep-alive reuse %.1f%%</li>"
+            "<li>Deferred over the %d KB output budget %lu</li>"
+            "<li>Idle timeout %d seconds</li>"
+            "</ul>",
+            cs.active, cs.peak, max_conns,
+            cs.accepted, cs.rejected, cs.idle_closed, cs.flood_closed,
+            (int)http_cnt, get_request_rate(), get_reuse_pct(),
+            out_max_kb, cs.deferred,
+            idle_secs );
+        mg_send_data(conn,info_end,strlen(info_end));
         iret = MG_TRUE;
         if (VERB2) SPRTF("%s: Sent Information html, len %d\n", module, len);
     }
     return iret;
 }
 
+// The feeds are sent by reference, from the pinned snapshot, not copied
+// into each connection's output buffer
 static int sendJSON(struct mg_connection *conn)
 {
     int iret = MG_FALSE;
     char *cp = 0;
-    int len = Get_JSON( &cp );
+    void *ref = 0;
+    int len = Get_JSON_Ref( &cp, &ref );
     if (len && cp) {
         if (use_plain_text)
             mg_send_header(conn,"Content-Type","text/plain");
@@ -329,7 +537,8 @@ static int sendJSON(struct mg_connection *conn)
             mg_send_header(conn,"Content-Type","application/json");
         if (send_exta_hdrs)
             send_extra_headers(conn);
-        mg_send_data(conn,cp,len);
+        mg_send_data_ref(conn,cp,len,Release_Feed,ref);
+        Stage_JSON_Sent();
         iret = MG_TRUE;
         if (VERB2) SPRTF("%s: Sent JSON string, len %d\n", module, len);
     }
@@ -340,12 +549,13 @@ static int sendXML(struct mg_connection *conn)
 {
     int iret = MG_FALSE;
     char *cp = 0;
-    int len = Get_XML( &cp );
+    void *ref = 0;
+    int len = Get_XML_Ref( &cp, &ref );
     if (len && cp) {
         mg_send_header(conn,"Content-Type","text/xml");
         if (send_exta_hdrs)
             send_extra_headers(conn);
-        mg_send_data(conn,cp,len);
+        mg_send_data_ref(conn,cp,len,Release_Feed,ref);
         iret = MG_TRUE;
         if (VERB2) SPRTF("%s: Sent XML string, len %d\n", module, len);
 
@@ -354,6 +564,88 @@ static int sendXML(struct mg_connection *conn)
 }
 
 
+#ifndef ISDIGIT
+#define ISDIGIT(a) ((a >= '0') && (a <= '9'))
+#endif
+
+// The track of one flight, from the track store, by flight id, or 400
+// if the fid is missing or not a number
+static int sendTrack(struct mg_connection *conn)
+{
+    char fid[32];
+    char *end = 0;
+    std::string json;
+    uint64_t id = 0;
+    fid[0] = 0;
+    if ((mg_get_var(conn, "fid", fid, sizeof(fid)) > 0) && ISDIGIT(fid[0])) {
+        errno = 0;
+        id = strtoull(fid, &end, 10);
+        if (errno == ERANGE)
+            end = 0;
+    }
+    if (!end || *end || !id) {
+        // missing, not a number, too big, or trailing junk - not a flight ID
+        const char *msg = "{\"error\":\"track.json needs ?fid=<flight ID>\"}\n";
+        mg_send_status(conn, 400);
+        mg_send_header(conn,"Content-Type","application/json");
+        if (send_exta_hdrs)
+            send_extra_headers(conn);
+        mg_send_data(conn,msg,(int)strlen(msg));
+        if (VERB2) SPRTF("%s: Bad track request, fid '%s'\n", module, fid);
+        return MG_TRUE;
+    }
+    int cnt = tracks_get_json(id, json);
+    mg_send_header(conn,"Content-Type","application/json");
+    if (send_exta_hdrs)
+        send_extra_headers(conn);
+    mg_send_data(conn,json.c_str(),(int)json.size());
+    if (VERB2) SPRTF("%s: Sent track of %s, %d points, len %d\n", module, fid, cnt, (int)json.size());
+    return MG_TRUE;
+}
+
+// Counters, and latency histograms, as Prometheus text. The packet and
+// HTTP counts are kept by this same thread, and the histograms are summed
+// over the per thread blocks of cf_metrics, so the hot path takes no lock
+static int sendMetrics(struct mg_connection *conn)
+{
+    std::string out;
+    char lab[64];
+    int i, live, expired;
+    size_t early, compare, failed;
+    struct mg_conn_stats cs;
+    PPKTSTR pps = Get_Pkt_Str();
+    met_write_head(out, "cf_packets_total", "counter", "Packets dealt with, by type.");
+    for (i = 0; i < pkt_Max; i++) {
+        sprintf(lab, "type=\"%s\"", pps[i].desc);
+        met_write_value(out, "cf_packets_total", lab, (double)pps[i].count);
+    }
+    Get_Discard_Counts(&early, &compare, &failed);
+    met_write_head(out, "cf_discards_total", "counter", "Position packets discarded as no change, by where decided.");
+    met_write_value(out, "cf_discards_total", "reason=\"early\"", (double)early);
+    met_write_value(out, "cf_discards_total", "reason=\"compare\"", (double)compare);
+    met_write_head(out, "cf_failed_packets_total", "counter", "Packets that failed to decode.");
+    met_write_value(out, "cf_failed_packets_total", 0, (double)failed);
+    Get_Pilot_Counts(&live, &expired);
+    met_write_head(out, "cf_pilots", "gauge", "Pilots in the list.");
+    met_write_value(out, "cf_pilots", "state=\"live\"", (double)live);
+    met_write_value(out, "cf_pilots", "state=\"expired\"", (double)expired);
+    met_write_head(out, "cf_http_requests_total", "counter", "HTTP requests, by URI.");
+    met_write_value(out, "cf_http_requests_total", "uri=\"/info\"", (double)info_cnt);
+    met_write_value(out, "cf_http_requests_total", "uri=\"/flights.json\"", (double)json_cnt);
+    met_write_value(out, "cf_http_requests_total", "uri=\"/flights.xml\"", (double)xml_cnt);
+    met_write_value(out, "cf_http_requests_total", "uri=\"/track.json\"", (double)track_cnt);
+    met_write_value(out, "cf_http_requests_total", "uri=\"/metrics\"", (double)metrics_cnt);
+    met_write_value(out, "cf_http_requests_total", "uri=\"other\"", (double)other_cnt);
+    mg_get_conn_stats(server, &cs);
+    met_write_head(out, "cf_http_connections", "gauge", "Active HTTP connections.");
+    met_write_value(out, "cf_http_connections", 0, (double)cs.active);
+    met_write(out);     // the decode and feed build histograms
+    mg_send_header(conn,"Content-Type","text/plain; version=0.0.4");
+    mg_send_data(conn,out.c_str(),(int)out.size());
+    if (VERB2) SPRTF("%s: Sent metrics, len %d\n", module, (int)out.size());
+    return MG_TRUE;
+}
+
 static int event_handler(struct mg_connection *conn, enum mg_event ev) 
 {
     int iret = MG_FALSE;
@@ -365,6 +657,11 @@ static int event_handler(struct mg_connection *conn, enum mg_event ev)
         return MG_TRUE;   // Authorize all requests
     } else if (ev == MG_REQUEST) {
         http_cnt++;
+        add_request_rate();
+        // connection_param counts the requests on each connection
+        conn->connection_param = (char *)conn->connection_param + 1;
+        if (conn->connection_param != (void *)1)
+            reuse_cnt++;
         if (VERB5) {
             SPRTF("%s: got URI %s%s%s\n", module,
                 conn->uri,q,
@@ -390,7 +687,14 @@ static int event_handler(struct mg_connection *conn, enum mg_event ev)
         } else if (strcmp(conn->uri,"/flights.xml") == 0) {
             xml_cnt++;
             iret = sendXML(conn);
+        } else if (strcmp(conn->uri,"/track.json") == 0) {
+            track_cnt++;
+            iret = sendTrack(conn);
+        } else if (strcmp(conn->uri,"/metrics") == 0) {
+            metrics_cnt++;
+            iret = sendMetrics(conn);
         } else {
+            other_cnt++;
             // iret = sendFile(conn);
         }
     }
@@ -411,7 +715,6 @@ static int event_handler(struct mg_connection *conn, enum mg_event ev)
 #endif
 
 static char server_name[64];        // Set by init_server_name()
-static struct mg_server *server;    // Set by start_mongoose()
 
 void send_extra_headers(struct mg_connection *conn)
 {
@@ -449,11 +752,19 @@ int http_init( const char *addr, int port, mg_handler_t handler )
         SPRTF("%s: Failed to set listening port %u - %s!\n", module, port, msg);
         return 1;
     }
+    sprintf(tmp,"%d",max_conns);
+    mg_set_option(server, "max_connections", tmp);
+    sprintf(tmp,"%d",idle_secs);
+    mg_set_option(server, "idle_timeout_seconds", tmp);
+    sprintf(tmp,"%u",(unsigned)out_max_kb * 1024);
+    mg_set_option(server, "max_send_buffer", tmp);
 
     // there is NO document root here mg_get_option(server, "document_root")
     SPRTF("%s: %s on port %s\n", module,
          server_name, 
          mg_get_option(server, "listening_port"));
+    SPRTF("%s: Limits %d connections, %d secs idle, %d KB output per connection (0 for none)\n", module,
+        max_conns, idle_secs, out_max_kb);
 
     return 0;
 }
@@ -483,21 +794,30 @@ void show_stats()
     show_packets();
     clean_up_pilots(false);
     show_http_stats();
+    pacer_show_stats();
+    model_show_stats();
+    tracker_show_stats();
+    tracks_show_stats();
+    met_show_stats();
 }
 //////////////////////////////////////////////////////////////////////////////////
 int run_server()
 {
     int res, iret = 0;
-    time_t diff, next, curr = time(0);
+    time_t diff, next, curr;
+    clock_tick();
+    curr = clock_now();
     time_t pilot_ttl = m_PlayerExpires;
     time_t last_expire = curr;
     time_t last_json = curr;
     next = curr;
     bool need_reset = false;
     time_t reset_time = 0;
+    double pace_sim = elapsed_sim_time;  // sim deadline of the next packet
     SPRTF("%s: Waiting on %d... ESC to exit\n", module, port );
     while (1) {
-        curr = time(0);
+        clock_tick();   // one clock read per loop, for all the packet code
+        curr = clock_now();
         res = test_for_input();
         if (res) {
             if (res == 0x1b) {
@@ -510,14 +830,22 @@ int run_server()
             }
         }
 
-        http_poll(timeout_ms);    // server->poll();
+        // poll http until just short of the next packet's deadline,
+        // then the pacer sleeps precisely to it
+        int poll_ms = timeout_ms;
+        if (use_sim_time2 && !need_reset) {
+            double elap;
+            if (get_next_elapsed(&elap) && (elap > pace_sim))
+                pace_sim = elap;
+            int ms = (int)(pacer_remaining(pace_sim) * 1000.0) - 1;
+            if (ms < poll_ms)
+                poll_ms = (ms > 0) ? ms : 0;
+        }
+        http_poll(poll_ms);    // server->poll();
 
         bool get_udp = true;
-        if (use_sim_time2 && got_sim_time) {
-            double secs = get_seconds() - raw_bgn_secs;
-            if (secs < elapsed_sim_time) {
-                get_udp = false;
-            }
+        if (use_sim_time2 && !need_reset) {
+            get_udp = (pacer_wait(pace_sim, 2) ? true : false);
         }
         if (get_udp) {
             // feed in next udp packet from raw log
@@ -527,6 +855,7 @@ int run_server()
                     need_reset = true;
                     reset_time = curr + pilot_ttl + 3;
                     got_sim_time = false;   // raw log restart, so restart sim timing
+                    pacer_reset();
                     clean_up_log(); // ensure current log is CLOSED
                     clean_up_pilots();  // remove ALL pilots from vector
                 }
@@ -546,7 +875,10 @@ int run_server()
         if (next != curr) {
             next = curr;
             // any one seconds tasks???
-            if (sleep_ms > 0) {
+            trace_flush();  // keep the pilot event journal current
+            // the pacer sleeps to each packet's deadline, so only sleep
+            // when there is none, like waiting to replay the log again
+            if ((sleep_ms > 0) && (!use_sim_time2 || need_reset)) {
                 SLEEP(sleep_ms);
             }
         }
@@ -563,12 +895,95 @@ int run_server()
                     break;
                 }
                 need_reset = false; // and should be good to go again
+                pace_sim = elapsed_sim_time;
             }
         }
     }
     return iret;
 }
 
+//////////////////////////////////////////////////////////////////////////////////
+// int run_fast()
+//
+// Push the whole raw log through Deal_With_Packet(), Expire_Pilots(),
+// Write_JSON() and Write_XML() as fast as possible. The clock is
+// driven from elapsed sim time, so expiry and feeds happen as they
+// would in a real time replay, then show the throughput, and the
+// time spent in each stage.
+//////////////////////////////////////////////////////////////////////////////////
+int run_fast()
+{
+    int key = 0;
+    size_t blk_cnt = 0;
+    time_t base, curr, last_expire, last_json;
+    time_t pilot_ttl = m_PlayerExpires;
+    double t1, t2, total, read_secs, expire_secs, json_secs, xml_secs;
+    size_t expire_cnt, json_cnt;
+    read_secs = expire_secs = json_secs = xml_secs = 0.0;
+    expire_cnt = json_cnt = 0;
+    clock_tick();
+    base = curr = last_expire = last_json = clock_now();
+    clock_set_virtual(base);
+    time_decode = true;
+    decode_secs = 0.0;
+    SPRTF("%s: Fast replay of '%s'... ESC to exit\n", module, raw_log );
+    double bgn = clock_mono();
+    while (1) {
+        t1 = clock_mono();
+        if (!get_next_block())
+            break;
+        t2 = clock_mono();
+        read_secs += t2 - t1;
+        blk_cnt++;
+        clock_set_virtual_usecs(((uint64_t)base * 1000000) + (uint64_t)((elapsed_sim_time * 1000000.0) + 0.5));
+        curr = clock_now();
+        if ((curr - last_expire) > pilot_ttl) {
+            Expire_Pilots();
+            last_expire = curr;
+            t1 = clock_mono();
+            expire_secs += t1 - t2;
+            t2 = t1;
+            expire_cnt++;
+        }
+        if (last_json != curr) {
+            Write_JSON();
+            t1 = clock_mono();
+            json_secs += t1 - t2;
+            Write_XML();
+            xml_secs += clock_mono() - t1;
+            last_json = curr;
+            json_cnt++;
+        }
+        if ((blk_cnt & 0x3fff) == 0) {
+            key = test_for_input();
+            if (key == 0x1b) {
+                SPRTF("%s: Got ESC exit key...\n", module );
+                break;
+            }
+        }
+    }
+    total = clock_mono() - bgn;
+    time_decode = false;
+    clock_clear_virtual();
+    read_secs -= decode_secs;   // get_next_block() time, less decode
+    double mb = (double)raw_bytes_done / (1024.0 * 1024.0);
+    SPRTF("%s: Fast replay of %d packets, %.3f MB, %d sim secs, in %s\n", module,
+        (int)packet_cnt, mb, (int)elapsed_sim_time, get_seconds_stg(total));
+    if (total > 0.0) {
+        SPRTF("%s: Throughput %.0f packets/s, %.3f MB/s, x%.1f real time\n", module,
+            (double)packet_cnt / total, mb / total, elapsed_sim_time / total);
+        SPRTF("%s: Stage read %.3f s (%.1f%%), decode %.3f s (%.1f%%), expire %.3f s (%.1f%%) in %d,\n", module,
+            read_secs, read_secs * 100.0 / total,
+            decode_secs, decode_secs * 100.0 / total,
+            expire_secs, expire_secs * 100.0 / total, (int)expire_cnt);
+        SPRTF("%s: json %.3f s (%.1f%%), xml %.3f s (%.1f%%) in %d\n", module,
+            json_secs, json_secs * 100.0 / total,
+            xml_secs, xml_secs * 100.0 / total, (int)json_cnt);
+    }
+    packet_stats();
+    return (key == 0x1b) ? 1 : 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////
 int server_main( int argc, char **argv )
 {
@@ -585,6 +1000,11 @@ int server_main( int argc, char **argv )
     if (iret)
         return iret;
 
+    if (fast_replay) {
+        iret = run_fast();
+        return iret;
+    }
+
     SPRTF("%s: Starting HTTP server using mongoose version %s, on port %d\n", module, MONGOOSE_VERSION,
         port );
 
@@ -595,6 +1015,7 @@ int server_main( int argc, char **argv )
 
     run_server();
 
+    show_stats();
     http_close();
 
     return iret;
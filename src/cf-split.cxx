@@ -0,0 +1,608 @@
+/*\
+ * cf-split.cxx
+ *
+ * Copyright (c) 2014 - Geoff R. McLane
+ * Licence: GNU GPL version 2
+ *
+\*/
+/*\
+ * Cut a raw log of FGFS mp packets down to those wanted, by time window,
+ * callsign, message id, bounding box, or model, in constant memory.
+ * The log is read in SPLIT_CHUNK_SIZE pieces, each split into packets, and
+ * filtered, on its own thread, as each chunk owns the packets starting
+ * in it. The chunks are then taken in order, for the filters that need
+ * the whole history - the arrival time, estimated as in cf_rawscan.hxx,
+ * and the area and model of a callsign's non-position packets, which
+ * follow its last position. Runs of wanted packets are written straight
+ * from the chunk, or gathered in one SPLIT_OUT_BUF buffer.
+\*/
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <stdlib.h> // for atoi(), ...
+#include <string.h> // for strdup(), ...
+#include <stdint.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <thread>
+#include "sprtf.hxx"
+#include "cf_misc.hxx"
+#include "cf_clock.hxx"
+#include "fg_geometry.hxx"
+#include "mpMsgs.hxx"
+#include "cf_rawscan.hxx"
+#include "cf_reclog.hxx"
+#ifdef USE_BLOCK_LOG
+#include "cf_blklog.hxx"
+#endif
+
+#ifdef _WIN32
+#define split_fseek _fseeki64
+#else
+#define split_fseek fseeko
+#endif
+
+static const char *module = "cf-split";
+
+static int verbosity = 0;
+#define VERB1 (verbosity >= 1)
+#define VERB2 (verbosity >= 2)
+
+static const char *def_log = "tempcfsplit.txt";
+static const char *usr_input = 0;
+static const char *out_file = 0;
+static double from_secs = 0.0;      // arrival window, secs from the first packet
+static double to_secs = -1.0;       // none
+static uint64_t skip_pkts = 0;      // of those wanted, as split_raw_log_whole() begin
+static uint64_t num_pkts = 0;       // and count, 0 = all
+static std::set<std::string> sCallsigns;
+static std::set<uint32_t> sMsgIds;
+static bool use_box = false;
+static double box_lat1, box_lon1, box_lat2, box_lon2;
+static const char *model = 0;       // sub-string of the model path
+static int num_jobs = 0;            // threads, 0 = one per cpu
+
+#ifndef SPLIT_CHUNK_SIZE
+#define SPLIT_CHUNK_SIZE (8 << 20)   // file bytes per chunk
+#endif
+#ifndef SPLIT_OUT_BUF
+#define SPLIT_OUT_BUF   (4 << 20)   // output gathered to this
+#endif
+
+#define SP_OFF_MSGID    8       // T_MsgHdr MsgId
+#define SP_OFF_CS       24      // T_MsgHdr Callsign
+#define SP_OFF_MODEL    32      // T_PositionMsg Model
+#define SP_OFF_POS      144     // T_PositionMsg position[3]
+#define SP_POS_LEN      228     // T_MsgHdr and the T_PositionMsg kinematic block
+
+// SPLIT_PKT flags
+#define SP_WANT     0x01        // passes the callsign and message id filters
+#define SP_POS      0x02        // a position, which sets its callsign's state
+#define SP_AREA     0x04        // in the bounding box
+#define SP_MODEL    0x08        // model matches
+
+typedef struct tagSPLIT_PKT {
+    uint32_t offset;            // in the chunk buffer
+    uint32_t len;
+    uint32_t flags;             // SP_...
+}SPLIT_PKT, *PSPLIT_PKT;
+
+typedef struct tagSPLIT_CHUNK {
+    uint64_t start;             // file offset of the chunk
+    size_t own;                 // bytes in which a packet start belongs to this chunk
+    std::vector<uint8_t> buf;   // from start, with room for the last packet
+    std::vector<SPLIT_PKT> pkts;
+    uint64_t junk;              // bytes not in any packet
+    bool ok;
+}SPLIT_CHUNK, *PSPLIT_CHUNK;
+
+typedef std::vector<SPLIT_CHUNK> vSPLITCHUNK;
+
+// stats
+static uint64_t scan_pkts = 0, scan_bytes = 0, junk_bytes = 0;
+static uint64_t kept_pkts = 0, kept_bytes = 0;
+
+#ifndef ISDIGIT
+#define ISDIGIT(a) ((a >= '0') && (a <= '9'))
+#endif
+
+void give_help( char *name )
+{
+    printf("\n");
+    printf("Usage: date " CF_LOG_DATE " version " CF_LOG_VERSION "\n");
+    printf(" %s [options] raw-log\n", module);
+    printf("\n");
+    printf("Options:\n");
+    printf(" --help  (-h or -?) = This help and exit(0)\n");
+    printf(" --verb[n]     (-v) = Bump or set verbosity to n. (def=%d)\n", verbosity);
+    printf(" --out <file>  (-o) = Write the packets wanted to this raw log. Required.\n");
+    printf(" --from <secs> (-f) = Only packets arriving from secs after the first. (def=0)\n");
+    printf(" --to <secs>   (-t) = And before secs after the first. (def=end)\n");
+    printf(" --callsign <cs[,cs...]> (-c) = Only these callsigns. Can be repeated.\n");
+    printf(" --id <id[,id...]>  (-i) = Only these message ids, like %d position, %d chat.\n",
+        POS_DATA_ID, CHAT_MSG_ID);
+    printf(" --box <lat1,lon1,lat2,lon2> (-b) = Only pilots whose last position is in this box.\n");
+    printf(" --model <text> (-m) = Only pilots whose model path contains this text.\n");
+    printf(" --skip <n>    (-s) = Skip the first n packets wanted. (def=0)\n");
+    printf(" --num <n>     (-n) = Write at most n packets. (def=all)\n");
+    printf(" --jobs <n>    (-j) = Threads splitting chunks. (def=one per cpu)\n");
+    printf("\n");
+    printf("Description:\n");
+    printf(" Cut a raw log of FGFS mp packets down to those wanted, as a new raw log.\n");
+    printf(" All the filters given must pass. The times are estimated from each pilot's\n");
+    printf(" sim time, as for cf-server --at on a recording, so --from 300 cuts a raw log\n");
+    printf(" to what a replay --at 300 would see. A chat, or other non-position packet, is\n");
+    printf(" kept by --box and --model when its callsign's last position was.\n");
+    printf("\n");
+}
+
+static bool add_callsigns( const char *list )
+{
+    std::string s(list);
+    size_t bgn = 0, pos;
+    do {
+        pos = s.find(',', bgn);
+        std::string cs = s.substr(bgn, (pos == std::string::npos) ? pos : pos - bgn);
+        if (cs.empty() || (cs.size() > MAX_CALLSIGN_LEN))
+            return false;
+        sCallsigns.insert(cs);
+        bgn = pos + 1;
+    } while (pos != std::string::npos);
+    return true;
+}
+
+static bool add_msgids( const char *list )
+{
+    const char *cp = list;
+    while (*cp) {
+        if (!ISDIGIT(*cp))
+            return false;
+        sMsgIds.insert((uint32_t)atoi(cp));
+        while (ISDIGIT(*cp))
+            cp++;
+        if (*cp == ',')
+            cp++;
+    }
+    return !sMsgIds.empty();
+}
+
+int parse_args( int argc, char **argv )
+{
+    int i,i2,c;
+    char *arg, *sarg;
+    for (i = 1; i < argc; i++) {
+        arg = argv[i];
+        i2 = i + 1;
+        if (*arg == '-') {
+            sarg = &arg[1];
+            while (*sarg == '-')
+                sarg++;
+            c = *sarg;
+            switch (c) {
+            case 'h':
+            case '?':
+                give_help(argv[0]);
+                return 2;
+            case 'v':
+                verbosity++;
+                sarg++;
+                while (*sarg) {
+                    if (ISDIGIT(*sarg)) {
+                        verbosity = atoi(sarg);
+                        break;
+                    }
+                    if (*sarg == 'v')
+                        verbosity++;
+                    sarg++;
+                }
+                break;
+            case 'o':
+            case 'f':
+            case 't':
+            case 'c':
+            case 'i':
+            case 'b':
+            case 'm':
+            case 's':
+            case 'n':
+            case 'j':
+                if (i2 >= argc) {
+                    SPRTF("%s: Expected a value to follow '%s'!\n", module, arg);
+                    return 1;
+                }
+                i++;
+                sarg = argv[i];
+                if (c == 'o')
+                    out_file = strdup(sarg);
+                else if (c == 'f')
+                    from_secs = atof(sarg);
+                else if (c == 't')
+                    to_secs = atof(sarg);
+                else if (c == 'm')
+                    model = strdup(sarg);
+                else if (c == 's')
+                    skip_pkts = strtoull(sarg, 0, 10);
+                else if (c == 'n')
+                    num_pkts = strtoull(sarg, 0, 10);
+                else if (c == 'j')
+                    num_jobs = atoi(sarg);
+                else if (c == 'c') {
+                    if (!add_callsigns(sarg)) {
+                        SPRTF("%s: Bad callsign list '%s'!\n", module, sarg);
+                        return 1;
+                    }
+                } else if (c == 'i') {
+                    if (!add_msgids(sarg)) {
+                        SPRTF("%s: Bad message id list '%s'!\n", module, sarg);
+                        return 1;
+                    }
+                } else {
+                    if (sscanf(sarg, "%lf,%lf,%lf,%lf", &box_lat1, &box_lon1, &box_lat2, &box_lon2) != 4) {
+                        SPRTF("%s: Expected lat1,lon1,lat2,lon2, not '%s'!\n", module, sarg);
+                        return 1;
+                    }
+                    if (box_lat1 > box_lat2) {
+                        double tmp = box_lat1;
+                        box_lat1 = box_lat2;
+                        box_lat2 = tmp;
+                    }
+                    use_box = true;
+                }
+                break;
+            default:
+                SPRTF("%s: Unknown argument '%s'. Try -? for help...\n", module, arg);
+                return 1;
+            }
+        } else {
+            if (usr_input) {
+                SPRTF("%s: Already have input '%s'! What is this '%s'?\n", module, usr_input, arg );
+                return 1;
+            }
+            usr_input = strdup(arg);
+        }
+    }
+    if (!usr_input) {
+        SPRTF("%s: No raw log found in command!\n", module);
+        return 1;
+    }
+    if (!out_file) {
+        SPRTF("%s: No --out file given!\n", module);
+        return 1;
+    }
+    if ((to_secs >= 0.0) && (to_secs <= from_secs)) {
+        SPRTF("%s: --to %.1f is not after --from %.1f!\n", module, to_secs, from_secs);
+        return 1;
+    }
+    if (num_jobs <= 0) {
+        num_jobs = (int)std::thread::hardware_concurrency();
+        if (num_jobs <= 0)
+            num_jobs = 1;
+    }
+    return 0;
+}
+
+static inline uint32_t get_be32( const uint8_t *p )
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline double get_be_double( const uint8_t *p )
+{
+    uint64_t bits = ((uint64_t)get_be32(p) << 32) | get_be32(p + 4);
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+static bool in_box( const uint8_t *pkt )
+{
+    Point3D cart(get_be_double(pkt + SP_OFF_POS), get_be_double(pkt + SP_OFF_POS + 8),
+        get_be_double(pkt + SP_OFF_POS + 16));
+    Point3D geod;
+    sgCartToGeod(cart, geod);
+    double lat = geod[Lat], lon = geod[Lon];
+    if (!(lat >= box_lat1) || !(lat <= box_lat2))
+        return false;   // and NaN, from a zero position
+    if (box_lon1 <= box_lon2)
+        return (lon >= box_lon1) && (lon <= box_lon2);
+    return (lon >= box_lon1) || (lon <= box_lon2); // across the anti-meridian
+}
+
+// the filters that need only the packet
+static uint32_t packet_flags( const uint8_t *pkt, size_t len )
+{
+    uint32_t flags = SP_WANT;
+    uint32_t id = (len >= SP_OFF_CS) ? get_be32(pkt + SP_OFF_MSGID) : 0;
+    if (sMsgIds.size() && !sMsgIds.count(id))
+        flags = 0;
+    if (sCallsigns.size()) {
+        if (len < SP_OFF_CS + MAX_CALLSIGN_LEN)
+            flags = 0;
+        else {
+            const char *cs = (const char *)pkt + SP_OFF_CS;
+            std::string s(cs, strnlen(cs, MAX_CALLSIGN_LEN));
+            if (!sCallsigns.count(s))
+                flags = 0;
+        }
+    }
+    if ((id == POS_DATA_ID) && (len >= SP_POS_LEN) && (use_box || model)) {
+        flags |= SP_POS;
+        if (use_box && in_box(pkt))
+            flags |= SP_AREA;
+        if (model) {
+            char buf[MAX_MODEL_NAME_LEN + 1];
+            memcpy(buf, pkt + SP_OFF_MODEL, MAX_MODEL_NAME_LEN);
+            buf[MAX_MODEL_NAME_LEN] = 0;
+            if (strstr(buf, model))
+                flags |= SP_MODEL;
+        }
+    }
+    return flags;
+}
+
+// read the chunk, and split it into packets, on a worker thread
+static void scan_chunk( PSPLIT_CHUNK pc, uint64_t file_size )
+{
+    pc->pkts.clear();
+    pc->junk = 0;
+    pc->ok = false;
+    uint64_t want = pc->own + RAW_MAX_PACKET + 8;
+    if (pc->start + want > file_size)
+        want = file_size - pc->start;
+    size_t size = (size_t)want;
+    pc->buf.resize(size);
+    FILE *fp = fopen(usr_input, "rb");
+    if (!fp)
+        return;
+    setvbuf(fp, 0, _IONBF, 0);
+    if (split_fseek(fp, pc->start, SEEK_SET) || (fread(&pc->buf[0], 1, size, fp) != size)) {
+        fclose(fp);
+        return;
+    }
+    fclose(fp);
+    const uint8_t *bp = &pc->buf[0];
+    const uint8_t *cp = raw_find_magic(bp, bp + size);
+    size_t pos = cp ? (size_t)(cp - bp) : size;
+    if (pos > pc->own)
+        pos = pc->own;
+    if (!pc->start)
+        pc->junk = pos; // before the first magic, else in the last chunk's last packet
+    while (pos < pc->own) {
+        size_t lim = pos + RAW_MAX_PACKET;
+        if (lim > size)
+            lim = size;
+        const uint8_t *nx = raw_find_magic(bp + pos + 4, bp + lim);
+        size_t len = nx ? (size_t)(nx - bp) - pos : lim - pos;
+        SPLIT_PKT sp;
+        sp.offset = (uint32_t)pos;
+        sp.len = (uint32_t)len;
+        sp.flags = packet_flags(bp + pos, len);
+        pc->pkts.push_back(sp);
+        pos += len;
+        if (!nx && (pos < size)) {
+            // no magic in a maximum packet, skip to the next, which is
+            // also where the next chunk starts, if past this one
+            cp = raw_find_magic(bp + pos, bp + size);
+            size_t nxt = cp ? (size_t)(cp - bp) : size;
+            pc->junk += nxt - pos;
+            pos = nxt;
+        }
+    }
+    pc->ok = true;
+}
+
+typedef struct tagSPLIT_OUT {
+    FILE *fp;
+    std::vector<uint8_t> buf;
+    size_t used;
+}SPLIT_OUT, *PSPLIT_OUT;
+
+static int out_flush( PSPLIT_OUT po )
+{
+    if (po->used && (fwrite(&po->buf[0], 1, po->used, po->fp) != po->used)) {
+        SPRTF("%s: Failed to write '%s'!\n", module, out_file);
+        return 1;
+    }
+    po->used = 0;
+    return 0;
+}
+
+// a run of packets, contiguous in the chunk
+static int out_run( PSPLIT_OUT po, const uint8_t *bp, size_t len )
+{
+    if (!len)
+        return 0;
+    if (po->used + len > po->buf.size()) {
+        if (out_flush(po))
+            return 1;
+        if (len >= po->buf.size() / 2) {
+            if (fwrite(bp, 1, len, po->fp) != len) {
+                SPRTF("%s: Failed to write '%s'!\n", module, out_file);
+                return 1;
+            }
+            return 0;
+        }
+    }
+    memcpy(&po->buf[po->used], bp, len);
+    po->used += len;
+    return 0;
+}
+
+typedef std::map<std::string,uint32_t> mCSFLAGS;
+
+// the filters that need the history, in order. 0 to go on, 1 on error, 2 when done
+static int filter_chunk( PSPLIT_CHUNK pc, PSPLIT_OUT po, PRAW_PACER prp, mCSFLAGS &mState )
+{
+    const uint8_t *bp = &pc->buf[0];
+    bool timed = (from_secs > 0.0) || (to_secs >= 0.0);
+    uint64_t from = (uint64_t)(from_secs * 1000000.0);
+    uint64_t to = (to_secs >= 0.0) ? (uint64_t)(to_secs * 1000000.0) : 0;
+    size_t run_bgn = 0, run_end = 0, i, max = pc->pkts.size();
+    int iret = 0;
+    junk_bytes += pc->junk;
+    for (i = 0; i < max; i++) {
+        PSPLIT_PKT ps = &pc->pkts[i];
+        const uint8_t *pkt = bp + ps->offset;
+        uint32_t flags = ps->flags;
+        scan_pkts++;
+        scan_bytes += ps->len;
+        if (timed) {
+            uint64_t arrival = raw_pace_arrival(prp, pkt, ps->len);
+            if (to && (arrival >= to)) {
+                iret = 2;   // arrival never goes back
+                break;
+            }
+            if (arrival < from)
+                continue;
+        }
+        if ((use_box || model) && (ps->len >= SP_OFF_CS + MAX_CALLSIGN_LEN)) {
+            std::string cs((const char *)pkt + SP_OFF_CS, MAX_CALLSIGN_LEN);
+            if (flags & SP_POS)
+                mState[cs] = flags;
+            else {
+                mCSFLAGS::iterator it = mState.find(cs);
+                flags = (it == mState.end()) ? 0 : (flags & SP_WANT) | it->second;
+            }
+        }
+        if (!(flags & SP_WANT) || (use_box && !(flags & SP_AREA)) ||
+            (model && !(flags & SP_MODEL)))
+            continue;
+        if (skip_pkts) {
+            skip_pkts--;
+            continue;
+        }
+        if (ps->offset != run_end) {
+            if (out_run(po, bp + run_bgn, run_end - run_bgn))
+                return 1;
+            run_bgn = ps->offset;
+        }
+        run_end = ps->offset + ps->len;
+        kept_pkts++;
+        kept_bytes += ps->len;
+        if (num_pkts && (kept_pkts >= num_pkts)) {
+            iret = 2;
+            break;
+        }
+    }
+    if (out_run(po, bp + run_bgn, run_end - run_bgn))
+        return 1;
+    return iret;
+}
+
+static void start_batch( vSPLITCHUNK &batch, std::vector<std::thread> &workers,
+    uint64_t &next, uint64_t file_size )
+{
+    size_t i;
+    workers.clear();
+    for (i = 0; (i < batch.size()) && (next < file_size); i++) {
+        PSPLIT_CHUNK pc = &batch[i];
+        pc->start = next;
+        pc->own = (file_size - next < SPLIT_CHUNK_SIZE) ? (size_t)(file_size - next) : SPLIT_CHUNK_SIZE;
+        next += pc->own;
+        workers.push_back(std::thread(scan_chunk, pc, file_size));
+    }
+}
+
+static int split_log()
+{
+    struct stat sbuf;
+    int iret = 0;
+    if (stat(usr_input, &sbuf)) {
+        SPRTF("%s: Failed to stat '%s'!\n", module, usr_input);
+        return 1;
+    }
+    bool rec = reclog_is_rec(usr_input);
+#ifdef USE_BLOCK_LOG
+    rec |= blklog_is_blk(usr_input);
+#endif
+    if (rec) {
+        SPRTF("%s: '%s' is a recording, use raw-log --convert to get the raw log first!\n",
+            module, usr_input);
+        return 1;
+    }
+    uint64_t file_size = (uint64_t)sbuf.st_size;
+    SPLIT_OUT out;
+    out.fp = fopen(out_file, "wb");
+    if (!out.fp) {
+        SPRTF("%s: Failed to create '%s'!\n", module, out_file);
+        return 1;
+    }
+    out.buf.resize(SPLIT_OUT_BUF);
+    out.used = 0;
+    double bgn = get_seconds();
+    // two batches, one splitting while the other is filtered and written
+    vSPLITCHUNK batch[2];
+    std::vector<std::thread> workers[2];
+    batch[0].resize(num_jobs);
+    batch[1].resize(num_jobs);
+    RAW_PACER pacer;
+    pacer.clock = 0;
+    mCSFLAGS mState;
+    uint64_t next = 0;
+    int cur = 0;
+    size_t i;
+    start_batch(batch[cur], workers[cur], next, file_size);
+    while (workers[cur].size()) {
+        for (i = 0; i < workers[cur].size(); i++)
+            workers[cur][i].join();
+        if (!iret)
+            start_batch(batch[cur ^ 1], workers[cur ^ 1], next, file_size);
+        for (i = 0; !iret && (i < workers[cur].size()); i++) {
+            PSPLIT_CHUNK pc = &batch[cur][i];
+            if (!pc->ok) {
+                SPRTF("%s: Failed to read '%s' at %llu!\n", module, usr_input,
+                    (unsigned long long)pc->start);
+                iret = 1;
+                break;
+            }
+            iret = filter_chunk(pc, &out, &pacer, mState);
+            if (VERB2)
+                SPRTF("%s: Chunk at %llu, %d packets, kept %llu\n", module,
+                    (unsigned long long)pc->start, (int)pc->pkts.size(), (unsigned long long)kept_pkts);
+        }
+        workers[cur].clear();
+        cur ^= 1;
+        if (iret) {
+            for (i = 0; i < workers[cur].size(); i++)
+                workers[cur][i].join();
+            break;
+        }
+    }
+    if (iret == 2)
+        iret = 0;
+    if (out_flush(&out))
+        iret = 1;
+    if (fclose(out.fp)) {
+        SPRTF("%s: Failed to close '%s'!\n", module, out_file);
+        iret = 1;
+    }
+    double secs = get_seconds() - bgn;
+    SPRTF("%s: Kept %llu of %llu packets, %.3f of %.3f MB, to '%s', in %.3f secs, %.1f MB/s, %d jobs\n",
+        module, (unsigned long long)kept_pkts, (unsigned long long)scan_pkts,
+        (double)kept_bytes / 1048576.0, (double)scan_bytes / 1048576.0, out_file, secs,
+        (secs > 0.0) ? ((double)scan_bytes / 1048576.0) / secs : 0.0, num_jobs);
+    if (junk_bytes)
+        SPRTF("%s: Skipped %llu bytes not in a packet\n", module, (unsigned long long)junk_bytes);
+    return iret;
+}
+
+// main() OS entry
+int main( int argc, char **argv )
+{
+    int iret;
+    set_log_file((char *)def_log, false);
+    iret = parse_args(argc,argv);
+    if (iret) {
+        if (iret == 2)
+            iret = 0;
+        return iret;
+    }
+    iret = split_log();
+    return iret;
+}
+
+// eof = cf-split.cxx
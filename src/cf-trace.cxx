@@ -0,0 +1,219 @@
+/*\
+ * cf-trace.cxx
+ *
+ * Copyright (c) 2014 - Geoff R. McLane
+ * Licence: GNU GPL version 2
+ *
+\*/
+/*\
+ * Read a binary pilot event journal, written by cf-log or raw-log
+ * using the --journal option, and render it as text or csv
+\*/
+
+#include <stdio.h>
+#include <stdlib.h> // for atoi(), ...
+#include <string.h> // for strdup(), ...
+#include "sprtf.hxx"
+#include "cf_misc.hxx"
+#include "cf_trace.hxx"
+
+static const char *module = "cf-trace";
+
+static int verbosity = 0;
+#define VERB1 (verbosity >= 1)
+
+static const char *def_log = "tempcftrace.txt";
+static const char *usr_input = 0;
+static const char *out_file = 0;
+static bool out_csv = false;
+
+#ifndef ISDIGIT
+#define ISDIGIT(a) ((a >= '0') && (a <= '9'))
+#endif
+
+void give_help( char *name )
+{
+    printf("\n");
+    printf("Usage: date " CF_LOG_DATE " version " CF_LOG_VERSION "\n");
+    printf(" %s [options] journal\n", module);
+    printf("\n");
+    printf("Options:\n");
+    printf(" --help  (-h or -?) = This help and exit(0)\n");
+    printf(" --verb[n]     (-v) = Bump or set verbosity to n. (def=%d)\n", verbosity);
+    printf(" --csv         (-c) = Output csv, with a header line. (def=text)\n");
+    printf(" --out <file>  (-o) = Write output to this file. (def=stdout)\n");
+    printf("\n");
+    printf("Description:\n");
+    printf(" Render the binary pilot event journal written by cf-log or raw-log --journal <file>.\n");
+    printf("\n");
+}
+
+int parse_args( int argc, char **argv )
+{
+    int i,i2,c;
+    char *arg, *sarg;
+    for (i = 1; i < argc; i++) {
+        arg = argv[i];
+        i2 = i + 1;
+        if (*arg == '-') {
+            sarg = &arg[1];
+            while (*sarg == '-')
+                sarg++;
+            c = *sarg;
+            switch (c) {
+            case 'h':
+            case '?':
+                give_help(argv[0]);
+                return 2;
+            case 'v':
+                verbosity++;
+                sarg++;
+                while (*sarg) {
+                    if (ISDIGIT(*sarg)) {
+                        verbosity = atoi(sarg);
+                        break;
+                    }
+                    if (*sarg == 'v')
+                        verbosity++;
+                    sarg++;
+                }
+                break;
+            case 'c':
+                out_csv = true;
+                break;
+            case 'o':
+                if (i2 < argc) {
+                    i++;
+                    out_file = strdup(argv[i]);
+                } else {
+                    SPRTF("%s: Expected output file to follow '%s'!\n", module, arg);
+                    return 1;
+                }
+                break;
+            default:
+                SPRTF("%s: Unknown argument '%s'. Try -? for help...\n", module, arg);
+                return 1;
+            }
+        } else {
+            if (usr_input) {
+                SPRTF("%s: Already have input '%s'! What is this '%s'?\n", module, usr_input, arg );
+                return 1;
+            }
+            usr_input = strdup(arg);
+        }
+    }
+    if (!usr_input) {
+        SPRTF("%s: No journal file found in command!\n", module);
+        return 1;
+    }
+    return 0;
+}
+
+static void show_record( FILE *out, PCF_TRACE_REC pr )
+{
+    char cs[CF_TRACE_CS_LEN+1];
+    char fid[32];
+    memcpy(cs,pr->callsign,CF_TRACE_CS_LEN);
+    cs[CF_TRACE_CS_LEN] = 0;
+    set_epoch_id_stg( fid, pr->flight_id );
+    if (out_csv) {
+        fprintf(out,"%s,%lf,%s,%s,%s,%s,%d,%f,%f,%d,%d,%d\n",
+            get_epoch_id_stg(pr->epoch_usecs),
+            pr->sim_time,
+            fid,
+            cs,
+            trace_event_stg(pr->event),
+            trace_reason_stg(pr->reason),
+            pr->value,
+            pr->lat, pr->lon,
+            (int)(pr->alt + 0.5),
+            (int)(pr->speed + 0.5),
+            (int)pr->heading );
+    } else {
+        fprintf(out,"%s %s %s", get_epoch_id_stg(pr->epoch_usecs),
+            trace_event_stg(pr->event), cs );
+        if (pr->reason)
+            fprintf(out," %s=%d", trace_reason_stg(pr->reason), pr->value);
+        else if (pr->event != tev_New)
+            fprintf(out," %d", pr->value);
+        fprintf(out," at %f,%f,%d, hdg=%d spd=%d t=%lf s. fid=%s\n",
+            pr->lat, pr->lon,
+            (int)(pr->alt + 0.5),
+            (int)pr->heading,
+            (int)(pr->speed + 0.5),
+            pr->sim_time,
+            fid );
+    }
+}
+
+static int process_journal()
+{
+    CF_TRACE_HDR hdr;
+    static CF_TRACE_REC recs[1024];
+    size_t rd, ii, count = 0;
+    int iret = 0;
+    FILE *out = stdout;
+    FILE *fp = fopen(usr_input,"rb");
+    if (!fp) {
+        SPRTF("%s: Failed to open '%s'!\n", module, usr_input);
+        return 1;
+    }
+    rd = fread(&hdr,1,sizeof(hdr),fp);
+    if ((rd != sizeof(hdr)) || memcmp(hdr.magic,CF_TRACE_MAGIC,4)) {
+        SPRTF("%s: File '%s' is not a pilot event journal!\n", module, usr_input);
+        fclose(fp);
+        return 1;
+    }
+    if ((hdr.version != CF_TRACE_VERSION) || (hdr.rec_size != sizeof(CF_TRACE_REC)) ||
+        (hdr.bom != CF_TRACE_BOM)) {
+        SPRTF("%s: Journal '%s' version %d, rec size %d, not supported by this version %d, size %d, or byte order!\n",
+            module, usr_input, (int)hdr.version, (int)hdr.rec_size,
+            CF_TRACE_VERSION, (int)sizeof(CF_TRACE_REC));
+        fclose(fp);
+        return 1;
+    }
+    if (out_file) {
+        out = fopen(out_file,"w");
+        if (!out) {
+            SPRTF("%s: Failed to create output '%s'!\n", module, out_file);
+            fclose(fp);
+            return 1;
+        }
+    }
+    if (out_csv)
+        fprintf(out,"epoch_usecs,sim_time,fid,callsign,event,reason,value,lat,lon,alt_ft,spd_kts,hdg\n");
+    while ((rd = fread(recs,sizeof(CF_TRACE_REC),1024,fp)) > 0) {
+        for (ii = 0; ii < rd; ii++)
+            show_record(out,&recs[ii]);
+        count += rd;
+    }
+    if (ferror(fp)) {
+        SPRTF("%s: Read error on '%s'!\n", module, usr_input);
+        iret = 1;
+    }
+    fclose(fp);
+    if (out != stdout)
+        fclose(out);
+    if (VERB1)
+        SPRTF("%s: Rendered %d records from '%s'\n", module, (int)count, usr_input);
+    return iret;
+}
+
+// main() OS entry
+int main( int argc, char **argv )
+{
+    int iret;
+    set_log_file((char *)def_log, false);
+    add_std_out(0); // keep stdout for the rendered output
+    iret = parse_args(argc,argv);
+    if (iret) {
+        if (iret == 2)
+            iret = 0;
+        return iret;
+    }
+    add_std_out(1);
+    iret = process_journal();
+    return iret;
+}
+
+// eof = cf-trace.cxx
@@ -0,0 +1,510 @@
+// cf_blklog.cxx
+// Block compressed, seekable, raw mp udp log - see cf_blklog.hxx
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <zlib.h>
+#include "sprtf.hxx"
+#include "cf_misc.hxx"
+#include "cf_clock.hxx"
+#include "cf_rawscan.hxx"
+#include "cf_blklog.hxx"
+
+static const char *mod_name = "cf_blklog";
+
+// block offsets are 64 bit, a long is not on Windows
+#ifdef _WIN32
+#define blk_fseek _fseeki64
+#define blk_ftell _ftelli64
+#else
+#define blk_fseek fseeko
+#define blk_ftell ftello
+#endif
+
+#define BLK_MAX_SPAN    3600000000ULL   // usecs a frame may span, for BLK_PKT_REC t_off
+#define BLK_SLACK       8   // decoders may peek past a bad packet, as in a raw log buffer
+
+// a decompressed frame
+typedef struct tagBLK_FRAME {
+    uint32_t frame;             // index
+    bool     bad;
+    std::vector<uint8_t> data;  // packet index, then the packets
+}BLK_FRAME, *PBLK_FRAME;
+
+typedef std::vector<BLK_INDEX_REC> vBLKINDEX;
+typedef std::deque<BLK_FRAME> dBLKFRAME;
+
+struct tagBLKLOG {
+    FILE *fp;
+    bool writing;
+    std::string file;
+    vBLKINDEX index;
+    // writing
+    std::vector<BLK_PKT_REC> pkts;
+    std::string raw;
+    std::vector<uint8_t> comp;
+    uint64_t t_first, t_last, offset;
+    // reading - the read-ahead thread fills the queue from next_frame
+    std::thread *reader;
+    std::mutex mtx;
+    std::condition_variable cv_space, cv_ready;
+    dBLKFRAME queue;
+    uint32_t next_frame;
+    bool stop, done;
+    BLK_FRAME cur;              // frame being read, and next packet in it
+    uint32_t cur_count, cur_pkt;
+    // stats
+    uint64_t packets, bytes_in, bytes_out;
+    double wait_secs, inflate_secs;
+};
+
+static void close_file( PBLKLOG pbl )
+{
+    if (pbl->fp)
+        fclose(pbl->fp);
+    pbl->fp = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////
+// writing
+PBLKLOG blklog_create( const char *file )
+{
+    FILE *fp = fopen(file, "wb");
+    if (!fp) {
+        SPRTF("%s: Failed to create '%s'!\n", mod_name, file);
+        return 0;
+    }
+    BLKLOG_HDR hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = BLKLOG_MAGIC;
+    hdr.version = BLKLOG_VERSION;
+    hdr.frame_size = BLK_FRAME_SIZE;
+    if (fwrite(&hdr, sizeof(hdr), 1, fp) != 1) {
+        SPRTF("%s: Failed to write '%s'!\n", mod_name, file);
+        fclose(fp);
+        return 0;
+    }
+    PBLKLOG pbl = new BLKLOG;
+    pbl->fp = fp;
+    pbl->writing = true;
+    pbl->file = file;
+    pbl->raw.reserve(BLK_FRAME_SIZE + RAW_MAX_PACKET);
+    pbl->t_first = pbl->t_last = 0;
+    pbl->offset = sizeof(hdr);
+    pbl->reader = 0;
+    pbl->packets = pbl->bytes_in = 0;
+    pbl->bytes_out = sizeof(hdr);
+    pbl->wait_secs = pbl->inflate_secs = 0.0;
+    return pbl;
+}
+
+static int write_frame( PBLKLOG pbl )
+{
+    size_t cnt = pbl->pkts.size();
+    if (!cnt)
+        return 0;
+    std::string &r = pbl->raw;
+    r.insert(0, (const char *)&pbl->pkts[0], cnt * sizeof(BLK_PKT_REC));
+    uLongf clen = compressBound((uLong)r.size());
+    pbl->comp.resize(clen);
+    if (compress2(&pbl->comp[0], &clen, (const Bytef *)r.data(), (uLong)r.size(),
+        BLK_ZLIB_LEVEL) != Z_OK) {
+        SPRTF("%s: Failed to compress frame %d!\n", mod_name, (int)pbl->index.size());
+        return 1;
+    }
+    BLK_FRAME_HDR fh;
+    fh.magic = BLK_FRAME_MAGIC;
+    fh.count = (uint32_t)cnt;
+    fh.clen = (uint32_t)clen;
+    fh.rlen = (uint32_t)r.size();
+    fh.t_first = pbl->t_first;
+    fh.t_last = pbl->t_last;
+    if ((fwrite(&fh, sizeof(fh), 1, pbl->fp) != 1) ||
+        (fwrite(&pbl->comp[0], 1, clen, pbl->fp) != clen)) {
+        SPRTF("%s: Failed to write frame %d!\n", mod_name, (int)pbl->index.size());
+        return 1;
+    }
+    BLK_INDEX_REC ir;
+    ir.offset = pbl->offset;
+    ir.count = fh.count;
+    ir.clen = fh.clen;
+    ir.rlen = fh.rlen;
+    ir.res = 0;
+    ir.t_first = fh.t_first;
+    ir.t_last = fh.t_last;
+    pbl->index.push_back(ir);
+    pbl->offset += sizeof(fh) + clen;
+    pbl->bytes_out += sizeof(fh) + clen;
+    pbl->pkts.clear();
+    r.clear();
+    return 0;
+}
+
+int blklog_write( PBLKLOG pbl, const char *packet, int len, uint64_t arrival )
+{
+    if (!pbl->writing || (len <= 0) || (len > RAW_MAX_PACKET))
+        return 1;
+    if (pbl->pkts.size() && ((pbl->raw.size() >= BLK_FRAME_SIZE) ||
+        (arrival < pbl->t_first) || (arrival - pbl->t_first >= BLK_MAX_SPAN))) {
+        if (write_frame(pbl))
+            return 1;
+    }
+    if (!pbl->pkts.size())
+        pbl->t_first = arrival;
+    BLK_PKT_REC pr;
+    pr.offset = (uint32_t)pbl->raw.size();
+    pr.t_off = (uint32_t)(arrival - pbl->t_first);
+    pbl->pkts.push_back(pr);
+    pbl->raw.append(packet, len);
+    pbl->t_last = arrival;
+    pbl->packets++;
+    pbl->bytes_in += len;
+    return 0;
+}
+
+static int write_index( PBLKLOG pbl )
+{
+    BLKLOG_TAIL tail;
+    tail.index = pbl->offset;
+    tail.frames = (uint32_t)pbl->index.size();
+    tail.magic = BLK_TAIL_MAGIC;
+    if ((tail.frames && (fwrite(&pbl->index[0], sizeof(BLK_INDEX_REC), tail.frames, pbl->fp) != tail.frames)) ||
+        (fwrite(&tail, sizeof(tail), 1, pbl->fp) != 1)) {
+        SPRTF("%s: Failed to write the index of '%s'!\n", mod_name, pbl->file.c_str());
+        return 1;
+    }
+    pbl->bytes_out += tail.frames * sizeof(BLK_INDEX_REC) + sizeof(tail);
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////
+// reading
+bool blklog_is_blk( const char *file )
+{
+    BLKLOG_HDR hdr;
+    FILE *fp = fopen(file, "rb");
+    if (!fp)
+        return false;
+    size_t rd = fread(&hdr, sizeof(hdr), 1, fp);
+    fclose(fp);
+    return (rd == 1) && (hdr.magic == BLKLOG_MAGIC);
+}
+
+// load the trailing index, or rebuild it from the frame headers
+static int load_index( PBLKLOG pbl )
+{
+    BLKLOG_TAIL tail;
+    FILE *fp = pbl->fp;
+    blk_fseek(fp, 0, SEEK_END);
+    uint64_t size = (uint64_t)blk_ftell(fp);
+    if ((size >= sizeof(BLKLOG_HDR) + sizeof(tail)) &&
+        !blk_fseek(fp, -(int64_t)sizeof(tail), SEEK_END) &&
+        (fread(&tail, sizeof(tail), 1, fp) == 1) &&
+        (tail.magic == BLK_TAIL_MAGIC) &&
+        (tail.index + (uint64_t)tail.frames * sizeof(BLK_INDEX_REC) + sizeof(tail) == size)) {
+        pbl->index.resize(tail.frames);
+        if (!tail.frames)
+            return 0;
+        if (!blk_fseek(fp, (int64_t)tail.index, SEEK_SET) &&
+            (fread(&pbl->index[0], sizeof(BLK_INDEX_REC), tail.frames, fp) == tail.frames))
+            return 0;
+        pbl->index.clear();
+    }
+    SPRTF("%s: No index in '%s', rebuilding it...\n", mod_name, pbl->file.c_str());
+    BLK_FRAME_HDR fh;
+    uint64_t off = sizeof(BLKLOG_HDR);
+    while (!blk_fseek(fp, (int64_t)off, SEEK_SET) && (fread(&fh, sizeof(fh), 1, fp) == 1) &&
+        (fh.magic == BLK_FRAME_MAGIC) && (off + sizeof(fh) + fh.clen <= size)) {
+        BLK_INDEX_REC ir;
+        ir.offset = off;
+        ir.count = fh.count;
+        ir.clen = fh.clen;
+        ir.rlen = fh.rlen;
+        ir.res = 0;
+        ir.t_first = fh.t_first;
+        ir.t_last = fh.t_last;
+        pbl->index.push_back(ir);
+        off += sizeof(fh) + fh.clen;
+    }
+    return 0;
+}
+
+// read, and decompress, a frame - on the read-ahead thread
+// returns the decompress secs
+static double load_frame( PBLKLOG pbl, uint32_t i, std::vector<uint8_t> &comp, PBLK_FRAME pf )
+{
+    PBLK_INDEX_REC pi = &pbl->index[i];
+    BLK_FRAME_HDR fh;
+    pf->frame = i;
+    pf->bad = true;
+    comp.resize(pi->clen);
+    if (blk_fseek(pbl->fp, (int64_t)pi->offset, SEEK_SET) ||
+        (fread(&fh, sizeof(fh), 1, pbl->fp) != 1) || (fh.magic != BLK_FRAME_MAGIC) ||
+        (fh.clen != pi->clen) || (fh.rlen != pi->rlen) || (fh.count != pi->count) ||
+        ((uint64_t)fh.count * sizeof(BLK_PKT_REC) > fh.rlen) ||
+        (fread(&comp[0], 1, fh.clen, pbl->fp) != fh.clen))
+        return 0.0;
+    double t1 = clock_mono();
+    uLongf rlen = fh.rlen;
+    pf->data.resize((size_t)fh.rlen + BLK_SLACK);
+    if ((uncompress(&pf->data[0], &rlen, &comp[0], fh.clen) == Z_OK) && (rlen == fh.rlen))
+        pf->bad = false;
+    return clock_mono() - t1;
+}
+
+static void read_ahead( PBLKLOG pbl )
+{
+    std::vector<uint8_t> comp;
+    uint32_t i = pbl->next_frame;
+    uint32_t frames = (uint32_t)pbl->index.size();
+    for ( ; i < frames; i++) {
+        BLK_FRAME bf;
+        double secs = load_frame(pbl, i, comp, &bf);
+        std::unique_lock<std::mutex> lock(pbl->mtx);
+        pbl->inflate_secs += secs;
+        while (!pbl->stop && (pbl->queue.size() >= BLK_READ_AHEAD))
+            pbl->cv_space.wait(lock);
+        if (pbl->stop)
+            break;
+        pbl->queue.push_back(BLK_FRAME());
+        pbl->queue.back().frame = bf.frame;
+        pbl->queue.back().bad = bf.bad;
+        pbl->queue.back().data.swap(bf.data);
+        pbl->cv_ready.notify_one();
+        if (bf.bad)
+            break;
+    }
+    std::lock_guard<std::mutex> lock(pbl->mtx);
+    pbl->done = true;
+    pbl->cv_ready.notify_one();
+}
+
+static void start_reader( PBLKLOG pbl, uint32_t frame )
+{
+    pbl->next_frame = frame;
+    pbl->stop = pbl->done = false;
+    pbl->queue.clear();
+    pbl->cur.data.clear();
+    pbl->cur_count = pbl->cur_pkt = 0;
+    pbl->reader = new std::thread(read_ahead, pbl);
+}
+
+static void stop_reader( PBLKLOG pbl )
+{
+    if (!pbl->reader)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(pbl->mtx);
+        pbl->stop = true;
+        pbl->cv_space.notify_one();
+    }
+    pbl->reader->join();
+    delete pbl->reader;
+    pbl->reader = 0;
+    pbl->queue.clear();
+}
+
+PBLKLOG blklog_open( const char *file )
+{
+    BLKLOG_HDR hdr;
+    FILE *fp = fopen(file, "rb");
+    if (!fp) {
+        SPRTF("%s: Failed to open '%s'!\n", mod_name, file);
+        return 0;
+    }
+    if ((fread(&hdr, sizeof(hdr), 1, fp) != 1) || (hdr.magic != BLKLOG_MAGIC)) {
+        SPRTF("%s: '%s' is not a block compressed log!\n", mod_name, file);
+        fclose(fp);
+        return 0;
+    }
+    if (hdr.version != BLKLOG_VERSION) {
+        SPRTF("%s: '%s' is version %d, not %d!\n", mod_name, file, hdr.version, BLKLOG_VERSION);
+        fclose(fp);
+        return 0;
+    }
+    PBLKLOG pbl = new BLKLOG;
+    pbl->fp = fp;
+    pbl->writing = false;
+    pbl->file = file;
+    pbl->reader = 0;
+    pbl->packets = pbl->bytes_in = pbl->bytes_out = 0;
+    pbl->wait_secs = pbl->inflate_secs = 0.0;
+    load_index(pbl);
+    start_reader(pbl, 0);
+    return pbl;
+}
+
+// move on to the next frame, from the read-ahead queue
+static int next_frame( PBLKLOG pbl )
+{
+    double t1 = clock_mono();
+    std::unique_lock<std::mutex> lock(pbl->mtx);
+    while (pbl->queue.empty() && !pbl->done)
+        pbl->cv_ready.wait(lock);
+    pbl->wait_secs += clock_mono() - t1;
+    if (pbl->queue.empty())
+        return 0;   // end
+    BLK_FRAME &bf = pbl->queue.front();
+    pbl->cur.frame = bf.frame;
+    pbl->cur.bad = bf.bad;
+    pbl->cur.data.swap(bf.data);
+    pbl->queue.pop_front();
+    pbl->cv_space.notify_one();
+    if (pbl->cur.bad) {
+        SPRTF("%s: Bad frame %d in '%s'!\n", mod_name, (int)pbl->cur.frame, pbl->file.c_str());
+        return -1;
+    }
+    pbl->cur_count = pbl->index[pbl->cur.frame].count;
+    pbl->cur_pkt = 0;
+    pbl->bytes_in += pbl->index[pbl->cur.frame].clen;
+    return 1;
+}
+
+int blklog_read( PBLKLOG pbl, char **ppacket, uint64_t *parrival )
+{
+    int res;
+    if (pbl->writing)
+        return -1;
+    while (pbl->cur_pkt >= pbl->cur_count) {
+        res = next_frame(pbl);
+        if (res <= 0)
+            return res;
+    }
+    PBLK_INDEX_REC pi = &pbl->index[pbl->cur.frame];
+    PBLK_PKT_REC pr = (PBLK_PKT_REC)&pbl->cur.data[0];
+    size_t base = pbl->cur_count * sizeof(BLK_PKT_REC);
+    size_t rlen = pi->rlen - base;
+    uint32_t i = pbl->cur_pkt++;
+    size_t off = pr[i].offset;
+    size_t end = (i + 1 < pbl->cur_count) ? pr[i + 1].offset : rlen;
+    if ((end <= off) || (end > rlen)) {
+        SPRTF("%s: Bad packet index %d in frame %d!\n", mod_name, (int)i, (int)pbl->cur.frame);
+        return -1;
+    }
+    *ppacket = (char *)&pbl->cur.data[base + off];
+    if (parrival)
+        *parrival = pi->t_first + pr[i].t_off;
+    pbl->packets++;
+    pbl->bytes_out += end - off;
+    return (int)(end - off);
+}
+
+int blklog_seek( PBLKLOG pbl, double secs )
+{
+    if (pbl->writing || pbl->index.empty())
+        return 1;
+    uint64_t target = pbl->index[0].t_first + (uint64_t)(secs * 1000000.0);
+    uint32_t lo = 0, hi = (uint32_t)pbl->index.size();
+    while (hi - lo > 1) {   // last frame starting at or before the target
+        uint32_t mid = (lo + hi) / 2;
+        if (pbl->index[mid].t_first <= target)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    stop_reader(pbl);
+    start_reader(pbl, lo);
+    int res = next_frame(pbl);
+    if (res <= 0)
+        return 1;
+    PBLK_PKT_REC pr = (PBLK_PKT_REC)&pbl->cur.data[0];
+    uint64_t t_first = pbl->index[pbl->cur.frame].t_first;
+    while ((pbl->cur_pkt < pbl->cur_count) && (t_first + pr[pbl->cur_pkt].t_off < target))
+        pbl->cur_pkt++;
+    return 0;
+}
+
+double blklog_duration( PBLKLOG pbl )
+{
+    if (pbl->index.empty())
+        return 0.0;
+    return (double)(pbl->index.back().t_last - pbl->index[0].t_first) / 1000000.0;
+}
+
+void blklog_show_stats( PBLKLOG pbl )
+{
+    if (pbl->writing) {
+        SPRTF("%s: Written %d packets, %.3f MB, in %d frames, %.3f MB, x%.1f\n", mod_name,
+            (int)pbl->packets, (double)pbl->bytes_in / (1024.0 * 1024.0), (int)pbl->index.size(),
+            (double)pbl->bytes_out / (1024.0 * 1024.0),
+            pbl->bytes_out ? (double)pbl->bytes_in / (double)pbl->bytes_out : 0.0);
+    } else {
+        SPRTF("%s: Read %d packets, %.3f MB, from %.3f MB, inflate %.3f s, waited %.3f s\n", mod_name,
+            (int)pbl->packets, (double)pbl->bytes_out / (1024.0 * 1024.0),
+            (double)pbl->bytes_in / (1024.0 * 1024.0), pbl->inflate_secs, pbl->wait_secs);
+    }
+}
+
+void blklog_close( PBLKLOG pbl )
+{
+    if (!pbl)
+        return;
+    if (pbl->writing) {
+        if (!write_frame(pbl))
+            write_index(pbl);
+    } else
+        stop_reader(pbl);
+    close_file(pbl);
+    delete pbl;
+}
+
+/////////////////////////////////////////////////////////////////////////
+// converters
+static int write_cb( const char *packet, int len, uint64_t arrival, void *vp )
+{
+    return blklog_write((PBLKLOG)vp, packet, len, arrival);
+}
+
+int blklog_from_raw( const char *raw, const char *blk )
+{
+    double bgn = get_seconds();
+    PBLKLOG pbl = blklog_create(blk);
+    if (!pbl)
+        return 1;
+    int iret = raw_scan_file(raw, write_cb, pbl);
+    if (write_frame(pbl) || write_index(pbl))
+        iret = 1;
+    blklog_show_stats(pbl);
+    SPRTF("%s: Wrote '%s' in %s\n", mod_name, blk, get_seconds_stg(get_seconds() - bgn));
+    close_file(pbl);
+    delete pbl;
+    return iret;
+}
+
+int blklog_to_raw( const char *blk, const char *raw )
+{
+    int len, iret = 0;
+    char *packet;
+    double bgn = get_seconds();
+    PBLKLOG pbl = blklog_open(blk);
+    if (!pbl)
+        return 1;
+    FILE *fp = fopen(raw, "wb");
+    if (!fp) {
+        SPRTF("%s: Failed to create '%s'!\n", mod_name, raw);
+        blklog_close(pbl);
+        return 1;
+    }
+    while ((len = blklog_read(pbl, &packet, 0)) > 0) {
+        if (fwrite(packet, 1, len, fp) != (size_t)len) {
+            SPRTF("%s: Failed to write '%s'!\n", mod_name, raw);
+            iret = 1;
+            break;
+        }
+    }
+    if (len < 0)
+        iret = 1;
+    fclose(fp);
+    blklog_show_stats(pbl);
+    SPRTF("%s: Wrote '%s' in %s\n", mod_name, raw, get_seconds_stg(get_seconds() - bgn));
+    blklog_close(pbl);
+    return iret;
+}
+
+// eof - cf_blklog.cxx
@@ -0,0 +1,94 @@
+// cf_blklog.hxx
+// Block compressed, seekable, raw mp udp log
+// The packets of a raw log are gathered into frames of about
+// BLK_FRAME_SIZE bytes, each compressed on its own with zlib, so a
+// reader can start at any frame, and a trailing index of the frames
+// lets it find the one holding a time offset -
+//   BLKLOG_HDR
+//   frames - BLK_FRAME_HDR, then the compressed count BLK_PKT_REC, and
+//            the packets, back to back, as in the raw log
+//   BLK_INDEX_REC per frame
+//   BLKLOG_TAIL
+// Times are the arrival usecs from the first packet, estimated for a raw
+// log, see cf_rawscan.hxx. A background thread reads, and decompresses,
+// up to BLK_READ_AHEAD frames ahead of blklog_read().
+// Without a tail, as when the writer did not finish, the index is
+// rebuilt from the frame headers.
+#ifndef _CF_BLKLOG_HXX_
+#define _CF_BLKLOG_HXX_
+#include <stdint.h>
+
+#define BLKLOG_MAGIC    0x5A424643  // "CFBZ"
+#define BLKLOG_VERSION  1
+#define BLK_FRAME_MAGIC 0x4D524642  // "BFRM"
+#define BLK_TAIL_MAGIC  0x49424643  // "CFBI"
+#ifndef BLK_FRAME_SIZE
+#define BLK_FRAME_SIZE  (1 << 20)   // packet bytes per frame, about
+#endif
+#ifndef BLK_ZLIB_LEVEL
+#define BLK_ZLIB_LEVEL  1           // Z_BEST_SPEED - level 6 is 4x slower, for a few %
+#endif
+#ifndef BLK_READ_AHEAD
+#define BLK_READ_AHEAD  2           // frames decompressed ahead
+#endif
+
+// file header - 16 bytes
+typedef struct tagBLKLOG_HDR {
+    uint32_t magic;         // BLKLOG_MAGIC
+    uint16_t version;       // BLKLOG_VERSION
+    uint16_t flags;         // 0
+    uint32_t frame_size;    // BLK_FRAME_SIZE when written
+    uint32_t res;
+}BLKLOG_HDR, *PBLKLOG_HDR;
+
+// frame header - 32 bytes
+typedef struct tagBLK_FRAME_HDR {
+    uint32_t magic;         // BLK_FRAME_MAGIC
+    uint32_t count;         // packets
+    uint32_t clen;          // compressed bytes that follow
+    uint32_t rlen;          // when uncompressed - packet index and packets
+    uint64_t t_first;       // arrival usecs of the first and last packets
+    uint64_t t_last;
+}BLK_FRAME_HDR, *PBLK_FRAME_HDR;
+
+// packet index, inside each frame - 8 bytes
+typedef struct tagBLK_PKT_REC {
+    uint32_t offset;        // of the packet, after the packet index
+    uint32_t t_off;         // arrival usecs after t_first
+}BLK_PKT_REC, *PBLK_PKT_REC;
+
+// frame index - 40 bytes
+typedef struct tagBLK_INDEX_REC {
+    uint64_t offset;        // of the BLK_FRAME_HDR
+    uint32_t count, clen, rlen, res;
+    uint64_t t_first, t_last;
+}BLK_INDEX_REC, *PBLK_INDEX_REC;
+
+// 16 bytes, at the end of the file
+typedef struct tagBLKLOG_TAIL {
+    uint64_t index;         // offset of the first BLK_INDEX_REC
+    uint32_t frames;
+    uint32_t magic;         // BLK_TAIL_MAGIC
+}BLKLOG_TAIL, *PBLKLOG_TAIL;
+
+typedef struct tagBLKLOG BLKLOG, *PBLKLOG;
+
+extern bool blklog_is_blk( const char *file );      // has a BLKLOG_HDR
+extern PBLKLOG blklog_create( const char *file );
+extern int blklog_write( PBLKLOG pbl, const char *packet, int len, uint64_t arrival );  // 0 = success
+extern PBLKLOG blklog_open( const char *file );     // and start the read-ahead
+// returns the packet length, and points at the packet, valid to the next
+// read, 0 at the end, or -1 on a bad frame. arrival is usecs, if wanted
+extern int blklog_read( PBLKLOG pbl, char **ppacket, uint64_t *parrival );
+// the next read is the first packet at, or after, secs from the first
+extern int blklog_seek( PBLKLOG pbl, double secs ); // 0 = success
+extern double blklog_duration( PBLKLOG pbl );       // secs, first to last packet
+extern void blklog_show_stats( PBLKLOG pbl );
+extern void blklog_close( PBLKLOG pbl );    // writes the last frame and index, and frees
+
+// converters, 0 = success
+extern int blklog_from_raw( const char *raw, const char *blk );
+extern int blklog_to_raw( const char *blk, const char *raw );
+
+#endif // #ifndef _CF_BLKLOG_HXX_
+// eof - cf_blklog.hxx
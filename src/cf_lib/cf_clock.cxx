@@ -0,0 +1,153 @@
+// cf_clock.cxx
+// Time sources for the packet loop - see cf_clock.hxx
+// In unix the coarse clocks are read from the vDSO at tick resolution,
+// typically 1-4 ms, which is ample for second based expiry and feeds.
+
+#ifdef _MSC_VER
+#include <Windows.h>
+#include <sys/timeb.h> // _timeb & _ftime()
+#else
+#include <sys/time.h>
+#endif
+#include <time.h>
+#include "cf_clock.hxx"
+
+#ifdef _MSC_VER
+#define MY_CLOCK_COARSE_REAL 0
+#define MY_CLOCK_COARSE_MONO 0
+#else // !_MSC_VER
+#ifdef CLOCK_REALTIME_COARSE
+#define MY_CLOCK_COARSE_REAL CLOCK_REALTIME_COARSE
+#else
+#define MY_CLOCK_COARSE_REAL CLOCK_REALTIME
+#endif
+#ifdef CLOCK_MONOTONIC_COARSE
+#define MY_CLOCK_COARSE_MONO CLOCK_MONOTONIC_COARSE
+#else
+#define MY_CLOCK_COARSE_MONO CLOCK_MONOTONIC
+#endif
+#endif // _MSC_VER y/n
+
+static time_t coarse_now = 0;
+static uint64_t coarse_usecs = 0;
+static double coarse_mono = 0.0;
+static bool done_tick = false;
+static bool use_virtual = false;
+
+#ifdef _MSC_VER
+void clock_tick()
+{
+    if (use_virtual)
+        return;
+    coarse_usecs = clock_epoch_usecs();
+    coarse_now = (time_t)(coarse_usecs / 1000000);
+    coarse_mono = (double)GetTickCount64() / 1000.0;
+    done_tick = true;
+}
+
+static double mono_secs()
+{
+    static double dfreq = 0.0;
+    LARGE_INTEGER counter;
+    if (dfreq == 0.0) {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency( &frequency );
+        dfreq = (double)frequency.QuadPart;
+    }
+    QueryPerformanceCounter( &counter );
+    return (double)counter.QuadPart / dfreq;
+}
+
+uint64_t clock_mono_nsecs()
+{
+    return (uint64_t)(mono_secs() * 1000000000.0);
+}
+
+uint64_t clock_epoch_usecs()
+{
+    struct _timeb tb;
+    _ftime(&tb);
+    return ((uint64_t)tb.time * 1000000) + ((uint64_t)tb.millitm * 1000);
+}
+
+#else // !_MSC_VER
+void clock_tick()
+{
+    struct timespec ts;
+    if (use_virtual)
+        return;
+    clock_gettime(MY_CLOCK_COARSE_REAL, &ts);
+    coarse_now = ts.tv_sec;
+    coarse_usecs = ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+    clock_gettime(MY_CLOCK_COARSE_MONO, &ts);
+    coarse_mono = (double)ts.tv_sec + ((double)ts.tv_nsec / 1000000000.0);
+    done_tick = true;
+}
+
+uint64_t clock_mono_nsecs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+}
+
+uint64_t clock_epoch_usecs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+#endif // _MSC_VER y/n
+
+void clock_set_virtual_usecs( uint64_t usecs )
+{
+    coarse_usecs = usecs;
+    coarse_now = (time_t)(usecs / 1000000);
+    done_tick = true;
+    use_virtual = true;
+}
+
+void clock_set_virtual( time_t secs )
+{
+    clock_set_virtual_usecs((uint64_t)secs * 1000000);
+}
+
+void clock_clear_virtual()
+{
+    use_virtual = false;
+    clock_tick();
+}
+
+time_t clock_now()
+{
+    if (!done_tick)
+        clock_tick();
+    return coarse_now;
+}
+
+uint64_t clock_now_usecs()
+{
+    if (!done_tick)
+        clock_tick();
+    return coarse_usecs;
+}
+
+double clock_coarse_mono()
+{
+    if (!done_tick)
+        clock_tick();
+    return coarse_mono;
+}
+
+double clock_mono()
+{
+#ifdef _MSC_VER
+    return mono_secs();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1000000000.0);
+#endif
+}
+
+// eof - cf_clock.cxx
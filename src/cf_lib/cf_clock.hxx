@@ -0,0 +1,25 @@
+// cf_clock.hxx
+// Time sources for the packet loop
+// clock_tick() refreshes a cached coarse wall time and coarse monotonic
+// time, once per loop iteration, so per packet code can read them
+// without a system call. clock_mono*() are precise monotonic sources,
+// for pacing and latency measurement, immune to wall clock jumps.
+#ifndef _CF_CLOCK_HXX_
+#define _CF_CLOCK_HXX_
+#include <stdint.h>
+#include <time.h>
+
+extern void clock_tick();           // refresh the cached coarse times
+extern time_t clock_now();          // cached epoch seconds, as at last tick
+extern uint64_t clock_now_usecs();  // cached epoch micro-seconds, as at last tick
+extern double clock_coarse_mono();  // cached monotonic seconds, as at last tick
+extern double clock_mono();         // precise monotonic seconds
+extern uint64_t clock_mono_nsecs(); // precise monotonic nano-seconds
+extern uint64_t clock_epoch_usecs(); // precise epoch micro-seconds
+// fast-forward replay drives clock_now*() from sim time instead
+extern void clock_set_virtual( time_t secs ); // clock_now*() return this, tick does nothing
+extern void clock_set_virtual_usecs( uint64_t usecs ); // the same, to the micro-second
+extern void clock_clear_virtual();          // back to the real coarse clock
+
+#endif // #ifndef _CF_CLOCK_HXX_
+// eof - cf_clock.hxx
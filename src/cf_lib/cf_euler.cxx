@@ -56,7 +56,7 @@ inline double cf_dot_prod( Point3D &p1, Point3D &p2 )
     return p1.GetX()*p2.GetX() + p1.GetY()*p2.GetY() + p1.GetZ()*p2.GetZ();
 }
 
-inline double cf_norm( Point3D &p3d ) { return sqrt(cf_dot_prod(p3d, p3d)); }
+double cf_norm( Point3D &p3d ) { return sqrt(cf_dot_prod(p3d, p3d)); }
 
 /* ==============================================================
 sub euler_get($$$$$$$$) {
@@ -0,0 +1,334 @@
+// cf_metrics.cxx
+// Counters and latency histograms, scraped as Prometheus text - see cf_metrics.hxx
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include "sprtf.hxx"
+#include "cf_metrics.hxx"
+
+static const char *mod_name = "cf_metrics";
+
+#define MT_COUNTER  0
+#define MT_HIST     1
+#define MET_HIST_SLOTS  (MET_HIST_BUCKETS + 1)  // the buckets, and the sum
+#define MET_OVERFLOW    (MET_HIST_BUCKETS - 1)
+#define MET_QUANTILES   3
+
+static const double quantile[MET_QUANTILES] = { 0.5, 0.99, 0.999 };
+static const char *quantile_stg[MET_QUANTILES] = { "0.5", "0.99", "0.999" };
+
+typedef struct tagMET_DEF {
+    std::string name, labels, help;
+    int type;
+    int slot;           // first slot
+}MET_DEF, *PMET_DEF;
+
+// one per recording thread, never freed, so the counts of a finished
+// thread are still in the sums
+typedef struct tagMET_SHARD {
+    std::atomic<uint64_t> slot[MET_MAX_SLOTS];
+}MET_SHARD, *PMET_SHARD;
+
+static std::mutex met_mtx;
+static std::vector<MET_DEF> vMetDefs;
+static std::vector<PMET_SHARD> vShards;
+static int next_slot = 0;
+static thread_local PMET_SHARD my_shard = 0;
+
+static PMET_SHARD get_shard()
+{
+    if (!my_shard) {
+        PMET_SHARD ps = new MET_SHARD;
+        int i;
+        for (i = 0; i < MET_MAX_SLOTS; i++)
+            ps->slot[i].store(0, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(met_mtx);
+        vShards.push_back(ps);
+        my_shard = ps;
+    }
+    return my_shard;
+}
+
+// only this thread writes its shard, so no read-modify-write is needed
+static inline void bump( PMET_SHARD ps, int slot, uint64_t n )
+{
+    std::atomic<uint64_t> &a = ps->slot[slot];
+    a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+static int add_def( const char *name, const char *labels, const char *help, int type, int slots )
+{
+    std::lock_guard<std::mutex> lock(met_mtx);
+    if (next_slot + slots > MET_MAX_SLOTS) {
+        SPRTF("%s: No slots left for '%s'! Increase MET_MAX_SLOTS\n", mod_name, name);
+        return -1;
+    }
+    MET_DEF md;
+    md.name = name;
+    md.labels = labels ? labels : "";
+    md.help = help;
+    md.type = type;
+    md.slot = next_slot;
+    next_slot += slots;
+    vMetDefs.push_back(md);
+    return md.slot;     // the id
+}
+
+int met_counter_new( const char *name, const char *labels, const char *help )
+{
+    return add_def(name, labels, help, MT_COUNTER, 1);
+}
+
+int met_hist_new( const char *name, const char *labels, const char *help )
+{
+    return add_def(name, labels, help, MT_HIST, MET_HIST_SLOTS);
+}
+
+void met_counter_add( int id, uint64_t n )
+{
+    if (id >= 0)
+        bump(get_shard(), id, n);
+}
+
+// buckets hold up to, and including, their upper bound
+static inline int get_bucket( uint64_t nsecs )
+{
+    uint64_t w = nsecs ? nsecs - 1 : 0;
+    uint64_t v = w >> MET_MIN_BITS;
+    int o = -1;
+    if (!v)
+        return 0;
+    while (v) {
+        o++;
+        v >>= 1;
+    }
+    if (o >= MET_BUCKETS)
+        return MET_OVERFLOW;
+    return 1 + (o * MET_SUBS) + (int)((w >> (o + MET_MIN_BITS - MET_SUB_BITS)) & (MET_SUBS - 1));
+}
+
+static uint64_t get_upper( int i )
+{
+    if (i == 0)
+        return MET_MIN_NSECS;
+    if (i >= MET_OVERFLOW)
+        return (uint64_t)MET_MIN_NSECS << MET_BUCKETS;  // at least
+    i--;
+    return (uint64_t)(MET_SUBS + (i % MET_SUBS) + 1) << ((i / MET_SUBS) + MET_MIN_BITS - MET_SUB_BITS);
+}
+
+void met_hist_add( int id, uint64_t nsecs )
+{
+    if (id < 0)
+        return;
+    PMET_SHARD ps = get_shard();
+    bump(ps, id + get_bucket(nsecs), 1);
+    bump(ps, id + MET_HIST_BUCKETS, nsecs);
+}
+
+// sum a slot over the threads, with the lock held
+static uint64_t sum_slot( int slot )
+{
+    uint64_t sum = 0;
+    size_t ii, max = vShards.size();
+    for (ii = 0; ii < max; ii++)
+        sum += vShards[ii]->slot[slot].load(std::memory_order_relaxed);
+    return sum;
+}
+
+static void get_hist( PMET_DEF pmd, PMET_HIST ph )
+{
+    int i;
+    ph->count = 0;
+    for (i = 0; i < MET_HIST_BUCKETS; i++) {
+        ph->bucket[i] = sum_slot(pmd->slot + i);
+        ph->count += ph->bucket[i];
+    }
+    ph->sum_nsecs = sum_slot(pmd->slot + MET_HIST_BUCKETS);
+}
+
+uint64_t met_hist_quantile( PMET_HIST ph, double q )
+{
+    uint64_t want, cum = 0;
+    int i;
+    if (!ph->count)
+        return 0;
+    want = (uint64_t)(q * (double)ph->count + 0.999999);
+    if (want < 1)
+        want = 1;
+    for (i = 0; i < MET_HIST_BUCKETS; i++) {
+        cum += ph->bucket[i];
+        if (cum >= want)
+            break;
+    }
+    return get_upper(i);
+}
+
+// the def of an id, with the lock held
+static PMET_DEF find_def( int id, int type )
+{
+    size_t ii, max = vMetDefs.size();
+    for (ii = 0; ii < max; ii++) {
+        if (vMetDefs[ii].slot == id)
+            return (vMetDefs[ii].type == type) ? &vMetDefs[ii] : 0;
+    }
+    return 0;
+}
+
+uint64_t met_counter_get( int id )
+{
+    std::lock_guard<std::mutex> lock(met_mtx);
+    PMET_DEF pmd = find_def(id, MT_COUNTER);
+    return pmd ? sum_slot(pmd->slot) : 0;
+}
+
+bool met_hist_get( int id, PMET_HIST ph )
+{
+    std::lock_guard<std::mutex> lock(met_mtx);
+    PMET_DEF pmd = find_def(id, MT_HIST);
+    if (!pmd)
+        return false;
+    get_hist(pmd, ph);
+    return true;
+}
+
+void met_write_head( std::string &out, const char *name, const char *type, const char *help )
+{
+    out += "# HELP ";
+    out += name;
+    out += " ";
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += " ";
+    out += type;
+    out += "\n";
+}
+
+void met_write_value( std::string &out, const char *name, const char *labels, double val )
+{
+    char tmp[64];
+    out += name;
+    if (labels && *labels) {
+        out += "{";
+        out += labels;
+        out += "}";
+    }
+    sprintf(tmp, " %.15g\n", val);
+    out += tmp;
+}
+
+static std::string add_label( PMET_DEF pmd, const char *label )
+{
+    return pmd->labels.size() ? pmd->labels + "," + label : std::string(label);
+}
+
+// the HDR buckets are summed to each doubling
+static void write_hist( std::string &out, PMET_DEF pmd, PMET_HIST ph )
+{
+    MET_HIST &h = *ph;
+    std::string name = pmd->name + "_bucket";
+    char le[64];
+    uint64_t cum = 0;
+    int i;
+    get_hist(pmd, &h);
+    for (i = 0; i < MET_HIST_BUCKETS; i++) {
+        cum += h.bucket[i];
+        if (i == MET_OVERFLOW)
+            strcpy(le, "le=\"+Inf\"");
+        else if ((i % MET_SUBS) == 0)
+            sprintf(le, "le=\"%.9g\"", (double)get_upper(i) / 1e9);
+        else
+            continue;
+        met_write_value(out, name.c_str(), add_label(pmd, le).c_str(), (double)cum);
+    }
+    met_write_value(out, (pmd->name + "_sum").c_str(), pmd->labels.c_str(), (double)h.sum_nsecs / 1e9);
+    met_write_value(out, (pmd->name + "_count").c_str(), pmd->labels.c_str(), (double)h.count);
+}
+
+// a histogram family is followed by a gauge family of its quantiles
+void met_write( std::string &out )
+{
+    std::lock_guard<std::mutex> lock(met_mtx);
+    size_t ii, jj, max = vMetDefs.size();
+    std::vector<bool> done(max, false);
+    std::vector<MET_HIST> hists;
+    std::vector<PMET_DEF> hdefs;
+    std::string qname;
+    char lab[32];
+    int i;
+    for (ii = 0; ii < max; ii++) {
+        if (done[ii])
+            continue;
+        PMET_DEF pmd = &vMetDefs[ii];
+        met_write_head(out, pmd->name.c_str(), (pmd->type == MT_HIST) ? "histogram" : "counter",
+            pmd->help.c_str());
+        // then the whole family
+        hists.clear();
+        hdefs.clear();
+        for (jj = ii; jj < max; jj++) {
+            PMET_DEF pmd2 = &vMetDefs[jj];
+            if (done[jj] || (pmd2->name != pmd->name))
+                continue;
+            done[jj] = true;
+            if (pmd2->type == MT_HIST) {
+                hists.resize(hists.size() + 1);
+                write_hist(out, pmd2, &hists.back());
+                hdefs.push_back(pmd2);
+            } else
+                met_write_value(out, pmd2->name.c_str(), pmd2->labels.c_str(), (double)sum_slot(pmd2->slot));
+        }
+        if (hdefs.empty())
+            continue;
+        qname = pmd->name + "_quantile";
+        met_write_head(out, qname.c_str(), "gauge", "Quantiles, as the upper bound of their HDR bucket.");
+        for (jj = 0; jj < hdefs.size(); jj++) {
+            for (i = 0; i < MET_QUANTILES; i++) {
+                sprintf(lab, "quantile=\"%s\"", quantile_stg[i]);
+                met_write_value(out, qname.c_str(), add_label(hdefs[jj], lab).c_str(),
+                    (double)met_hist_quantile(&hists[jj], quantile[i]) / 1e9);
+            }
+        }
+    }
+}
+
+static const char *get_nsecs_stg( uint64_t nsecs, char *buf )
+{
+    if (nsecs < 1000000)
+        sprintf(buf, "%.1f us", (double)nsecs / 1e3);
+    else if (nsecs < 1000000000)
+        sprintf(buf, "%.3f ms", (double)nsecs / 1e6);
+    else
+        sprintf(buf, "%.3f s", (double)nsecs / 1e9);
+    return buf;
+}
+
+void met_show_stats()
+{
+    std::lock_guard<std::mutex> lock(met_mtx);
+    size_t ii, max = vMetDefs.size();
+    MET_HIST h;
+    char b1[32], b2[32], b3[32], b4[32];
+    for (ii = 0; ii < max; ii++) {
+        PMET_DEF pmd = &vMetDefs[ii];
+        if (pmd->type != MT_HIST)
+            continue;
+        get_hist(pmd, &h);
+        if (!h.count)
+            continue;
+        SPRTF("%s: %s%s%s%s %llu, mean %s, p50 %s, p99 %s, p999 %s\n", mod_name, pmd->name.c_str(),
+            pmd->labels.size() ? "{" : "", pmd->labels.c_str(), pmd->labels.size() ? "}" : "",
+            (unsigned long long)h.count,
+            get_nsecs_stg(h.sum_nsecs / h.count, b1),
+            get_nsecs_stg(met_hist_quantile(&h, 0.5), b2),
+            get_nsecs_stg(met_hist_quantile(&h, 0.99), b3),
+            get_nsecs_stg(met_hist_quantile(&h, 0.999), b4));
+    }
+}
+
+// eof - cf_metrics.cxx
@@ -0,0 +1,52 @@
+// cf_metrics.hxx
+// Counters and latency histograms, scraped as Prometheus text
+// Each thread that records gets its own block of slots, through a
+// thread_local pointer, and is the only writer of them, so a record is a
+// relaxed load and store, with no lock, and no cache line shared with
+// another writer. A scrape sums the blocks of all the threads, under the
+// registry lock, which a recording thread only takes on its first record.
+// A histogram is HDR style, in nano-seconds - the first bucket is all up
+// to MET_MIN_NSECS, then each doubling, MET_BUCKETS of them, is split
+// into MET_SUBS linear buckets, so a quantile is within 1 / MET_SUBS,
+// then an overflow. Prometheus gets the buckets summed to each doubling,
+// and the quantiles.
+#ifndef _CF_METRICS_HXX_
+#define _CF_METRICS_HXX_
+#include <stdint.h>
+#include <string>
+
+#define MET_MAX_SLOTS   4096    // per thread, a counter takes 1, a histogram MET_HIST_BUCKETS + 1
+#define MET_BUCKETS     24      // doublings, 256 ns to 4.3 s
+#define MET_SUB_BITS    3
+#define MET_SUBS        (1 << MET_SUB_BITS)     // linear buckets per doubling
+#define MET_MIN_BITS    8
+#define MET_MIN_NSECS   (1 << MET_MIN_BITS)     // upper bound of the first bucket
+#define MET_HIST_BUCKETS (1 + MET_BUCKETS * MET_SUBS + 1)
+
+// register a metric, before its first record, and get its id, or -1 if out
+// of slots. Metrics of the same name, with different labels, like
+// 'feed="json"', are written as one family.
+extern int met_counter_new( const char *name, const char *labels, const char *help );
+extern int met_hist_new( const char *name, const char *labels, const char *help );
+// record, on the hot path - an id of -1 is ignored
+extern void met_counter_add( int id, uint64_t n );
+extern void met_hist_add( int id, uint64_t nsecs );
+// a histogram, summed over the threads
+typedef struct tagMET_HIST {
+    uint64_t bucket[MET_HIST_BUCKETS];  // the last is the overflow
+    uint64_t count, sum_nsecs;
+}MET_HIST, *PMET_HIST;
+extern uint64_t met_counter_get( int id );
+extern bool met_hist_get( int id, PMET_HIST ph );
+// the upper bound of the bucket holding quantile q, like 0.99, or 0 if empty
+extern uint64_t met_hist_quantile( PMET_HIST ph, double q );
+// append the Prometheus text of all the registered metrics
+extern void met_write( std::string &out );
+// append a metric family head, and a value, for values counted elsewhere
+extern void met_write_head( std::string &out, const char *name, const char *type, const char *help );
+extern void met_write_value( std::string &out, const char *name, const char *labels, double val );
+// the count, mean, p50, p99 and p999 of each histogram with a count
+extern void met_show_stats();
+
+#endif // #ifndef _CF_METRICS_HXX_
+// eof - cf_metrics.hxx
@@ -49,6 +49,7 @@
 #include <stdlib.h> // malloc() in unix
 #include "sprtf.hxx"    // GetNxtBuf()
 #include "cf_misc.hxx"
+#include "cf_clock.hxx"
 #include "typcnvt.hxx"
 
 static const char *mod_name = "cf_misc";
@@ -203,10 +204,7 @@ char *get_epoch_id_stg(uint64_t id)
 // get epoch time in usecs
 uint64_t get_epoch_usecs()
 {
-    struct timeval tv;
-    gettimeofday( &tv, 0 );
-    uint64_t id = ((tv.tv_sec * 1000000) + tv.tv_usec);
-    return id;
+    return clock_epoch_usecs();
 }
 
 ////////////////////////////////////////////////////////
@@ -219,7 +217,7 @@ uint64_t get_epoch_id()
 {
     static time_t prev = 0;
     static int eq_count = 0;
-    time_t curr = time(0);
+    time_t curr = clock_now();  // cached at the last clock_tick()
     if (curr == prev)
         eq_count++;
     else {
@@ -276,12 +274,10 @@ double get_seconds()
 }
 
 #else // !WIN32
+// monotonic, so elapsed times are immune to wall clock jumps
 double get_seconds()
 {
-    struct timeval tv;
-    gettimeofday(&tv,0);
-    double t1 = (double)(tv.tv_sec+((double)tv.tv_usec/1000000.0));
-    return t1;
+    return clock_mono();
 }
 #endif // WIN32 y/n
 
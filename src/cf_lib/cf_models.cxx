@@ -0,0 +1,148 @@
+// cf_models.cxx
+// Interned aircraft model table - see cf_models.hxx
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include "sprtf.hxx"
+#include "cf_models.hxx"
+
+static const char *mod_name = "cf_models";
+
+typedef struct tagMODEL_SLOT {
+    uint32_t hash;
+    int      id;    // display name id, -1 if slot empty
+    int      path;  // index into vPaths
+}MODEL_SLOT, *PMODEL_SLOT;
+
+#define MODEL_MIN_SLOTS 64  // power of 2, and kept under half full
+
+static std::vector<MODEL_SLOT> vSlots;      // open addressed, on path hash
+static std::vector<std::string> vPaths;     // each distinct raw path
+static std::vector<std::string> vNames;     // each distinct display name, by id
+static std::map<std::string,int> mNames;    // only used for a new path
+static size_t lookups = 0, probes = 0;
+
+// FNV-1a
+static uint32_t hash_path( const char *path, int len )
+{
+    uint32_t h = 2166136261u;
+    int i;
+    for (i = 0; i < len; i++) {
+        h ^= (uint8_t)path[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// As get_Model() did - remove leading PATH and trailing file extension
+static std::string strip_path( const char *path, int len )
+{
+    int i, bgn = 0, end = len;
+    for (i = 0; i < len; i++) {
+        if (path[i] == '/')
+            bgn = i + 1;
+    }
+    for (i = bgn; i < len; i++) {
+        if (path[i] == '.')
+            end = i;
+    }
+    return std::string(path + bgn, end - bgn);
+}
+
+static void grow_slots()
+{
+    size_t ii, max, size = vSlots.size() ? vSlots.size() * 2 : MODEL_MIN_SLOTS;
+    size_t mask = size - 1;
+    MODEL_SLOT empty = { 0, -1, -1 };
+    std::vector<MODEL_SLOT> old;
+    old.swap(vSlots);
+    vSlots.assign(size, empty);
+    max = old.size();
+    for (ii = 0; ii < max; ii++) {
+        PMODEL_SLOT ps = &old[ii];
+        if (ps->id < 0)
+            continue;
+        size_t i = ps->hash & mask;
+        while (vSlots[i].id >= 0)
+            i = (i + 1) & mask;
+        vSlots[i] = *ps;
+    }
+}
+
+int model_intern( const char *path, int max_len )
+{
+    int len = 0;
+    while ((len < max_len) && path[len])
+        len++;
+    uint32_t h = hash_path(path, len);
+    if (vSlots.empty())
+        grow_slots();
+    size_t mask = vSlots.size() - 1;
+    size_t i = h & mask;
+    PMODEL_SLOT ps;
+    lookups++;
+    for (;;) {
+        ps = &vSlots[i];
+        if (ps->id < 0)
+            break;
+        if (ps->hash == h) {
+            const std::string &s = vPaths[ps->path];
+            if ((s.size() == (size_t)len) && (memcmp(s.data(), path, len) == 0))
+                return ps->id;
+        }
+        probes++;
+        i = (i + 1) & mask;
+    }
+    // first sight of this path - is it a new display name?
+    std::string name = strip_path(path, len);
+    std::map<std::string,int>::iterator it = mNames.find(name);
+    int id;
+    if (it == mNames.end()) {
+        id = (int)vNames.size();
+        vNames.push_back(name);
+        mNames[name] = id;
+    } else {
+        id = it->second;
+    }
+    ps->hash = h;
+    ps->id   = id;
+    ps->path = (int)vPaths.size();
+    vPaths.push_back(std::string(path, len));
+    if ((vPaths.size() * 2) > vSlots.size())
+        grow_slots();
+    return id;
+}
+
+const char *model_name( int id )
+{
+    if ((id < 0) || (id >= (int)vNames.size()))
+        return "";
+    return vNames[id].c_str();
+}
+
+int model_count()
+{
+    return (int)vNames.size();
+}
+
+void model_show_stats()
+{
+    SPRTF("%s: %d model names, from %d paths, %d lookups, %.3f extra probes per lookup\n", mod_name,
+        (int)vNames.size(), (int)vPaths.size(), (int)lookups,
+        lookups ? (double)probes / (double)lookups : 0.0 );
+}
+
+void model_clear()
+{
+    vSlots.clear();
+    vPaths.clear();
+    vNames.clear();
+    mNames.clear();
+    lookups = probes = 0;
+}
+
+// eof - cf_models.cxx
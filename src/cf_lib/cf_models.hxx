@@ -0,0 +1,20 @@
+// cf_models.hxx
+// Interned aircraft model table
+// Maps the raw 'Model' path of a position packet, like
+// 'Aircraft/c172p/Models/c172p.xml', to a small integer id, one for
+// each distinct display name, the path less its directories and
+// extension, here 'c172p'. Each distinct path is parsed once, after
+// that it is found by hash, and pilots keep, and compare, just the id.
+// Not thread safe - intern only from the packet decode thread.
+#ifndef _CF_MODELS_HXX_
+#define _CF_MODELS_HXX_
+
+// path need not be zero terminated within max_len
+extern int model_intern( const char *path, int max_len );
+extern const char *model_name( int id ); // "" if not a valid id
+extern int model_count();   // distinct display names
+extern void model_show_stats();
+extern void model_clear();
+
+#endif // #ifndef _CF_MODELS_HXX_
+// eof - cf_models.hxx
@@ -0,0 +1,144 @@
+// cf_pacer.cxx
+// Replay pacing against sim time - see cf_pacer.hxx
+
+#ifdef _MSC_VER
+#include <Windows.h>
+#else
+#include <time.h>
+#include <errno.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+#include "sprtf.hxx"
+#include "cf_clock.hxx"
+#include "cf_pacer.hxx"
+
+static const char *mod_name = "cf_pacer";
+
+static double pace_speed = 1.0;
+static bool anchored = false;
+static double anchor_mono, anchor_sim;
+
+// pacing error stats - error is wake time minus deadline
+#define PACER_BINS 5
+static const double bin_limit[PACER_BINS-1] = { 0.0001, 0.001, 0.01, 0.1 };
+static const char *bin_desc[PACER_BINS] = { "<0.1ms", "<1ms", "<10ms", "<100ms", ">=100ms" };
+static size_t bin_count[PACER_BINS];
+static size_t pace_count = 0;   // deadlines met by sleeping
+static size_t pace_behind = 0;  // deadlines already past when checked
+static double err_total = 0.0, err_max = 0.0;
+
+void pacer_set_speed( double speed )
+{
+    if (speed < PACER_MIN_SPEED)
+        speed = PACER_MIN_SPEED;
+    if (speed > PACER_MAX_SPEED)
+        speed = PACER_MAX_SPEED;
+    pace_speed = speed;
+    anchored = false;
+}
+
+double pacer_get_speed()
+{
+    return pace_speed;
+}
+
+void pacer_reset()
+{
+    anchored = false;
+}
+
+static double get_deadline( double sim_secs )
+{
+    if (!anchored) {
+        anchor_mono = clock_mono();
+        anchor_sim = sim_secs;
+        anchored = true;
+    }
+    return anchor_mono + ((sim_secs - anchor_sim) / pace_speed);
+}
+
+double pacer_remaining( double sim_secs )
+{
+    return get_deadline(sim_secs) - clock_mono();
+}
+
+static void add_error( double err )
+{
+    int i;
+    if (err < 0.0)
+        err = 0.0;
+    for (i = 0; i < PACER_BINS - 1; i++) {
+        if (err < bin_limit[i])
+            break;
+    }
+    bin_count[i]++;
+    err_total += err;
+    if (err > err_max)
+        err_max = err;
+}
+
+// sleep until this monotonic time
+static void sleep_until( double mono )
+{
+#ifdef _MSC_VER
+    double secs = mono - clock_mono();
+    if (secs > 0.0)
+        Sleep((DWORD)(secs * 1000.0));
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)mono;
+    ts.tv_nsec = (long)((mono - (double)ts.tv_sec) * 1000000000.0);
+    if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, 0) == EINTR)
+        ;
+#endif
+}
+
+int pacer_wait( double sim_secs, int max_ms )
+{
+    double deadline = get_deadline(sim_secs);
+    double now = clock_mono();
+    double remain = deadline - now;
+    if (remain <= 0.0) {
+        if (remain < -0.001)
+            pace_behind++;
+        add_error(-remain);
+        return 1;
+    }
+    if (remain > ((double)max_ms / 1000.0)) {
+        if (max_ms > 0)
+            sleep_until(now + ((double)max_ms / 1000.0));
+        return 0;
+    }
+    sleep_until(deadline);
+    add_error(clock_mono() - deadline);
+    pace_count++;
+    return 1;
+}
+
+void pacer_show_stats()
+{
+    int i;
+    size_t cnt = 0;
+    for (i = 0; i < PACER_BINS; i++)
+        cnt += bin_count[i];
+    if (!cnt) {
+        SPRTF("%s: No paced packets, at speed %gx\n", mod_name, pace_speed);
+        return;
+    }
+    SPRTF("%s: Paced %d packets at speed %gx, %d slept to deadline, %d behind. Error avg %.3f ms, max %.3f ms\n",
+        mod_name, (int)cnt, pace_speed, (int)pace_count, (int)pace_behind,
+        (err_total * 1000.0) / (double)cnt,
+        err_max * 1000.0 );
+    char *tb = GetNxtBuf();
+    *tb = 0;
+    for (i = 0; i < PACER_BINS; i++)
+        sprintf(EndBuf(tb),"%s %d ", bin_desc[i], (int)bin_count[i]);
+    SPRTF("%s: Error spread %s\n", mod_name, tb);
+}
+
+// eof - cf_pacer.cxx
@@ -0,0 +1,22 @@
+// cf_pacer.hxx
+// Replay pacing against sim time
+// Maps sim seconds onto the monotonic clock, at a speed multiplier,
+// and sleeps to each packet's absolute deadline, so replay neither
+// oversleeps, nor spins. Keeps pacing error statistics.
+#ifndef _CF_PACER_HXX_
+#define _CF_PACER_HXX_
+
+#define PACER_MIN_SPEED 0.5
+#define PACER_MAX_SPEED 100.0
+
+extern void pacer_set_speed( double speed ); // clamped to MIN/MAX
+extern double pacer_get_speed();
+extern void pacer_reset();      // next deadline re-anchors the sim time line
+extern double pacer_remaining( double sim_secs ); // secs until this deadline, < 0 if past
+// If the deadline is within max_ms, sleep to it and return 1 (due),
+// else sleep max_ms and return 0
+extern int pacer_wait( double sim_secs, int max_ms );
+extern void pacer_show_stats();
+
+#endif // #ifndef _CF_PACER_HXX_
+// eof - cf_pacer.hxx
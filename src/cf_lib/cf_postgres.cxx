@@ -24,6 +24,10 @@ cf_postgres::cf_postgres()
     db_name = (char *)DEF_PG_DB;    // "tracker_test";
     db_opts = (char *)"";
     db_tty = (char *)"";
+    db_conninfo = 0;
+    pipeline_count = 0;
+    pipeline_errs = 0;
+    res = 0;
 
 }
 
@@ -45,7 +49,10 @@ cf_postgres::~cf_postgres()
 int cf_postgres::db_open(bool create)
 {
     int iret = 0;
-    conn = PQsetdbLogin(db_host, db_port, db_opts, db_tty, db_name, db_user, db_pwd);
+    if (db_conninfo)
+        conn = PQconnectdb(db_conninfo);
+    else
+        conn = PQsetdbLogin(db_host, db_port, db_opts, db_tty, db_name, db_user, db_pwd);
     if (!conn) {
         SPRTF("%s: ERROR: Connection to database failed due to memory!\n", mod_name);
         iret = 1;
@@ -130,8 +137,8 @@ int cf_postgres::db_exec(
                     if (sqlcb(vp,nFields,argv,cols))
                         break;  // end call backs
                 }
-                delete cols;
-                delete argv;
+                delete [] cols;
+                delete [] argv;
             }
             PQclear(res);
         } else {
@@ -148,4 +155,143 @@ int cf_postgres::db_exec(
     return iret;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// Bulk load
+// The caller sends the rows, already in the COPY binary format, in any
+// size of pieces, and copy_end() gets the COPY result
+//////////////////////////////////////////////////////////////////////////////
+int cf_postgres::copy_begin( const char *sql )
+{
+    if (db_ok()) {
+        SPRTF("%s: ERROR: Database is NOT connected!\n", mod_name);
+        return 1;
+    }
+    res = PQexec( conn, sql );
+    status = PQresultStatus(res);
+    PQclear(res);
+    if (status != PGRES_COPY_IN) {
+        SPRTF("%s: COPY (%s)\n FAILED:\n[%s]\n", mod_name, sql, PQerrorMessage(conn));
+        return 1;
+    }
+    return 0;
+}
+
+int cf_postgres::copy_data( const char *buf, int len )
+{
+    if (PQputCopyData( conn, buf, len ) != 1) {
+        SPRTF("%s: COPY data FAILED:\n[%s]\n", mod_name, PQerrorMessage(conn));
+        return 1;
+    }
+    return 0;
+}
+
+int cf_postgres::copy_end()
+{
+    int iret = 0;
+    if (PQputCopyEnd( conn, NULL ) != 1) {
+        SPRTF("%s: COPY end FAILED:\n[%s]\n", mod_name, PQerrorMessage(conn));
+        iret = 1;
+    }
+    while ((res = PQgetResult(conn)) != NULL) {
+        status = PQresultStatus(res);
+        if (status != PGRES_COMMAND_OK) {
+            SPRTF("%s: COPY FAILED:\n[%s]\n", mod_name, PQresultErrorMessage(res));
+            iret = 1;
+        }
+        PQclear(res);
+    }
+    return iret;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Prepared statements, pipelined
+// In pipeline mode each pipeline_send() is only queued, and they all go
+// to the server together, in pipeline_end(), for one round trip
+//////////////////////////////////////////////////////////////////////////////
+int cf_postgres::prepare( const char *name, const char *sql, int nparams )
+{
+    if (db_ok()) {
+        SPRTF("%s: ERROR: Database is NOT connected!\n", mod_name);
+        return 1;
+    }
+    res = PQprepare( conn, name, sql, nparams, NULL );
+    status = PQresultStatus(res);
+    PQclear(res);
+    if (status != PGRES_COMMAND_OK) {
+        SPRTF("%s: Prepare (%s)\n FAILED:\n[%s]\n", mod_name, sql, PQerrorMessage(conn));
+        return 1;
+    }
+    return 0;
+}
+
+int cf_postgres::pipeline_begin()
+{
+    pipeline_count = 0;
+    pipeline_errs = 0;
+#ifdef LIBPQ_HAS_PIPELINING
+    if (PQenterPipelineMode(conn) != 1) {
+        SPRTF("%s: Enter pipeline mode FAILED:\n[%s]\n", mod_name, PQerrorMessage(conn));
+        return 1;
+    }
+#endif
+    return 0;
+}
+
+int cf_postgres::pipeline_send( const char *name, int nparams, const char *const *values )
+{
+    pipeline_count++;
+#ifdef LIBPQ_HAS_PIPELINING
+    if (PQsendQueryPrepared( conn, name, nparams, values, NULL, NULL, 0 ) != 1) {
+        SPRTF("%s: Send (%s) FAILED:\n[%s]\n", mod_name, name, PQerrorMessage(conn));
+        pipeline_errs++;
+        return 1;
+    }
+#else // !LIBPQ_HAS_PIPELINING
+    res = PQexecPrepared( conn, name, nparams, values, NULL, NULL, 0 );
+    status = PQresultStatus(res);
+    PQclear(res);
+    if (status != PGRES_COMMAND_OK) {
+        SPRTF("%s: Exec (%s) FAILED:\n[%s]\n", mod_name, name, PQerrorMessage(conn));
+        pipeline_errs++;
+        return 1;
+    }
+#endif // LIBPQ_HAS_PIPELINING y/n
+    return 0;
+}
+
+int cf_postgres::pipeline_end()
+{
+#ifdef LIBPQ_HAS_PIPELINING
+    if (PQpipelineSync(conn) != 1) {
+        SPRTF("%s: Pipeline sync FAILED:\n[%s]\n", mod_name, PQerrorMessage(conn));
+        pipeline_errs++;
+    } else {
+        // each query gives its result, then a NULL, and last the sync
+        for (;;) {
+            res = PQgetResult(conn);
+            if (!res) {
+                if (PQstatus(conn) != CONNECTION_OK) {
+                    pipeline_errs++;
+                    break;
+                }
+                continue;
+            }
+            status = PQresultStatus(res);
+            if (status == PGRES_PIPELINE_SYNC) {
+                PQclear(res);
+                break;
+            }
+            if ((status != PGRES_COMMAND_OK) && (status != PGRES_TUPLES_OK)) {
+                if (status != PGRES_PIPELINE_ABORTED)   // after the first error
+                    SPRTF("%s: Pipeline query FAILED:\n[%s]\n", mod_name, PQresultErrorMessage(res));
+                pipeline_errs++;
+            }
+            PQclear(res);
+        }
+    }
+    PQexitPipelineMode(conn);
+#endif // LIBPQ_HAS_PIPELINING
+    return pipeline_errs ? 1 : 0;
+}
+
 // eof - cf_postgres.cxx
@@ -37,14 +37,30 @@ public:
     void set_db_user( char *user ) { db_user = strdup(user); }
     void set_db_pwd ( char *pwd  ) { db_pwd  = strdup(pwd);  }
     void set_db_opts( char *opts ) { db_opts = strdup(opts); }
+    // a libpq connection string, used in place of the above if set
+    void set_conninfo( const char *info ) { db_conninfo = strdup(info); }
     // create tables
     void set_ct_flights(char *sql) { ct_flights = sql;       }
     void set_ct_positions(char *sql) { ct_positions = sql;   }
 
+    // bulk load - COPY ... FROM STDIN, in binary format
+    int copy_begin( const char *sql );
+    int copy_data( const char *buf, int len );
+    int copy_end();
+    // prepared statements, sent in one pipeline, with one sync, where
+    // libpq has pipeline mode, else executed one by one
+    int prepare( const char *name, const char *sql, int nparams );
+    int pipeline_begin();
+    int pipeline_send( const char *name, int nparams, const char *const *values );
+    int pipeline_end(); // sync, and check every result
+    int pipeline_count;
+
     PGresult *res;
     ExecStatusType status;
 private:
     PGconn *conn;
+    char *db_conninfo;
+    int pipeline_errs;
     char *db_host;
     char *db_port;
     char *db_user;
@@ -0,0 +1,231 @@
+// cf_rawframe.cxx
+// Frame the packets of a raw mp udp log, and account for damage - see cf_rawframe.hxx
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include "sprtf.hxx"
+#include "mpMsgs.hxx"
+#include "cf_rawscan.hxx"
+#include "cf_readahead.hxx"
+#include "cf_rawframe.hxx"
+
+static const char *mod_name = "cf_rawframe";
+
+#define RF_LOOK     (RAW_MAX_PACKET + 8)    // the most looked ahead
+#define RF_HDR_LEN  32                      // T_MsgHdr
+#define RF_LEN_OFF  12                      // T_MsgHdr MsgLen
+
+struct tagRAWFRAME {
+    PREADAHEAD ra;
+    std::string file;
+    char *data;             // the read-ahead buffer
+    size_t pos, end;        // the next byte to frame, and end of the data
+    bool eof;
+    uint64_t base;          // file offset of data[0]
+    uint64_t last;          // of the last packet returned
+    int log_max, logged;
+    RAW_DAMAGE dam;
+};
+
+static const char *damage_stg[rd_Max] = {
+    "truncated",
+    "oversized",
+    "bad proto",
+    "padding",
+    "junk"
+};
+
+const char *raw_damage_stg( int rd )
+{
+    return ((rd >= 0) && (rd < rd_Max)) ? damage_stg[rd] : "unknown";
+}
+
+static inline uint32_t get_be32( const uint8_t *p )
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// have at least want bytes from pos, unless at the end of the log
+static int fill( PRAWFRAME prf, size_t want )
+{
+    while (!prf->eof && (prf->end - prf->pos < want)) {
+        char *data;
+        int len = ra_next(prf->ra, prf->data ? prf->data + prf->pos : 0, prf->end - prf->pos, &data);
+        if (len <= 0) {
+            prf->eof = true;
+            if (len < 0)
+                return 1;
+            break;
+        }
+        prf->base += prf->pos;
+        prf->data = data;
+        prf->end = len;
+        prf->pos = 0;
+    }
+    return 0;
+}
+
+static void damage( PRAWFRAME prf, int rd, size_t len )
+{
+    uint64_t off = prf->base + prf->pos;
+    PRAW_DAMAGE pd = &prf->dam;
+    if (!pd->count[rd])
+        pd->first[rd] = off;
+    pd->count[rd]++;
+    pd->lost[rd] += len;
+    if (prf->logged < prf->log_max) {
+        prf->logged++;
+        SPRTF("%s: %s, %d bytes, at offset %llu of '%s'\n", mod_name, damage_stg[rd],
+            (int)len, (unsigned long long)off, prf->file.c_str());
+    }
+    prf->pos += len;
+}
+
+static inline bool is_magic( const uint8_t *bp )
+{
+    uint32_t magic = get_be32(bp);
+    return (magic == MSG_MAGIC) || (magic == RELAY_MAGIC);
+}
+
+// bytes from bp to the next magic, of any version, so it is classified
+// on its own, looking no more than RF_LOOK ahead
+static size_t next_magic( PRAWFRAME prf, const uint8_t *bp, size_t from, size_t avail )
+{
+    size_t lim = (avail < RF_LOOK) ? avail : RF_LOOK;
+    size_t i;
+    prf->dam.resyncs++;
+    for (i = from; i + 4 <= lim; i++) {
+        if (((bp[i] == 'S') || (bp[i] == 'F')) && is_magic(bp + i))
+            return i;
+    }
+    return (lim == avail) ? avail : RAW_MAX_PACKET;
+}
+
+PRAWFRAME rawframe_open( const char *file, int log_max )
+{
+    PREADAHEAD ra = ra_open(file, 0);
+    if (!ra)
+        return 0;
+    PRAWFRAME prf = new RAWFRAME;
+    prf->ra = ra;
+    prf->file = file;
+    prf->data = 0;
+    prf->pos = prf->end = 0;
+    prf->eof = false;
+    prf->base = prf->last = 0;
+    prf->log_max = log_max;
+    prf->logged = 0;
+    memset(&prf->dam, 0, sizeof(prf->dam));
+    return prf;
+}
+
+int rawframe_next( PRAWFRAME prf, char **ppacket )
+{
+    const uint8_t *bp;
+    size_t avail, len;
+    uint32_t msglen;
+    while (1) {
+        if (fill(prf, RF_LOOK)) {
+            SPRTF("%s: Read error at offset %llu of '%s'!\n", mod_name,
+                (unsigned long long)(prf->base + prf->end), prf->file.c_str());
+            return -1;
+        }
+        avail = prf->end - prf->pos;
+        if (!avail)
+            return 0;
+        bp = (const uint8_t *)prf->data + prf->pos;
+        if ((avail < 4) || !is_magic(bp)) {
+            // between packets
+            for (len = 0; (len < avail) && !bp[len]; len++)
+                ;
+            if (len)
+                damage(prf, rd_Padding, len);
+            else
+                damage(prf, rd_Junk, next_magic(prf, bp, 1, avail));
+            continue;
+        }
+        if (avail < RF_HDR_LEN) {
+            damage(prf, rd_Truncated, avail);   // at the end
+            continue;
+        }
+        msglen = get_be32(bp + RF_LEN_OFF);
+        if ((get_be32(bp + 4) != PROTO_VER) || (msglen < RF_HDR_LEN)) {
+            damage(prf, rd_BadProto, next_magic(prf, bp, 4, avail));
+            continue;
+        }
+        if (msglen > RAW_MAX_PACKET) {
+            damage(prf, rd_Oversized, next_magic(prf, bp, 4, avail));
+            continue;
+        }
+        if (msglen > avail) {
+            damage(prf, rd_Truncated, next_magic(prf, bp, 4, avail));    // at the end
+            continue;
+        }
+        if ((msglen + 4 <= avail) && !is_magic(bp + msglen)) {
+            // not followed by a packet - cut short by the next, or
+            // followed by padding, or junk
+            len = next_magic(prf, bp, 4, avail);
+            if (len < msglen) {
+                damage(prf, rd_Truncated, len);
+                continue;
+            }
+        }
+        *ppacket = prf->data + prf->pos;
+        prf->last = prf->base + prf->pos;
+        prf->pos += msglen;
+        prf->dam.packets++;
+        prf->dam.bytes += msglen;
+        return (int)msglen;
+    }
+}
+
+uint64_t rawframe_offset( PRAWFRAME prf )
+{
+    return prf->last;
+}
+
+const RAW_DAMAGE *rawframe_damage( PRAWFRAME prf )
+{
+    return &prf->dam;
+}
+
+bool rawframe_has_damage( PRAWFRAME prf )
+{
+    int rd;
+    for (rd = 0; rd < rd_Max; rd++) {
+        if (prf->dam.count[rd])
+            return true;
+    }
+    return false;
+}
+
+void rawframe_show_stats( PRAWFRAME prf )
+{
+    PRAW_DAMAGE pd = &prf->dam;
+    int rd;
+    SPRTF("%s: Framed %llu packets, %.3f MB, of '%s'%s\n", mod_name,
+        (unsigned long long)pd->packets, (double)pd->bytes / (1024.0 * 1024.0), prf->file.c_str(),
+        rawframe_has_damage(prf) ? ", damage -" : ", no damage");
+    for (rd = 0; rd < rd_Max; rd++) {
+        if (!pd->count[rd])
+            continue;
+        SPRTF("%s:  %-9s %llu times, %llu bytes, first at offset %llu\n", mod_name, damage_stg[rd],
+            (unsigned long long)pd->count[rd], (unsigned long long)pd->lost[rd],
+            (unsigned long long)pd->first[rd]);
+    }
+    if (pd->resyncs)
+        SPRTF("%s: Scanned for the next magic %llu times\n", mod_name, (unsigned long long)pd->resyncs);
+    ra_show_stats(prf->ra);
+}
+
+void rawframe_close( PRAWFRAME prf )
+{
+    if (!prf)
+        return;
+    ra_close(prf->ra);
+    delete prf;
+}
+
+// eof - cf_rawframe.cxx
@@ -0,0 +1,50 @@
+// cf_rawframe.hxx
+// Frame the packets of a raw mp udp log, read ahead, and account for damage
+// Each packet should start with a magic and the protocol version, and
+// run for the T_MsgHdr MsgLen, to the next magic. When the MsgLen agrees
+// that is all that is checked, so a whole log frames without a byte
+// scan. Otherwise the damage is classified, counted, and skipped, by
+// looking at most a maximum packet ahead for the next magic -
+//   truncated  - the next magic, or the end of the log, comes before MsgLen
+//   oversized  - MsgLen over RAW_MAX_PACKET
+//   bad proto  - a magic, but not PROTO_VER, or MsgLen under a T_MsgHdr
+//   padding    - a run of zeros between packets
+//   junk       - any other bytes between packets, or before the first
+// Only whole packets are returned. The log is read through cf_readahead.
+#ifndef _CF_RAWFRAME_HXX_
+#define _CF_RAWFRAME_HXX_
+#include <stdint.h>
+
+enum Raw_Damage {
+    rd_Truncated,
+    rd_Oversized,
+    rd_BadProto,
+    rd_Padding,
+    rd_Junk,
+    rd_Max
+};
+
+typedef struct tagRAW_DAMAGE {
+    uint64_t packets, bytes;        // returned
+    uint64_t count[rd_Max];         // events
+    uint64_t lost[rd_Max];          // bytes
+    uint64_t first[rd_Max];         // file offset of the first event
+    uint64_t resyncs;               // scans for the next magic
+}RAW_DAMAGE, *PRAW_DAMAGE;
+
+typedef struct tagRAWFRAME RAWFRAME, *PRAWFRAME;
+
+// log_max - log the offset and class of up to this many damage events
+extern PRAWFRAME rawframe_open( const char *file, int log_max );
+// returns the packet length, and points at the packet, valid to the next
+// call, 0 at the end of the log, or -1 on a read error
+extern int rawframe_next( PRAWFRAME prf, char **ppacket );
+extern uint64_t rawframe_offset( PRAWFRAME prf );  // of the last packet returned
+extern const RAW_DAMAGE *rawframe_damage( PRAWFRAME prf );
+extern bool rawframe_has_damage( PRAWFRAME prf );
+extern const char *raw_damage_stg( int rd );
+extern void rawframe_show_stats( PRAWFRAME prf );  // a damage report, and the read-ahead
+extern void rawframe_close( PRAWFRAME prf );
+
+#endif // #ifndef _CF_RAWFRAME_HXX_
+// eof - cf_rawframe.hxx
@@ -0,0 +1,127 @@
+// cf_rawscan.cxx
+// Split a raw mp udp log into its packets - see cf_rawscan.hxx
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "sprtf.hxx"
+#include "mpMsgs.hxx"
+#include "cf_rawscan.hxx"
+
+static const char *mod_name = "cf_rawscan";
+
+#define RAW_MSGID_OFF   8       // T_MsgHdr MsgId
+#define RAW_CS_OFF      24      // T_MsgHdr Callsign
+#define RAW_TIME_OFF    128     // T_PositionMsg time
+#define RAW_POS_LEN     228     // T_MsgHdr and the T_PositionMsg kinematic block
+
+static inline uint32_t get_be32( const uint8_t *p )
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+bool raw_is_magic( const uint8_t *cp )
+{
+    uint32_t magic = get_be32(cp);
+    return ((magic == MSG_MAGIC) || (magic == RELAY_MAGIC)) &&
+        (get_be32(cp + 4) == PROTO_VER);
+}
+
+const uint8_t *raw_find_magic( const uint8_t *bgn, const uint8_t *end )
+{
+    for ( ; bgn + 8 <= end; bgn++) {
+        if (((*bgn == 'S') || (*bgn == 'F')) && raw_is_magic(bgn))
+            return bgn;
+    }
+    return 0;
+}
+
+uint64_t raw_pace_arrival( PRAW_PACER prp, const uint8_t *pkt, size_t len )
+{
+    if ((len >= RAW_POS_LEN) && (get_be32(pkt + RAW_MSGID_OFF) == POS_DATA_ID)) {
+        uint64_t bits = ((uint64_t)get_be32(pkt + RAW_TIME_OFF) << 32) | get_be32(pkt + RAW_TIME_OFF + 4);
+        double sim;
+        memcpy(&sim, &bits, sizeof(sim));
+        std::string cs((const char *)pkt + RAW_CS_OFF, MAX_CALLSIGN_LEN);
+        mRAWPACE::iterator it = prp->mPace.find(cs);
+        if ((it == prp->mPace.end()) || (sim < it->second.first_sim) ||
+            ((sim - it->second.first_sim) > 1e6)) {
+            RAW_PACE rp;
+            rp.first_sim = sim;
+            rp.base = prp->clock;
+            prp->mPace[cs] = rp;
+        } else {
+            uint64_t est = it->second.base + (uint64_t)((sim - it->second.first_sim) * 1e6);
+            if (est > prp->clock)
+                prp->clock = est;
+        }
+    }
+    return prp->clock;
+}
+
+int raw_scan_file( const char *raw, RAW_PACKET_CB cb, void *vp )
+{
+    int iret = 0;
+    FILE *fp = fopen(raw, "rb");
+    if (!fp) {
+        SPRTF("%s: Failed to open '%s'!\n", mod_name, raw);
+        return 1;
+    }
+    RAW_PACER pacer;
+    pacer.clock = 0;
+    uint64_t skipped = 0;
+    std::vector<uint8_t> buf(2 * RAW_SCAN_CHUNK);
+    size_t pos = 0, end = 0;
+    bool eof = false, found = false;
+    while (1) {
+        if (!eof && (end - pos < RAW_SCAN_CHUNK)) {
+            memmove(&buf[0], &buf[pos], end - pos);
+            end -= pos;
+            pos = 0;
+            size_t rd = fread(&buf[end], 1, buf.size() - end, fp);
+            end += rd;
+            if (!rd)
+                eof = true;
+        }
+        if (pos >= end)
+            break;
+        const uint8_t *bp = &buf[0];
+        if (!found) {
+            // skip to the first magic
+            const uint8_t *cp = raw_find_magic(bp + pos, bp + end);
+            if (!cp) {
+                size_t keep = (end - pos > 7) ? 7 : (end - pos);
+                skipped += (end - pos) - (eof ? 0 : keep);
+                pos = eof ? end : end - keep;
+                if (eof)
+                    break;
+                continue;
+            }
+            skipped += (cp - bp) - pos;
+            pos = cp - bp;
+            found = true;
+        }
+        size_t lim = pos + RAW_MAX_PACKET;
+        if (lim > end)
+            lim = end;
+        const uint8_t *nx = raw_find_magic(bp + pos + 4, bp + lim);
+        size_t len;
+        if (nx)
+            len = nx - (bp + pos);
+        else if (!eof && (lim < pos + RAW_MAX_PACKET))
+            continue;   // need more data
+        else
+            len = lim - pos;    // to the end, or a maximum packet
+        iret = cb((const char *)bp + pos, (int)len, raw_pace_arrival(&pacer, bp + pos, len), vp);
+        if (iret)
+            break;
+        pos += len;
+    }
+    fclose(fp);
+    if (skipped)
+        SPRTF("%s: Skipped %d bytes before the first magic of '%s'\n", mod_name, (int)skipped, raw);
+    return iret;
+}
+
+// eof - cf_rawscan.cxx
@@ -0,0 +1,39 @@
+// cf_rawscan.hxx
+// Split a raw mp udp log into its packets, for the log converters
+// A packet starts at a magic, "SFGF" or "FGFS", followed by the protocol
+// version, and runs to the next magic. Bytes before the first are skipped.
+// A raw log has no arrival times, so they are estimated, in usecs from
+// the first packet, from each sender's sim time, as the replay pacer
+// does, and never go backwards.
+#ifndef _CF_RAWSCAN_HXX_
+#define _CF_RAWSCAN_HXX_
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <map>
+
+#define RAW_MAX_PACKET  65536   // no magic found by then, split anyway
+#define RAW_SCAN_CHUNK  (1 << 20)
+
+typedef struct tagRAW_PACE {
+    double   first_sim;
+    uint64_t base;          // arrival usecs at first_sim
+}RAW_PACE;
+
+typedef std::map<std::string,RAW_PACE> mRAWPACE;
+
+typedef struct tagRAW_PACER {
+    mRAWPACE mPace;         // per callsign
+    uint64_t clock;         // latest arrival
+}RAW_PACER, *PRAW_PACER;
+
+// called for each packet, in order, non zero stops the scan
+typedef int (*RAW_PACKET_CB)( const char *packet, int len, uint64_t arrival, void *vp );
+
+extern bool raw_is_magic( const uint8_t *cp );  // 8 bytes there
+extern const uint8_t *raw_find_magic( const uint8_t *bgn, const uint8_t *end );
+extern uint64_t raw_pace_arrival( PRAW_PACER prp, const uint8_t *packet, size_t len );
+extern int raw_scan_file( const char *raw, RAW_PACKET_CB cb, void *vp ); // 0, or error, or cb value
+
+#endif // #ifndef _CF_RAWSCAN_HXX_
+// eof - cf_rawscan.hxx
@@ -0,0 +1,161 @@
+// cf_readahead.cxx
+// Read a file ahead of its consumer, on a background thread - see cf_readahead.hxx
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "sprtf.hxx"
+#include "cf_clock.hxx"
+#include "cf_readahead.hxx"
+
+static const char *mod_name = "cf_readahead";
+
+#define RA_SLACK    8   // decoders may peek past a bad packet, as in a raw log buffer
+
+// buffer states
+#define RA_FREE     0   // for the reader to fill
+#define RA_FULL     1   // for the consumer
+#define RA_USED     2   // with the consumer
+
+struct tagREADAHEAD {
+    FILE *fp;
+    std::string file;
+    size_t size;            // bytes per read, after the keep area
+    char *buf[2];
+    size_t len[2];          // bytes read into each
+    int state[2];           // RA_...
+    int cur;                // the consumer's, or -1
+    std::thread *reader;
+    std::mutex mtx;
+    std::condition_variable cv_free, cv_full;
+    bool stop, done, error;
+    // stats
+    uint64_t bytes, reads, waits;
+    double read_secs, wait_secs;
+};
+
+static void read_ahead( PREADAHEAD pra )
+{
+    int i = 0;
+    std::unique_lock<std::mutex> lock(pra->mtx);
+    while (1) {
+        while (!pra->stop && (pra->state[i] != RA_FREE))
+            pra->cv_free.wait(lock);
+        if (pra->stop)
+            break;
+        lock.unlock();
+        double bgn = clock_mono();
+        size_t rd = fread(pra->buf[i] + RA_KEEP_SIZE, 1, pra->size, pra->fp);
+        bool err = (rd < pra->size) && ferror(pra->fp);
+        double secs = clock_mono() - bgn;
+        lock.lock();
+        pra->read_secs += secs;
+        pra->bytes += rd;
+        pra->reads++;
+        pra->len[i] = rd;
+        pra->state[i] = RA_FULL;
+        pra->cv_full.notify_one();
+        if (rd < pra->size) {
+            pra->error = err;
+            break;  // the end, or an error
+        }
+        i ^= 1;
+    }
+    pra->done = true;
+    pra->cv_full.notify_one();
+}
+
+PREADAHEAD ra_open( const char *file, size_t buf_size )
+{
+    FILE *fp = fopen(file, "rb");
+    if (!fp) {
+        SPRTF("%s: Failed to open '%s'!\n", mod_name, file);
+        return 0;
+    }
+    setvbuf(fp, 0, _IONBF, 0);  // straight into the buffers
+    PREADAHEAD pra = new READAHEAD;
+    pra->fp = fp;
+    pra->file = file;
+    pra->size = buf_size ? buf_size : RA_BUF_SIZE;
+    pra->buf[0] = (char *)malloc(RA_KEEP_SIZE + pra->size + RA_SLACK);
+    pra->buf[1] = (char *)malloc(RA_KEEP_SIZE + pra->size + RA_SLACK);
+    if (!pra->buf[0] || !pra->buf[1]) {
+        SPRTF("%s: memory allocation FAILED\n", mod_name);
+        free(pra->buf[0]);
+        free(pra->buf[1]);
+        fclose(fp);
+        delete pra;
+        return 0;
+    }
+    memset(pra->buf[0] + RA_KEEP_SIZE + pra->size, 0, RA_SLACK);
+    memset(pra->buf[1] + RA_KEEP_SIZE + pra->size, 0, RA_SLACK);
+    pra->len[0] = pra->len[1] = 0;
+    pra->state[0] = pra->state[1] = RA_FREE;
+    pra->cur = -1;
+    pra->stop = pra->done = pra->error = false;
+    pra->bytes = pra->reads = pra->waits = 0;
+    pra->read_secs = pra->wait_secs = 0.0;
+    pra->reader = new std::thread(read_ahead, pra);
+    return pra;
+}
+
+int ra_next( PREADAHEAD pra, const char *keep, size_t keep_len, char **pdata )
+{
+    int want = (pra->cur < 0) ? 0 : (pra->cur ^ 1);
+    if (keep_len > RA_KEEP_SIZE) {
+        SPRTF("%s: Can not keep %d bytes of '%s'!\n", mod_name, (int)keep_len, pra->file.c_str());
+        return -1;
+    }
+    std::unique_lock<std::mutex> lock(pra->mtx);
+    if (!pra->done && (pra->state[want] != RA_FULL)) {
+        double bgn = clock_mono();
+        while (!pra->done && (pra->state[want] != RA_FULL))
+            pra->cv_full.wait(lock);
+        pra->wait_secs += clock_mono() - bgn;
+        pra->waits++;
+    }
+    if ((pra->state[want] != RA_FULL) || !pra->len[want])
+        return pra->error ? -1 : 0;
+    char *data = pra->buf[want] + RA_KEEP_SIZE - keep_len;
+    if (keep_len)
+        memcpy(data, keep, keep_len);
+    if (pra->cur >= 0) {
+        pra->state[pra->cur] = RA_FREE;
+        pra->cv_free.notify_one();
+    }
+    pra->cur = want;
+    pra->state[want] = RA_USED;
+    *pdata = data;
+    return (int)(keep_len + pra->len[want]);
+}
+
+void ra_show_stats( PREADAHEAD pra )
+{
+    SPRTF("%s: Read %.3f MB of '%s' in %d reads, %.3f s, waited %d times, %.3f s\n", mod_name,
+        (double)pra->bytes / (1024.0 * 1024.0), pra->file.c_str(), (int)pra->reads,
+        pra->read_secs, (int)pra->waits, pra->wait_secs);
+}
+
+void ra_close( PREADAHEAD pra )
+{
+    if (!pra)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(pra->mtx);
+        pra->stop = true;
+        pra->cv_free.notify_one();
+    }
+    pra->reader->join();
+    delete pra->reader;
+    fclose(pra->fp);
+    free(pra->buf[0]);
+    free(pra->buf[1]);
+    delete pra;
+}
+
+// eof - cf_readahead.cxx
@@ -0,0 +1,31 @@
+// cf_readahead.hxx
+// Read a file ahead of its consumer, on a background thread
+// The reader thread fills two buffers of RA_BUF_SIZE bytes in turn, while
+// the consumer works through the other, so the consumer only waits on
+// the i/o when it is faster than the disk. ra_next() hands back the last
+// buffer, and swaps in the next. Each buffer has RA_KEEP_SIZE bytes in
+// front of it, where ra_next() first moves what the consumer had not
+// used of the last one, like a packet split over the two reads, so the
+// data handed over is always contiguous.
+#ifndef _CF_READAHEAD_HXX_
+#define _CF_READAHEAD_HXX_
+#include <stddef.h>
+
+#ifndef RA_BUF_SIZE
+#define RA_BUF_SIZE     (8 << 20)   // bytes per read
+#endif
+#define RA_KEEP_SIZE    (1 << 17)   // most that can be carried over, 2 maximum packets
+
+typedef struct tagREADAHEAD READAHEAD, *PREADAHEAD;
+
+extern PREADAHEAD ra_open( const char *file, size_t buf_size );    // 0 for RA_BUF_SIZE, and start the reader
+// move keep_len bytes from keep to the front of the next buffer, hand back
+// the last, and point at the next. Returns the bytes there, the kept and
+// the new, 0 at the end of the file, or -1 on a read error. At the end,
+// or an error, the last buffer is not handed back, so keep is still valid.
+extern int ra_next( PREADAHEAD pra, const char *keep, size_t keep_len, char **pdata );
+extern void ra_show_stats( PREADAHEAD pra );
+extern void ra_close( PREADAHEAD pra );    // stop the reader, and free
+
+#endif // #ifndef _CF_READAHEAD_HXX_
+// eof - cf_readahead.hxx
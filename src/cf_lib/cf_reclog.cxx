@@ -0,0 +1,632 @@
+// cf_reclog.cxx
+// Compact recording of a raw mp udp log - see cf_reclog.hxx
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+#include "sprtf.hxx"
+#include "cf_misc.hxx"
+#include "mpMsgs.hxx"
+#include "cf_rawscan.hxx"
+#include "cf_reclog.hxx"
+
+static const char *mod_name = "cf_reclog";
+
+#define REC_MSGID_OFF   8       // T_MsgHdr MsgId
+#define REC_CS_OFF      24      // T_MsgHdr Callsign
+#define REC_HDR_LEN     32      // T_MsgHdr
+#define REC_TIME_OFF    128     // T_PositionMsg time, after the model
+#define REC_KIN_END     228     // end of the T_PositionMsg kinematic block
+#define REC_HDR_WORDS   6       // T_MsgHdr words before the callsign
+#define REC_KIN64       5       // time, lag, position[3]
+#define REC_KIN32       15      // orientation, and the four velocity vectors
+#define REC_CHUNK       (1 << 20)   // file read and write buffer
+#define REC_MAX_FRAME   (REC_MAX_PACKET + 1024)
+#define REC_SLACK       8   // decoders may peek past a bad packet, as in a raw log buffer
+
+// frame flags
+#define RF_PACKET   0x01    // else just the bytes follow
+#define RF_KEY      0x02    // coded against zero
+#define RF_NEW_CS   0x04    // callsign bytes follow its index
+#define RF_KIN      0x08    // position packet, kinematic block coded
+#define RF_MOD      0x10    // model index follows
+#define RF_NEW_MOD  0x20    // model bytes follow its index
+
+// the previous packet of a callsign
+typedef struct tagREC_STATE {
+    uint32_t frames;            // since the keyframe
+    bool     kin;               // was a position packet
+    int      model;             // model index, or -1
+    uint64_t kv[REC_KIN64];     // 64 bit values, and their deltas
+    uint64_t kd[REC_KIN64];
+    uint32_t kf[REC_KIN32];     // 32 bit values
+    uint8_t  tail[4];
+    size_t   len;               // of the packet
+    std::vector<uint8_t> pkt;   // the packet, when reading decoded in place
+}REC_STATE, *PREC_STATE;
+
+typedef std::map<std::string,int> mSTGINT;
+
+struct tagRECLOG {
+    FILE *fp;
+    bool writing;
+    uint64_t arrival;           // of the previous frame
+    std::vector<std::string> calls, models;
+    mSTGINT mCalls, mModels;    // writing only
+    std::vector<REC_STATE> states;  // per callsign index
+    std::string frame, out;     // writing
+    std::vector<uint32_t> x;    // writing - xor words
+    std::vector<uint8_t> buf;   // reading
+    size_t pos, end;
+    std::vector<char> packet;   // reading - a packet too short to code
+    uint64_t frames, keys, bytes_in, bytes_out;
+};
+
+/////////////////////////////////////////////////////////////////////////
+// varints, and big endian packet words
+static void put_uvarint( std::string &s, uint64_t v )
+{
+    while (v >= 0x80) {
+        s += (char)((v & 0x7f) | 0x80);
+        v >>= 7;
+    }
+    s += (char)v;
+}
+
+static void put_varint( std::string &s, int64_t val )
+{
+    put_uvarint(s, ((uint64_t)val << 1) ^ (uint64_t)(val >> 63));
+}
+
+static int uvarint_len( uint64_t v )
+{
+    int n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+static bool get_uvarint( const uint8_t **pp, const uint8_t *end, uint64_t *pval )
+{
+    const uint8_t *p = *pp;
+    uint64_t v = 0;
+    int shift = 0;
+    while (p < end) {
+        uint8_t c = *p++;
+        v |= (uint64_t)(c & 0x7f) << shift;
+        if (!(c & 0x80)) {
+            *pp = p;
+            *pval = v;
+            return true;
+        }
+        shift += 7;
+        if (shift > 63)
+            break;
+    }
+    return false;
+}
+
+static bool get_varint( const uint8_t **pp, const uint8_t *end, int64_t *pval )
+{
+    uint64_t v;
+    if (!get_uvarint(pp, end, &v))
+        return false;
+    *pval = (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+    return true;
+}
+
+static inline uint32_t get_be32( const uint8_t *p )
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline uint64_t get_be64( const uint8_t *p )
+{
+    return ((uint64_t)get_be32(p) << 32) | get_be32(p + 4);
+}
+
+static inline void put_be32( uint8_t *p, uint32_t v )
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static inline void put_be64( uint8_t *p, uint64_t v )
+{
+    put_be32(p, (uint32_t)(v >> 32));
+    put_be32(p + 4, (uint32_t)v);
+}
+
+static void reset_state( PREC_STATE ps )
+{
+    ps->frames = 0;
+    ps->kin = false;
+    ps->model = -1;
+    memset(ps->kv, 0, sizeof(ps->kv));
+    memset(ps->kd, 0, sizeof(ps->kd));
+    memset(ps->kf, 0, sizeof(ps->kf));
+    memset(ps->tail, 0, sizeof(ps->tail));
+    ps->len = 0;
+}
+
+// the words, less the callsign, model and kinematic block
+static size_t word_count( int len, bool kin )
+{
+    size_t base = kin ? REC_KIN_END : REC_HDR_LEN;
+    return REC_HDR_WORDS + (((size_t)len & ~3) - base) / 4;
+}
+
+static inline size_t word_offset( size_t i, bool kin )
+{
+    if (i < REC_HDR_WORDS)
+        return i * 4;
+    return (kin ? REC_KIN_END : REC_HDR_LEN) + (i - REC_HDR_WORDS) * 4;
+}
+
+/////////////////////////////////////////////////////////////////////////
+// writing
+PRECLOG reclog_create( const char *file, uint16_t flags )
+{
+    FILE *fp = fopen(file, "wb");
+    if (!fp) {
+        SPRTF("%s: Failed to create '%s'!\n", mod_name, file);
+        return 0;
+    }
+    RECLOG_HDR hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = RECLOG_MAGIC;
+    hdr.version = RECLOG_VERSION;
+    hdr.flags = flags;
+    hdr.key_interval = REC_KEY_INTERVAL;
+    if (fwrite(&hdr, sizeof(hdr), 1, fp) != 1) {
+        SPRTF("%s: Failed to write '%s'!\n", mod_name, file);
+        fclose(fp);
+        return 0;
+    }
+    PRECLOG prl = new RECLOG;
+    prl->fp = fp;
+    prl->writing = true;
+    prl->arrival = 0;
+    prl->pos = prl->end = 0;
+    prl->frames = prl->keys = prl->bytes_in = 0;
+    prl->bytes_out = sizeof(hdr);
+    prl->out.reserve(REC_CHUNK + REC_MAX_FRAME);
+    return prl;
+}
+
+static int dict_index( mSTGINT &m, std::vector<std::string> &v, const char *cp, size_t len, bool *pnew )
+{
+    std::string s(cp, len);
+    mSTGINT::iterator it = m.find(s);
+    if (it != m.end()) {
+        *pnew = false;
+        return it->second;
+    }
+    int ind = (int)v.size();
+    v.push_back(s);
+    m[s] = ind;
+    *pnew = true;
+    return ind;
+}
+
+// xor against the previous, as runs of zero, and literal, words
+static void put_words( std::string &f, const uint8_t *pkt, bool kin, PREC_STATE ps,
+    std::vector<uint32_t> &x, size_t n )
+{
+    size_t i = 0, j, k, off;
+    size_t plen4 = ps->len & ~3;
+    x.resize(n);
+    for (k = 0; k < n; k++) {
+        off = word_offset(k, kin);
+        x[k] = get_be32(pkt + off);
+        if (off + 4 <= plen4)
+            x[k] ^= get_be32(&ps->pkt[off]);
+    }
+    while (i < n) {
+        for (j = i; (j < n) && !x[j]; j++);
+        put_uvarint(f, j - i);
+        i = j;
+        if (i == n)
+            break;
+        // literals, up to two zero words
+        size_t vlen = 0;
+        for ( ; j < n; j++) {
+            if (!x[j] && ((j + 1 == n) || !x[j + 1]))
+                break;
+            vlen += uvarint_len(x[j]);
+        }
+        bool raw = ((j - i) * 4 < vlen);
+        put_uvarint(f, ((j - i) << 1) | (raw ? 1 : 0));
+        for ( ; i < j; i++) {
+            if (raw) {
+                f += (char)x[i];
+                f += (char)(x[i] >> 8);
+                f += (char)(x[i] >> 16);
+                f += (char)(x[i] >> 24);
+            } else
+                put_uvarint(f, x[i]);
+        }
+    }
+}
+
+static void flush_out( PRECLOG prl )
+{
+    if (prl->out.size()) {
+        if (fwrite(prl->out.data(), 1, prl->out.size(), prl->fp) != prl->out.size())
+            SPRTF("%s: Failed to write %d bytes!\n", mod_name, (int)prl->out.size());
+        prl->bytes_out += prl->out.size();
+        prl->out.clear();
+    }
+}
+
+int reclog_write( PRECLOG prl, const char *packet, int len, uint64_t arrival )
+{
+    const uint8_t *pkt = (const uint8_t *)packet;
+    std::string &f = prl->frame;
+    uint8_t flags = 0;
+    size_t k;
+    bool isnew;
+    if (!prl->writing || (len <= 0) || (len > REC_MAX_PACKET))
+        return 1;
+    f.clear();
+    f += (char)0;   // the flags, set below
+    put_varint(f, (int64_t)(arrival - prl->arrival));
+    prl->arrival = arrival;
+    put_uvarint(f, (uint64_t)len);
+    if (len < REC_HDR_LEN) {
+        f.append(packet, len);
+    } else {
+        flags |= RF_PACKET;
+        int ci = dict_index(prl->mCalls, prl->calls, packet + REC_CS_OFF, MAX_CALLSIGN_LEN, &isnew);
+        put_uvarint(f, (uint64_t)ci);
+        if (isnew) {
+            flags |= RF_NEW_CS;
+            f.append(packet + REC_CS_OFF, MAX_CALLSIGN_LEN);
+            prl->states.push_back(REC_STATE());
+        }
+        PREC_STATE ps = &prl->states[ci];
+        bool kin = (len >= REC_KIN_END) && (get_be32(pkt + REC_MSGID_OFF) == POS_DATA_ID);
+        if (isnew || (ps->frames >= REC_KEY_INTERVAL) || (kin != ps->kin)) {
+            reset_state(ps);
+            flags |= RF_KEY;
+            prl->keys++;
+        }
+        if (kin) {
+            flags |= RF_KIN;
+            int mi = dict_index(prl->mModels, prl->models, packet + REC_HDR_LEN, MAX_MODEL_NAME_LEN, &isnew);
+            if (mi != ps->model) {
+                flags |= RF_MOD;
+                put_uvarint(f, (uint64_t)mi);
+                if (isnew) {
+                    flags |= RF_NEW_MOD;
+                    f.append(packet + REC_HDR_LEN, MAX_MODEL_NAME_LEN);
+                }
+                ps->model = mi;
+            }
+            const uint8_t *p = pkt + REC_TIME_OFF;
+            for (k = 0; k < REC_KIN64; k++, p += 8) {
+                uint64_t v = get_be64(p);
+                uint64_t d = v - ps->kv[k];
+                put_varint(f, (int64_t)(d - ps->kd[k]));
+                ps->kv[k] = v;
+                ps->kd[k] = (flags & RF_KEY) ? 0 : d;
+            }
+            for (k = 0; k < REC_KIN32; k++, p += 4) {
+                uint32_t v = get_be32(p);
+                put_uvarint(f, v ^ ps->kf[k]);
+                ps->kf[k] = v;
+            }
+        }
+        ps->kin = kin;
+        put_words(f, pkt, kin, ps, prl->x, word_count(len, kin));
+        size_t len4 = (size_t)len & ~3;
+        size_t tl = (size_t)len - len4;    // under sizeof(ps->tail)
+        for (k = 0; k < tl; k++) {
+            f += (char)(pkt[len4 + k] ^ ps->tail[k]);
+            ps->tail[k] = pkt[len4 + k];
+        }
+        ps->pkt.assign(pkt, pkt + len);
+        ps->len = len;
+        ps->frames++;
+    }
+    f[0] = (char)flags;
+    put_uvarint(prl->out, f.size());
+    prl->out += f;
+    prl->frames++;
+    prl->bytes_in += len;
+    if (prl->out.size() >= REC_CHUNK)
+        flush_out(prl);
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////
+// reading
+bool reclog_is_rec( const char *file )
+{
+    RECLOG_HDR hdr;
+    FILE *fp = fopen(file, "rb");
+    if (!fp)
+        return false;
+    size_t rd = fread(&hdr, sizeof(hdr), 1, fp);
+    fclose(fp);
+    return (rd == 1) && (hdr.magic == RECLOG_MAGIC);
+}
+
+PRECLOG reclog_open( const char *file )
+{
+    RECLOG_HDR hdr;
+    FILE *fp = fopen(file, "rb");
+    if (!fp) {
+        SPRTF("%s: Failed to open '%s'!\n", mod_name, file);
+        return 0;
+    }
+    if ((fread(&hdr, sizeof(hdr), 1, fp) != 1) || (hdr.magic != RECLOG_MAGIC)) {
+        SPRTF("%s: '%s' is not a recording!\n", mod_name, file);
+        fclose(fp);
+        return 0;
+    }
+    if (hdr.version != RECLOG_VERSION) {
+        SPRTF("%s: '%s' is version %d, not %d!\n", mod_name, file, hdr.version, RECLOG_VERSION);
+        fclose(fp);
+        return 0;
+    }
+    PRECLOG prl = new RECLOG;
+    prl->fp = fp;
+    prl->writing = false;
+    prl->arrival = 0;
+    prl->buf.resize(REC_CHUNK);
+    prl->pos = prl->end = 0;
+    prl->packet.resize(REC_MAX_PACKET + REC_SLACK);
+    prl->frames = prl->keys = prl->bytes_in = prl->bytes_out = 0;
+    return prl;
+}
+
+// have at least need bytes buffered, unless at end of file
+static size_t fill( PRECLOG prl, size_t need )
+{
+    size_t avail = prl->end - prl->pos;
+    if ((avail < need) && prl->fp) {
+        if (prl->pos) {
+            memmove(&prl->buf[0], &prl->buf[prl->pos], avail);
+            prl->pos = 0;
+            prl->end = avail;
+        }
+        size_t rd = fread(&prl->buf[prl->end], 1, prl->buf.size() - prl->end, prl->fp);
+        prl->end += rd;
+        prl->bytes_in += rd;
+        avail = prl->end;
+    }
+    return avail;
+}
+
+// xor the words into the previous packet
+static inline void xor_be32( uint8_t *p, uint32_t v )
+{
+    p[0] ^= (uint8_t)(v >> 24);
+    p[1] ^= (uint8_t)(v >> 16);
+    p[2] ^= (uint8_t)(v >> 8);
+    p[3] ^= (uint8_t)v;
+}
+
+static bool get_words( const uint8_t **pp, const uint8_t *end, uint8_t *pkt, bool kin, size_t n )
+{
+    size_t i = 0, lit;
+    uint64_t z, hdr, v;
+    while (i < n) {
+        if (!get_uvarint(pp, end, &z) || (z > n - i))
+            return false;
+        i += (size_t)z;
+        if (i == n)
+            break;
+        if (!get_uvarint(pp, end, &hdr))
+            return false;
+        lit = (size_t)(hdr >> 1);
+        if (!lit || (lit > n - i))
+            return false;
+        if (hdr & 1) {
+            const uint8_t *p = *pp;
+            if ((size_t)(end - p) < lit * 4)
+                return false;
+            for ( ; lit; lit--, p += 4)
+                xor_be32(pkt + word_offset(i++, kin),
+                    (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+            *pp = p;
+        } else {
+            for ( ; lit; lit--) {
+                if (!get_uvarint(pp, end, &v) || (v > 0xffffffff))
+                    return false;
+                xor_be32(pkt + word_offset(i++, kin), (uint32_t)v);
+            }
+        }
+    }
+    return true;
+}
+
+static int bad_frame( PRECLOG prl, const char *why )
+{
+    SPRTF("%s: Bad frame %d - %s!\n", mod_name, (int)prl->frames, why);
+    return -1;
+}
+
+int reclog_read( PRECLOG prl, char **ppacket, uint64_t *parrival )
+{
+    const uint8_t *p, *end;
+    uint64_t flen, len, ci, mi;
+    int64_t v;
+    size_t k, avail;
+    if (prl->writing)
+        return -1;
+    avail = fill(prl, 10);
+    if (!avail)
+        return 0;   // clean end
+    p = &prl->buf[prl->pos];
+    if (!get_uvarint(&p, p + avail, &flen) || (flen < 3) || (flen > REC_MAX_FRAME))
+        return bad_frame(prl, "length");
+    size_t hlen = p - &prl->buf[prl->pos];
+    if (fill(prl, hlen + (size_t)flen) < hlen + flen)
+        return bad_frame(prl, "truncated");
+    p = &prl->buf[prl->pos + hlen];
+    end = p + flen;
+    prl->pos += hlen + (size_t)flen;
+    uint8_t flags = *p++;
+    if (!get_varint(&p, end, &v) || !get_uvarint(&p, end, &len) || !len || (len > REC_MAX_PACKET))
+        return bad_frame(prl, "header");
+    prl->arrival += (uint64_t)v;
+    uint8_t *pkt = (uint8_t *)&prl->packet[0];
+    size_t len4 = (size_t)len & ~3;
+    if (!(flags & RF_PACKET)) {
+        if ((size_t)(end - p) != len)
+            return bad_frame(prl, "bytes");
+        memcpy(pkt, p, (size_t)len);
+    } else {
+        if ((len < REC_HDR_LEN) || !get_uvarint(&p, end, &ci) || (ci > prl->calls.size()))
+            return bad_frame(prl, "callsign");
+        if (flags & RF_NEW_CS) {
+            if ((ci != prl->calls.size()) || (end - p < MAX_CALLSIGN_LEN))
+                return bad_frame(prl, "new callsign");
+            prl->calls.push_back(std::string((const char *)p, MAX_CALLSIGN_LEN));
+            prl->states.push_back(REC_STATE());
+            p += MAX_CALLSIGN_LEN;
+        } else if (ci == prl->calls.size())
+            return bad_frame(prl, "callsign index");
+        PREC_STATE ps = &prl->states[ci];
+        if (flags & RF_KEY)
+            reset_state(ps);
+        // decode in place, over the previous packet, zero past its words
+        size_t plen4 = ps->len & ~3;
+        if (ps->pkt.size() < len + REC_SLACK)
+            ps->pkt.resize((size_t)len + REC_SLACK);
+        pkt = &ps->pkt[0];
+        if (len4 > plen4)
+            memset(pkt + plen4, 0, len4 - plen4);
+        bool kin = (flags & RF_KIN) ? true : false;
+        if (kin) {
+            if (len < REC_KIN_END)
+                return bad_frame(prl, "position length");
+            if (flags & RF_MOD) {
+                if (!get_uvarint(&p, end, &mi) || (mi > prl->models.size()))
+                    return bad_frame(prl, "model");
+                if (flags & RF_NEW_MOD) {
+                    if ((mi != prl->models.size()) || (end - p < MAX_MODEL_NAME_LEN))
+                        return bad_frame(prl, "new model");
+                    prl->models.push_back(std::string((const char *)p, MAX_MODEL_NAME_LEN));
+                    p += MAX_MODEL_NAME_LEN;
+                } else if (mi == prl->models.size())
+                    return bad_frame(prl, "model index");
+                ps->model = (int)mi;
+                memcpy(pkt + REC_HDR_LEN, prl->models[ps->model].data(), MAX_MODEL_NAME_LEN);
+            }
+            if (ps->model < 0)
+                return bad_frame(prl, "no model");
+            uint8_t *pk = pkt + REC_TIME_OFF;
+            for (k = 0; k < REC_KIN64; k++, pk += 8) {
+                if (!get_varint(&p, end, &v))
+                    return bad_frame(prl, "kinematics");
+                uint64_t d = (uint64_t)v + ps->kd[k];
+                ps->kv[k] += d;
+                ps->kd[k] = (flags & RF_KEY) ? 0 : d;
+                put_be64(pk, ps->kv[k]);
+            }
+            for (k = 0; k < REC_KIN32; k++, pk += 4) {
+                uint64_t x;
+                if (!get_uvarint(&p, end, &x) || (x > 0xffffffff))
+                    return bad_frame(prl, "kinematics");
+                ps->kf[k] ^= (uint32_t)x;
+                put_be32(pk, ps->kf[k]);
+            }
+        }
+        ps->kin = kin;
+        if (!get_words(&p, end, pkt, kin, word_count((int)len, kin)))
+            return bad_frame(prl, "words");
+        memcpy(pkt + REC_CS_OFF, prl->calls[ci].data(), MAX_CALLSIGN_LEN);
+        size_t tl = (size_t)len - len4;
+        if (((size_t)(end - p) != tl) || (tl >= sizeof(ps->tail)))
+            return bad_frame(prl, "tail");
+        for (k = 0; k < tl; k++) {
+            ps->tail[k] ^= *p++;
+            pkt[len4 + k] = ps->tail[k];
+        }
+        ps->len = (size_t)len;
+        ps->frames++;
+    }
+    prl->frames++;
+    prl->bytes_out += len;
+    *ppacket = (char *)pkt;
+    if (parrival)
+        *parrival = prl->arrival;
+    return (int)len;
+}
+
+void reclog_close( PRECLOG prl )
+{
+    if (!prl)
+        return;
+    if (prl->writing)
+        flush_out(prl);
+    if (prl->fp)
+        fclose(prl->fp);
+    delete prl;
+}
+
+/////////////////////////////////////////////////////////////////////////
+// converters
+
+static int write_cb( const char *packet, int len, uint64_t arrival, void *vp )
+{
+    return reclog_write((PRECLOG)vp, packet, len, arrival);
+}
+
+int reclog_from_raw( const char *raw, const char *rec )
+{
+    double bgn = get_seconds();
+    PRECLOG prl = reclog_create(rec, RECLOG_EST_ARRIVAL);
+    if (!prl)
+        return 1;
+    int iret = raw_scan_file(raw, write_cb, prl);
+    flush_out(prl);
+    double in = (double)prl->bytes_in, out = (double)prl->bytes_out;
+    SPRTF("%s: Recorded %d packets, %d keyframes, %.3f MB to %.3f MB, x%.1f, in %s\n", mod_name,
+        (int)prl->frames, (int)prl->keys, in / (1024.0 * 1024.0), out / (1024.0 * 1024.0),
+        (out > 0.0) ? in / out : 0.0, get_seconds_stg(get_seconds() - bgn));
+    reclog_close(prl);
+    return iret;
+}
+
+int reclog_to_raw( const char *rec, const char *raw )
+{
+    int len, iret = 0;
+    char *packet;
+    double bgn = get_seconds();
+    PRECLOG prl = reclog_open(rec);
+    if (!prl)
+        return 1;
+    FILE *fp = fopen(raw, "wb");
+    if (!fp) {
+        SPRTF("%s: Failed to create '%s'!\n", mod_name, raw);
+        reclog_close(prl);
+        return 1;
+    }
+    while ((len = reclog_read(prl, &packet, 0)) > 0) {
+        if (fwrite(packet, 1, len, fp) != (size_t)len) {
+            SPRTF("%s: Failed to write '%s'!\n", mod_name, raw);
+            iret = 1;
+            break;
+        }
+    }
+    if (len < 0)
+        iret = 1;
+    fclose(fp);
+    SPRTF("%s: Written %d packets, %.3f MB, to '%s', in %s\n", mod_name, (int)prl->frames,
+        (double)prl->bytes_out / (1024.0 * 1024.0), raw, get_seconds_stg(get_seconds() - bgn));
+    reclog_close(prl);
+    return iret;
+}
+
+// eof - cf_reclog.cxx
@@ -0,0 +1,59 @@
+// cf_reclog.hxx
+// Compact recording of a raw mp udp log
+// A raw log is whole XDR packets back to back, only found again by
+// scanning for the magic. A recording is a RECLOG_HDR, then one length
+// prefixed frame per packet -
+//   uvarint  length of the rest of the frame
+//   uint8    RF_... flags
+//   zigzag   arrival, usecs since the previous frame
+//   uvarint  packet length
+//   uvarint  callsign dictionary index, then the 8 bytes when first seen
+//   position packets only -
+//     uvarint  model dictionary index, when changed, then the 96 bytes when first seen
+//     zigzag   time, lag and position[3], delta of delta
+//     uvarint  orientation and the velocity vectors, xor
+//   the other 32 bit words, xor, as runs of zero and literal words
+//   the odd tail bytes, xor
+// Everything is coded against the same callsign's previous packet, and
+// every REC_KEY_INTERVAL frames of a callsign is a keyframe, coded
+// against zero. The coding is lossless - reclog_to_raw() gives back the
+// raw log, from its first magic. Raw log arrival times are estimated,
+// see cf_rawscan.hxx.
+#ifndef _CF_RECLOG_HXX_
+#define _CF_RECLOG_HXX_
+#include <stdint.h>
+
+#define RECLOG_MAGIC    0x4C524643  // "CFRL"
+#define RECLOG_VERSION  1
+#define RECLOG_EST_ARRIVAL  0x0001  // arrival times estimated from sim time
+#ifndef REC_KEY_INTERVAL
+#define REC_KEY_INTERVAL 256        // frames of a callsign between keyframes
+#endif
+#define REC_MAX_PACKET  65536
+
+// file header - 16 bytes
+typedef struct tagRECLOG_HDR {
+    uint32_t magic;         // RECLOG_MAGIC
+    uint16_t version;       // RECLOG_VERSION
+    uint16_t flags;         // RECLOG_EST_ARRIVAL
+    uint32_t key_interval;  // REC_KEY_INTERVAL when written
+    uint32_t res;           // 0
+}RECLOG_HDR, *PRECLOG_HDR;
+
+typedef struct tagRECLOG RECLOG, *PRECLOG;
+
+extern bool reclog_is_rec( const char *file );      // has a RECLOG_HDR
+extern PRECLOG reclog_create( const char *file, uint16_t flags );
+extern int reclog_write( PRECLOG prl, const char *packet, int len, uint64_t arrival );  // 0 = success
+extern PRECLOG reclog_open( const char *file );
+// returns the packet length, and points at the packet, valid to the next
+// read, 0 at the end, or -1 on a bad frame. arrival is usecs, if wanted
+extern int reclog_read( PRECLOG prl, char **ppacket, uint64_t *parrival );
+extern void reclog_close( PRECLOG prl );    // writes any buffered, and frees
+
+// converters, 0 = success
+extern int reclog_from_raw( const char *raw, const char *rec );
+extern int reclog_to_raw( const char *rec, const char *raw );
+
+#endif // #ifndef _CF_RECLOG_HXX_
+// eof - cf_reclog.hxx
@@ -10,7 +10,7 @@ static const char *mod_name = "cf_sqlite.cxx";
 cf_sqlite::cf_sqlite()
 {
     db = 0;
-    db_name = (char *)"DEF_SQL_FILE";
+    db_name = (char *)DEF_SQL_FILE;
     ct_flights = 0;
     ct_positions = 0;
     query_count = 0;
@@ -127,6 +127,9 @@ int cf_sqlite::db_exec(
     int rc;
     int iret = 0;
     double t1, t2, diff;
+    char *local_err = 0;
+    if (!errmsg)
+        errmsg = &local_err;
     query_count++;
     t1 = get_seconds();
     rc = sqlite3_exec(db,sql,callback,vp,errmsg);
@@ -160,6 +163,8 @@ int cf_sqlite::db_exec(
             iret = 1;
         }
     }
+    if (local_err)
+        sqlite3_free(local_err);
     t2 = get_seconds();
     diff = t2 - t1;
     total_secs_in_query += diff;
@@ -168,6 +173,60 @@ int cf_sqlite::db_exec(
     return iret;
 }
 
+#ifndef SQL_BUSY_MS
+#define SQL_BUSY_MS 5000
+#endif
+
+// WAL lets readers of the database run alongside the writer, and with
+// synchronous=NORMAL a commit is not synced, only each checkpoint.
+int cf_sqlite::set_wal()
+{
+    if (!db || (db == (sqlite3 *)-1))
+        return 1;
+    sqlite3_busy_timeout(db, SQL_BUSY_MS);
+    if (db_exec("PRAGMA journal_mode=WAL;", NULL, 0) ||
+        db_exec("PRAGMA synchronous=NORMAL;", NULL, 0))
+        return 1;
+    return 0;
+}
+
+int cf_sqlite::prepare( const char *sql, sqlite3_stmt **pstmt )
+{
+    int rc = sqlite3_prepare_v2(db, sql, -1, pstmt, NULL);
+    if (rc != SQLITE_OK) {
+        SPRTF("%s: Prepare [%s] FAILED! - %s\n", mod_name, sql, sqlite3_errmsg(db));
+        *pstmt = 0;
+        return 1;
+    }
+    return 0;
+}
+
+int cf_sqlite::step( sqlite3_stmt *stmt )
+{
+    int rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+    if ((rc != SQLITE_DONE) && (rc != SQLITE_ROW)) {
+        SPRTF("%s: Step FAILED! - %s\n", mod_name, sqlite3_errmsg(db));
+        return 1;
+    }
+    return 0;
+}
+
+int cf_sqlite::begin_trans()
+{
+    return db_exec("BEGIN;", NULL, 0);
+}
+
+int cf_sqlite::commit_trans()
+{
+    return db_exec("COMMIT;", NULL, 0);
+}
+
+void cf_sqlite::rollback_trans()
+{
+    db_exec("ROLLBACK;", NULL, 0);
+}
+
 // eof - cf_sqlite.cxx
 
 
@@ -26,6 +26,14 @@ public:
     int db_exec( const char *sql, SQLCB sqlcb,
                     void *vp, char **errmsg = 0, double *diff = 0 );
     void set_sql_cb( SQLCB sqlcb ) { sql_cb = sqlcb; }
+    // for batched writes with prepared statements
+    sqlite3 *get_db() { return db; }
+    int set_wal();  // WAL journal, synchronous=NORMAL, and a busy timeout
+    int prepare( const char *sql, sqlite3_stmt **pstmt );
+    int step( sqlite3_stmt *stmt );  // step, then reset for the next bind
+    int begin_trans();
+    int commit_trans();
+    void rollback_trans();
     int query_count;
     double total_secs_in_query;
     int m_iMax_Retries, iBusy_Retries;
@@ -0,0 +1,114 @@
+// cf_trace.cxx
+// Binary journal of pilot events
+// Records are copied into a block buffer, which is written when full,
+// so the cost per event is essentially a memcpy().
+
+#include <stdio.h>
+#include <stdlib.h> // free(), ...
+#include <string.h> // memcpy(), strdup(), ...
+#include "sprtf.hxx"
+#include "cf_trace.hxx"
+
+static const char *mod_name = "cf_trace";
+
+#ifndef TRACE_BLOCK_RECS
+#define TRACE_BLOCK_RECS 4096   // 256 KB per write
+#endif
+
+static FILE *trace_fp = 0;
+static char *trace_file = 0;
+static CF_TRACE_REC trace_block[TRACE_BLOCK_RECS];
+static size_t trace_used = 0;
+size_t trace_count = 0;
+bool trace_on = false;
+
+static const char *sTraceEvent[tev_Max] = {
+    "NONE", "NEW", "POS", "REVIVED", "DISC", "EXPIRED"
+};
+
+static const char *sTraceReason[trr_Max] = {
+    "", "TIME", "DIST", "SPDC", "HDGC", "ALTC"
+};
+
+const char *trace_event_stg( int ev )
+{
+    if ((ev >= 0) && (ev < tev_Max))
+        return sTraceEvent[ev];
+    return "UNKNOWN";
+}
+
+const char *trace_reason_stg( int reason )
+{
+    if ((reason >= 0) && (reason < trr_Max))
+        return sTraceReason[reason];
+    return "UNKNOWN";
+}
+
+int trace_open( const char *file )
+{
+    CF_TRACE_HDR hdr;
+    trace_close();
+    trace_fp = fopen(file,"wb");
+    if (!trace_fp) {
+        SPRTF("%s: Failed to create journal '%s'!\n", mod_name, file);
+        return 1;
+    }
+    memset(&hdr,0,sizeof(hdr));
+    memcpy(hdr.magic,CF_TRACE_MAGIC,4);
+    hdr.version = CF_TRACE_VERSION;
+    hdr.rec_size = (uint16_t)sizeof(CF_TRACE_REC);
+    hdr.bom = CF_TRACE_BOM;
+    if (fwrite(&hdr,1,sizeof(hdr),trace_fp) != sizeof(hdr)) {
+        SPRTF("%s: Failed to write journal header to '%s'!\n", mod_name, file);
+        fclose(trace_fp);
+        trace_fp = 0;
+        return 1;
+    }
+    trace_file = strdup(file);
+    trace_used = 0;
+    trace_count = 0;
+    trace_on = true;
+    SPRTF("%s: Writing pilot event journal to '%s'\n", mod_name, trace_file);
+    return 0;
+}
+
+void trace_flush()
+{
+    if (trace_fp && trace_used) {
+        size_t wtn = fwrite(trace_block,sizeof(CF_TRACE_REC),trace_used,trace_fp);
+        if (wtn != trace_used) {
+            SPRTF("%s: Failed write to journal '%s'! Closing it...\n", mod_name, trace_file);
+            fclose(trace_fp);
+            trace_fp = 0;
+            trace_on = false;
+        } else
+            fflush(trace_fp);
+    }
+    trace_used = 0;
+}
+
+void trace_add( PCF_TRACE_REC ptr )
+{
+    if (!trace_on)
+        return;
+    memcpy(&trace_block[trace_used++],ptr,sizeof(CF_TRACE_REC));
+    trace_count++;
+    if (trace_used >= TRACE_BLOCK_RECS)
+        trace_flush();
+}
+
+void trace_close()
+{
+    if (trace_fp) {
+        trace_flush();
+        fclose(trace_fp);
+        SPRTF("%s: Closed journal '%s', with %d records.\n", mod_name, trace_file, (int)trace_count);
+    }
+    trace_fp = 0;
+    trace_on = false;
+    if (trace_file)
+        free(trace_file);
+    trace_file = 0;
+}
+
+// eof - cf_trace.cxx
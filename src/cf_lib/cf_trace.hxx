@@ -0,0 +1,70 @@
+// cf_trace.hxx
+// Binary journal of pilot events - NEW, position, DISC, EXPIRED, ...
+// One fixed size record per event, buffered, and written in blocks.
+// Use the cf-trace utility to render a journal as text or csv.
+#ifndef _CF_TRACE_HXX_
+#define _CF_TRACE_HXX_
+#include <stdint.h>
+#include <stddef.h>
+
+#define CF_TRACE_MAGIC   "CFTR"
+#define CF_TRACE_VERSION 1
+#define CF_TRACE_BOM     0x01020304  // records are in host byte order
+#define CF_TRACE_CS_LEN  8           // same as MAX_CALLSIGN_LEN
+
+enum Trace_Event {
+    tev_None,
+    tev_New,        // first packet of a flight
+    tev_Pos,        // position update accepted
+    tev_Revived,    // expired flight seen again
+    tev_Disc,       // position packet discarded
+    tev_Expired,    // flight expired
+    tev_Max
+};
+
+// why a position update was accepted
+enum Trace_Reason {
+    trr_None,
+    trr_TIME,
+    trr_DIST,
+    trr_SPDC,
+    trr_HDGC,
+    trr_ALTC,
+    trr_Max
+};
+
+// file header - 16 bytes
+typedef struct tagCF_TRACE_HDR {
+    char     magic[4];      // CF_TRACE_MAGIC
+    uint16_t version;       // CF_TRACE_VERSION
+    uint16_t rec_size;      // sizeof(CF_TRACE_REC)
+    uint32_t bom;           // CF_TRACE_BOM
+    uint32_t reserved;
+}CF_TRACE_HDR, *PCF_TRACE_HDR;
+
+// one record per event - 64 bytes
+typedef struct tagCF_TRACE_REC {
+    uint64_t epoch_usecs;   // coarse wall time of the event, the sim driven clock in a fast replay
+    double   sim_time;      // sim time from the packet
+    uint64_t flight_id;     // unique flight ID
+    char     callsign[CF_TRACE_CS_LEN]; // may NOT be zero terminated
+    double   lat, lon;      // degrees
+    float    alt;           // feet
+    float    speed;         // knots
+    int32_t  value;         // reason value - secs, meters, knots, degrees or feet
+    uint8_t  event;         // Trace_Event
+    uint8_t  reason;        // Trace_Reason
+    uint16_t heading;       // degrees
+}CF_TRACE_REC, *PCF_TRACE_REC;
+
+extern int trace_open( const char *file ); // 0 = success
+extern void trace_close();
+extern void trace_flush();
+extern void trace_add( PCF_TRACE_REC ptr ); // copy into the journal buffer
+extern const char *trace_event_stg( int ev );
+extern const char *trace_reason_stg( int reason );
+extern size_t trace_count;  // records added since open
+extern bool trace_on;       // journal is open
+
+#endif // #ifndef _CF_TRACE_HXX_
+// eof - cf_trace.hxx
@@ -0,0 +1,467 @@
+// cf_tracker.cxx
+// Flight tracker persistence stage - see cf_tracker.hxx
+// tracker_add() only copies the record into the queue. The writer thread
+// swaps the whole queue out, under the lock, then writes it as one
+// transaction, outside the lock, to the sqlite3 or PostgreSQL backend.
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include "sprtf.hxx"
+#include "cf_misc.hxx"
+#include "cf_tracker.hxx"
+
+static const char *mod_name = "cf_tracker";
+
+#ifndef TRACK_WAKE_RECS
+#define TRACK_WAKE_RECS 8192    // write a batch this big without waiting
+#endif
+
+typedef std::vector<TRACK_REC> vTRACK;
+
+static std::mutex track_mutex;
+static std::condition_variable track_cv;
+static std::thread *track_thread = 0;
+static vTRACK vQueue;           // filled by tracker_add()
+static bool track_stop = false;
+bool tracker_on = false;
+
+// stats - all under track_mutex
+static size_t queued = 0, dropped = 0, written = 0, failed = 0;
+static size_t batches = 0, max_batch = 0;
+static double secs_in_db = 0.0;
+
+/////////////////////////////////////////////////////////////////////////
+// database backends
+// open(), write() and close(), only ever called by one thread at a
+// time - tracker_open(), then the writer, then tracker_close()
+typedef struct tagTRACK_DB {
+    const char *name;
+    int  (*open)( const char *spec );
+    int  (*write)( vTRACK &v );
+    void (*close)();
+}TRACK_DB, *PTRACK_DB;
+
+static PTRACK_DB track_be = 0;
+
+#ifdef USE_SQLITE_TRACKER
+#include "cf_sqlite.hxx"
+
+static const char *ct_flights =
+    "CREATE TABLE IF NOT EXISTS flights ("
+    "f_pk INTEGER PRIMARY KEY, "
+    "fid INTEGER NOT NULL UNIQUE, "
+    "callsign TEXT NOT NULL, "
+    "model TEXT, "
+    "status TEXT NOT NULL, "
+    "start_time INTEGER, "
+    "end_time INTEGER);";
+static const char *ct_positions =
+    "CREATE TABLE IF NOT EXISTS positions ("
+    "p_pk INTEGER PRIMARY KEY, "
+    "fid INTEGER NOT NULL, "
+    "ts INTEGER NOT NULL, "
+    "lat REAL, "
+    "lon REAL, "
+    "alt_ft INTEGER, "
+    "spd_kts INTEGER, "
+    "hdg INTEGER);"
+    "CREATE INDEX IF NOT EXISTS positions_fid ON positions (fid);";
+
+static const char *ins_flight_sql =
+    "INSERT OR IGNORE INTO flights (fid,callsign,model,status,start_time) "
+    "VALUES (?1,?2,?3,'OPEN',?4);";
+static const char *ins_position_sql =
+    "INSERT INTO positions (fid,ts,lat,lon,alt_ft,spd_kts,hdg) "
+    "VALUES (?1,?2,?3,?4,?5,?6,?7);";
+static const char *close_flight_sql =
+    "UPDATE flights SET status='CLOSED', end_time=?2 WHERE fid=?1;";
+
+static cf_sqlite *track_db = 0;
+static sqlite3_stmt *ins_flight = 0;
+static sqlite3_stmt *ins_position = 0;
+static sqlite3_stmt *close_flight = 0;
+
+static void sqlite_close()
+{
+    sqlite3_finalize(ins_flight);
+    sqlite3_finalize(ins_position);
+    sqlite3_finalize(close_flight);
+    ins_flight = ins_position = close_flight = 0;
+    if (track_db) {
+        track_db->close_db();
+        delete track_db;
+    }
+    track_db = 0;
+}
+
+static int sqlite_open( const char *file )
+{
+    track_db = new cf_sqlite;
+    track_db->set_db_name((char *)file);
+    track_db->set_ct_flights((char *)ct_flights);
+    track_db->set_ct_positions((char *)ct_positions);
+    if (track_db->open_db(true) ||
+        track_db->set_wal() ||
+        track_db->db_exec(ct_flights, NULL, 0) ||   // if an old db, without them
+        track_db->db_exec(ct_positions, NULL, 0) ||
+        track_db->prepare(ins_flight_sql, &ins_flight) ||
+        track_db->prepare(ins_position_sql, &ins_position) ||
+        track_db->prepare(close_flight_sql, &close_flight)) {
+        sqlite_close();
+        return 1;
+    }
+    return 0;
+}
+
+static int sqlite_write( vTRACK &v )
+{
+    size_t ii, max = v.size();
+    int res = 0;
+    if (track_db->begin_trans())
+        return 1;
+    for (ii = 0; (ii < max) && !res; ii++) {
+        PTRACK_REC pr = &v[ii];
+        sqlite3_int64 fid = (sqlite3_int64)pr->flight_id;
+        if (pr->event == tkv_Disconnect) {
+            sqlite3_bind_int64(close_flight, 1, fid);
+            sqlite3_bind_int64(close_flight, 2, pr->epoch);
+            res |= track_db->step(close_flight);
+            continue;
+        }
+        if (pr->event == tkv_Connect) {
+            sqlite3_bind_int64(ins_flight, 1, fid);
+            sqlite3_bind_text(ins_flight, 2, pr->callsign, -1, SQLITE_STATIC);
+            sqlite3_bind_text(ins_flight, 3, pr->model, -1, SQLITE_STATIC);
+            sqlite3_bind_int64(ins_flight, 4, pr->epoch);
+            res |= track_db->step(ins_flight);
+        }
+        sqlite3_bind_int64(ins_position, 1, fid);
+        sqlite3_bind_int64(ins_position, 2, pr->epoch);
+        sqlite3_bind_double(ins_position, 3, pr->lat);
+        sqlite3_bind_double(ins_position, 4, pr->lon);
+        sqlite3_bind_int(ins_position, 5, (int)(pr->alt + 0.5f));
+        sqlite3_bind_int(ins_position, 6, (int)(pr->speed + 0.5f));
+        sqlite3_bind_int(ins_position, 7, pr->heading);
+        res |= track_db->step(ins_position);
+    }
+    if (res) {
+        track_db->rollback_trans();
+        return 1;
+    }
+    return track_db->commit_trans();
+}
+
+static TRACK_DB sqlite_db = { "sqlite3", sqlite_open, sqlite_write, sqlite_close };
+#endif // USE_SQLITE_TRACKER
+
+#ifdef USE_PG_TRACKER
+#include "cf_postgres.hxx"
+#include "mpMsgs.hxx"
+#include "tiny_xdr.hxx"
+
+// Flight connect and disconnect are few, so are pipelined prepared
+// statements, but positions are many, so are streamed with COPY, in
+// the binary format, to skip all the text conversions on the server
+static const char *pg_ct_flights =
+    "CREATE TABLE IF NOT EXISTS flights ("
+    "f_pk BIGSERIAL PRIMARY KEY, "
+    "fid BIGINT NOT NULL UNIQUE, "
+    "callsign VARCHAR(16) NOT NULL, "
+    "model VARCHAR(32), "
+    "status VARCHAR(8) NOT NULL, "
+    "start_time BIGINT, "
+    "end_time BIGINT);";
+static const char *pg_ct_positions =
+    "CREATE TABLE IF NOT EXISTS positions ("
+    "p_pk BIGSERIAL PRIMARY KEY, "
+    "fid BIGINT NOT NULL, "
+    "ts BIGINT NOT NULL, "
+    "lat DOUBLE PRECISION, "
+    "lon DOUBLE PRECISION, "
+    "alt_ft INTEGER, "
+    "spd_kts INTEGER, "
+    "hdg INTEGER);"
+    "CREATE INDEX IF NOT EXISTS positions_fid ON positions (fid);";
+
+static const char *pg_ins_flight_sql =
+    "INSERT INTO flights (fid,callsign,model,status,start_time) "
+    "VALUES ($1,$2,$3,'OPEN',$4) ON CONFLICT (fid) DO NOTHING;";
+static const char *pg_close_flight_sql =
+    "UPDATE flights SET status='CLOSED', end_time=$2 WHERE fid=$1;";
+static const char *pg_copy_sql =
+    "COPY positions (fid,ts,lat,lon,alt_ft,spd_kts,hdg) FROM STDIN (FORMAT binary);";
+
+#define PG_COPY_FIELDS  7
+#define PG_COPY_ROW     (2 + (4 * 12) + (3 * 8))   // 74 bytes
+#ifndef PG_COPY_BUF
+#define PG_COPY_BUF     (64 * 1024)
+#endif
+
+static cf_postgres *track_pg = 0;
+static char pg_copy_buf[PG_COPY_BUF];
+
+// COPY binary fields are a 32-bit length, then the value, in network order
+static char *pg_put16( char *cp, int16_t val )
+{
+    uint16_t v = NET_encode16(val);
+    memcpy(cp, &v, 2);
+    return cp + 2;
+}
+static char *pg_put32( char *cp, int32_t val )
+{
+    uint32_t v = NET_encode32(val);
+    memcpy(cp, &v, 4);
+    return cp + 4;
+}
+static char *pg_put_int4( char *cp, int32_t val )
+{
+    cp = pg_put32(cp, 4);
+    return pg_put32(cp, val);
+}
+static char *pg_put_int8( char *cp, int64_t val )
+{
+    uint64_t v = NET_encode64(val);
+    cp = pg_put32(cp, 8);
+    memcpy(cp, &v, 8);
+    return cp + 8;
+}
+static char *pg_put_float8( char *cp, double val )
+{
+    uint64_t v = NET_encode64(val);
+    cp = pg_put32(cp, 8);
+    memcpy(cp, &v, 8);
+    return cp + 8;
+}
+
+static void pg_close()
+{
+    if (track_pg)
+        delete track_pg;    // and db_close()
+    track_pg = 0;
+}
+
+static int pg_open( const char *conninfo )
+{
+    track_pg = new cf_postgres;
+    track_pg->set_conninfo(conninfo);
+    if (track_pg->db_open() ||
+        track_pg->db_exec(pg_ct_flights) ||
+        track_pg->db_exec(pg_ct_positions) ||
+        track_pg->prepare("ins_flight", pg_ins_flight_sql, 4) ||
+        track_pg->prepare("close_flight", pg_close_flight_sql, 2)) {
+        pg_close();
+        return 1;
+    }
+    return 0;
+}
+
+static int pg_write_flights( vTRACK &v )
+{
+    size_t ii, max = v.size();
+    char fid[32], epoch[32];
+    const char *vals[4];
+    int res = 0;
+    bool piped = false;
+    for (ii = 0; ii < max; ii++) {
+        PTRACK_REC pr = &v[ii];
+        if (pr->event == tkv_Position)
+            continue;
+        if (!piped) {
+            if (track_pg->pipeline_begin())
+                return 1;
+            piped = true;
+        }
+        sprintf(fid, "%lld", (long long)pr->flight_id);
+        sprintf(epoch, "%lld", (long long)pr->epoch);
+        vals[0] = fid;
+        if (pr->event == tkv_Disconnect) {
+            vals[1] = epoch;
+            res |= track_pg->pipeline_send("close_flight", 2, vals);
+        } else {
+            vals[1] = pr->callsign;
+            vals[2] = pr->model;
+            vals[3] = epoch;
+            res |= track_pg->pipeline_send("ins_flight", 4, vals);
+        }
+    }
+    if (piped)
+        res |= track_pg->pipeline_end();
+    return res;
+}
+
+static int pg_write_positions( vTRACK &v )
+{
+    static const char sig[11] = { 'P','G','C','O','P','Y','\n','\377','\r','\n','\0' };
+    size_t ii, max = v.size();
+    char *cp = pg_copy_buf;
+    char *end = pg_copy_buf + PG_COPY_BUF - PG_COPY_ROW - 2;  // and trailer
+    int res;
+    if (track_pg->copy_begin(pg_copy_sql))
+        return 1;
+    memcpy(cp, sig, 11);
+    cp = pg_put32(cp + 11, 0);  // flags
+    cp = pg_put32(cp, 0);       // header extension length
+    for (ii = 0; ii < max; ii++) {
+        PTRACK_REC pr = &v[ii];
+        if (pr->event == tkv_Disconnect)
+            continue;
+        if (cp > end) {
+            if (track_pg->copy_data(pg_copy_buf, (int)(cp - pg_copy_buf))) {
+                track_pg->copy_end();
+                return 1;
+            }
+            cp = pg_copy_buf;
+        }
+        cp = pg_put16(cp, PG_COPY_FIELDS);
+        cp = pg_put_int8(cp, (int64_t)pr->flight_id);
+        cp = pg_put_int8(cp, pr->epoch);
+        cp = pg_put_float8(cp, pr->lat);
+        cp = pg_put_float8(cp, pr->lon);
+        cp = pg_put_int4(cp, (int32_t)(pr->alt + 0.5f));
+        cp = pg_put_int4(cp, (int32_t)(pr->speed + 0.5f));
+        cp = pg_put_int4(cp, pr->heading);
+    }
+    cp = pg_put16(cp, -1);  // trailer
+    res = track_pg->copy_data(pg_copy_buf, (int)(cp - pg_copy_buf));
+    res |= track_pg->copy_end();
+    return res;
+}
+
+static int pg_write( vTRACK &v )
+{
+    if (track_pg->db_exec("BEGIN;"))
+        return 1;
+    if (pg_write_flights(v) || pg_write_positions(v)) {
+        track_pg->db_exec("ROLLBACK;");
+        return 1;
+    }
+    return track_pg->db_exec("COMMIT;");
+}
+
+static TRACK_DB pg_db = { "PostgreSQL", pg_open, pg_write, pg_close };
+#endif // USE_PG_TRACKER
+
+// choose the backend - "pg:<conninfo>" for PostgreSQL, else a sqlite3 file
+static PTRACK_DB get_backend( const char **pspec )
+{
+    if (strncmp(*pspec, "pg:", 3) == 0) {
+        *pspec += 3;
+#ifdef USE_PG_TRACKER
+        return &pg_db;
+#else
+        SPRTF("%s: No PostgreSQL support compiled in! Configure with -DUSE_PG_TRACKER=ON\n", mod_name);
+        return 0;
+#endif
+    }
+#ifdef USE_SQLITE_TRACKER
+    return &sqlite_db;
+#else
+    SPRTF("%s: No sqlite3 support compiled in! Configure with -DUSE_SQLITE_TRACKER=ON\n", mod_name);
+    return 0;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////
+// the writer thread
+static void tracker_writer()
+{
+    vTRACK batch;
+    bool stop = false;
+    double t1, secs;
+    int res;
+    while (!stop) {
+        {
+            std::unique_lock<std::mutex> lock(track_mutex);
+            track_cv.wait_for(lock, std::chrono::milliseconds(TRACK_COMMIT_MS),
+                [] { return track_stop || (vQueue.size() >= TRACK_WAKE_RECS); });
+            batch.swap(vQueue);     // and vQueue keeps the old capacity
+            stop = track_stop;
+        }
+        if (batch.empty())
+            continue;
+        t1 = get_seconds();
+        res = track_be->write(batch);
+        secs = get_seconds() - t1;
+        {
+            std::lock_guard<std::mutex> lock(track_mutex);
+            if (res)
+                failed += batch.size();
+            else
+                written += batch.size();
+            batches++;
+            if (batch.size() > max_batch)
+                max_batch = batch.size();
+            secs_in_db += secs;
+        }
+        batch.clear();
+    }
+}
+
+int tracker_open( const char *db_spec )
+{
+    const char *spec = db_spec;
+    tracker_close();
+    track_be = get_backend(&spec);
+    if (!track_be || track_be->open(spec))
+        return 1;
+    track_stop = false;
+    vQueue.reserve(TRACK_WAKE_RECS * 2);
+    track_thread = new std::thread(tracker_writer);
+    tracker_on = true;
+    SPRTF("%s: Recording flights to %s database\n", mod_name, track_be->name);
+    return 0;
+}
+
+void tracker_close()
+{
+    if (!track_thread)
+        return;
+    tracker_on = false;
+    {
+        std::lock_guard<std::mutex> lock(track_mutex);
+        track_stop = true;
+    }
+    track_cv.notify_one();
+    track_thread->join();   // writes all still queued
+    delete track_thread;
+    track_thread = 0;
+    track_be->close();
+    tracker_show_stats();
+}
+
+void tracker_add( PTRACK_REC ptr )
+{
+    bool wake;
+    if (!tracker_on)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(track_mutex);
+        if (vQueue.size() >= TRACK_MAX_QUEUE) {
+            dropped++;
+            return;
+        }
+        vQueue.push_back(*ptr);
+        queued++;
+        wake = (vQueue.size() == TRACK_WAKE_RECS);
+    }
+    if (wake)
+        track_cv.notify_one();
+}
+
+void tracker_show_stats()
+{
+    std::lock_guard<std::mutex> lock(track_mutex);
+    if (!queued && !dropped)
+        return;
+    SPRTF("%s: %d queued, %d written, %d dropped, %d failed, in %d batches, max %d, %s in db, %.0f rows/s\n", mod_name,
+        (int)queued, (int)written, (int)dropped, (int)failed, (int)batches, (int)max_batch,
+        get_seconds_stg(secs_in_db),
+        (secs_in_db > 0.0) ? (double)written / secs_in_db : 0.0 );
+}
+
+// eof - cf_tracker.cxx
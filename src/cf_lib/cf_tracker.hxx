@@ -0,0 +1,49 @@
+// cf_tracker.hxx
+// Flight tracker persistence stage
+// Accepted position updates, and flight connect and disconnect events,
+// are copied into a bounded queue by the packet decode thread, and a
+// writer thread drains it into the database, in one transaction per
+// batch. The decode thread never waits on the database - if the queue
+// is full the record is dropped, and counted.
+#ifndef _CF_TRACKER_HXX_
+#define _CF_TRACKER_HXX_
+#include <stdint.h>
+#include <stddef.h>
+
+#define TRACK_CS_LEN    8   // same as MAX_CALLSIGN_LEN
+#define TRACK_MODEL_LEN 32
+
+#ifndef TRACK_MAX_QUEUE
+#define TRACK_MAX_QUEUE (1 << 18)   // records, before dropping
+#endif
+#ifndef TRACK_COMMIT_MS
+#define TRACK_COMMIT_MS 1000        // max wait before a batch is written
+#endif
+
+enum Track_Event {
+    tkv_Connect,    // new, or revived, flight, and its first position
+    tkv_Position,   // position update accepted
+    tkv_Disconnect  // flight expired
+};
+
+typedef struct tagTRACK_REC {
+    uint64_t flight_id;     // unique flight ID
+    int64_t  epoch;         // seconds
+    double   lat, lon;      // degrees
+    float    alt;           // feet
+    float    speed;         // knots
+    uint16_t heading;       // degrees
+    uint8_t  event;         // Track_Event
+    char     callsign[TRACK_CS_LEN+1];  // only for tkv_Connect
+    char     model[TRACK_MODEL_LEN];    // only for tkv_Connect
+}TRACK_REC, *PTRACK_REC;
+
+// db_spec is a sqlite3 file, or "pg:" then a libpq connection string
+extern int tracker_open( const char *db_spec ); // 0 = success, and writer started
+extern void tracker_close();    // write all queued, and stop the writer
+extern void tracker_add( PTRACK_REC ptr );  // copy into the queue
+extern void tracker_show_stats();
+extern bool tracker_on;         // writer is running
+
+#endif // #ifndef _CF_TRACKER_HXX_
+// eof - cf_tracker.hxx
@@ -0,0 +1,410 @@
+// cf_tracks.cxx
+// Append-only track store - see cf_tracks.hxx
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "sprtf.hxx"
+#include "cf_misc.hxx"
+#include "cf_tracks.hxx"
+
+static const char *mod_name = "cf_tracks";
+
+#define TRACKS_LL_SCALE  1e5    // 1e-5 degree, about 1.1 m
+#define TRACKS_SIM_SCALE 100.0  // 1/100 second
+
+// a flight's open segment
+typedef struct tagTRACK_SEG {
+    TRACK_SEG_HDR hdr;
+    uint32_t t_last;
+    int64_t  psim, plat, plon, palt, pspd, phdg; // previous, quantized
+    std::string data;       // encoded points
+}TRACK_SEG, *PTRACK_SEG;
+
+typedef std::unordered_map<uint64_t,TRACK_SEG> mTRACKSEG;
+
+static mTRACKSEG mSegs;
+static std::string tracks_dir;
+static FILE *dat_fp = 0;
+static FILE *idx_fp = 0;
+static uint64_t dat_size = 0;
+static time_t cur_hour = 0;
+bool tracks_on = false;
+
+// stats
+static size_t points = 0, seg_points = 0, segments = 0, queries = 0;
+static uint64_t bytes = 0;
+static double query_secs = 0.0;
+
+/////////////////////////////////////////////////////////////////////////
+// zigzag varint
+static void put_varint( std::string &s, int64_t val )
+{
+    uint64_t v = ((uint64_t)val << 1) ^ (uint64_t)(val >> 63);
+    while (v >= 0x80) {
+        s += (char)((v & 0x7f) | 0x80);
+        v >>= 7;
+    }
+    s += (char)v;
+}
+
+static bool get_varint( const uint8_t **pp, const uint8_t *end, int64_t *pval )
+{
+    const uint8_t *p = *pp;
+    uint64_t v = 0;
+    int shift = 0;
+    while (p < end) {
+        uint8_t b = *p++;
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            *pp = p;
+            *pval = (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+            return true;
+        }
+        shift += 7;
+        if (shift > 63)
+            break;
+    }
+    return false;
+}
+
+static int64_t quant( double val, double scale )
+{
+    return (int64_t)(val * scale + ((val < 0.0) ? -0.5 : 0.5));
+}
+
+/////////////////////////////////////////////////////////////////////////
+// hourly partitions
+static std::string part_name( time_t hour, const char *ext )
+{
+    char buf[64];
+    time_t t = hour * 3600;
+    struct tm *ptm = gmtime(&t);
+    sprintf(buf, "trk-%04d%02d%02d%02d.%s", ptm->tm_year + 1900, ptm->tm_mon + 1,
+        ptm->tm_mday, ptm->tm_hour, ext);
+    return tracks_dir + buf;
+}
+
+static void close_part()
+{
+    if (dat_fp)
+        fclose(dat_fp);
+    if (idx_fp)
+        fclose(idx_fp);
+    dat_fp = idx_fp = 0;
+}
+
+static int open_part( time_t hour )
+{
+    std::string dat = part_name(hour, "dat");
+    std::string idx = part_name(hour, "idx");
+    close_part();
+    dat_fp = fopen(dat.c_str(), "ab");
+    idx_fp = fopen(idx.c_str(), "ab");
+    if (!dat_fp || !idx_fp) {
+        SPRTF("%s: Failed to open '%s', or .idx, for append! Track store off.\n", mod_name, dat.c_str());
+        close_part();
+        tracks_on = false;
+        return 1;
+    }
+    fseek(dat_fp, 0, SEEK_END);
+    dat_size = (uint64_t)ftell(dat_fp);
+    cur_hour = hour;
+    return 0;
+}
+
+static void write_seg( PTRACK_SEG ps )
+{
+    TRACK_IDX_REC rec;
+    if (!ps->hdr.count || !dat_fp)
+        return;
+    ps->hdr.len = (uint32_t)ps->data.size();
+    rec.flight_id = ps->hdr.flight_id;
+    rec.t_first   = ps->hdr.epoch;
+    rec.t_last    = ps->t_last;
+    rec.offset    = dat_size;
+    rec.len       = (uint32_t)(sizeof(TRACK_SEG_HDR) + ps->data.size());
+    rec.count     = ps->hdr.count;
+    fwrite(&ps->hdr, sizeof(TRACK_SEG_HDR), 1, dat_fp);
+    fwrite(ps->data.data(), 1, ps->data.size(), dat_fp);
+    fwrite(&rec, sizeof(rec), 1, idx_fp);
+    dat_size += rec.len;
+    bytes += rec.len;
+    seg_points += ps->hdr.count;
+    segments++;
+    ps->hdr.count = 0;
+    ps->data.clear();
+}
+
+// all segments go in the hour of their first point
+static void write_all()
+{
+    mTRACKSEG::iterator it;
+    for (it = mSegs.begin(); it != mSegs.end(); it++)
+        write_seg(&it->second);
+}
+
+/////////////////////////////////////////////////////////////////////////
+int tracks_open( const char *dir )
+{
+    tracks_close();
+    if (is_file_or_directory((char *)dir) != DT_DIR) {
+        SPRTF("%s: Track store directory '%s' does NOT exist!\n", mod_name, dir);
+        return 1;
+    }
+    tracks_dir = dir;
+    if (tracks_dir.size() && (tracks_dir[tracks_dir.size() - 1] != '/') &&
+        (tracks_dir[tracks_dir.size() - 1] != '\\'))
+        tracks_dir += '/';
+    cur_hour = 0;
+    tracks_on = true;
+    SPRTF("%s: Keeping flight tracks in '%s'\n", mod_name, tracks_dir.c_str());
+    return 0;
+}
+
+void tracks_close()
+{
+    if (!tracks_on)
+        return;
+    write_all();
+    close_part();
+    mSegs.clear();
+    tracks_on = false;
+    tracks_show_stats();
+}
+
+void tracks_add( uint64_t fid, const char *callsign, time_t epoch, double sim_time,
+    double lat, double lon, double alt, double speed, double heading )
+{
+    if (!tracks_on)
+        return;
+    time_t hour = epoch / 3600;
+    if (hour != cur_hour) {
+        write_all();
+        if (open_part(hour))
+            return;
+    }
+    PTRACK_SEG ps = &mSegs[fid];
+    if (!ps->hdr.count) {
+        ps->hdr.magic     = TRACKS_MAGIC;
+        ps->hdr.flags     = 0;
+        ps->hdr.flight_id = fid;
+        memcpy(ps->hdr.callsign, callsign, TRACKS_CS_LEN);
+        ps->hdr.epoch     = (uint32_t)epoch;
+        ps->hdr.len       = 0;
+        ps->hdr.sim_time  = sim_time;
+        ps->psim = ps->plat = ps->plon = ps->palt = ps->pspd = ps->phdg = 0;
+    }
+    int64_t qsim = quant(sim_time - ps->hdr.sim_time, TRACKS_SIM_SCALE);
+    int64_t qlat = quant(lat, TRACKS_LL_SCALE);
+    int64_t qlon = quant(lon, TRACKS_LL_SCALE);
+    int64_t qalt = quant(alt, 1.0);
+    int64_t qspd = quant(speed, 1.0);
+    int64_t qhdg = quant(heading, 1.0) % 360;
+    int64_t dhdg = qhdg - ps->phdg;
+    if (dhdg > 180)
+        dhdg -= 360;
+    else if (dhdg < -180)
+        dhdg += 360;
+    put_varint(ps->data, qsim - ps->psim);
+    put_varint(ps->data, qlat - ps->plat);
+    put_varint(ps->data, qlon - ps->plon);
+    put_varint(ps->data, qalt - ps->palt);
+    put_varint(ps->data, qspd - ps->pspd);
+    put_varint(ps->data, dhdg);
+    ps->psim = qsim;
+    ps->plat = qlat;
+    ps->plon = qlon;
+    ps->palt = qalt;
+    ps->pspd = qspd;
+    ps->phdg = qhdg;
+    ps->t_last = (uint32_t)epoch;
+    ps->hdr.count++;
+    points++;
+    if (ps->hdr.count >= TRACKS_SEG_POINTS)
+        write_seg(ps);
+}
+
+void tracks_end( uint64_t fid )
+{
+    mTRACKSEG::iterator it;
+    if (!tracks_on)
+        return;
+    it = mSegs.find(fid);
+    if (it != mSegs.end()) {
+        write_seg(&it->second);
+        mSegs.erase(it);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////
+// read back
+typedef struct tagMAPPED {
+    const uint8_t *data;
+    size_t size;
+}MAPPED, *PMAPPED;
+
+static bool map_file( const std::string &file, PMAPPED pm )
+{
+    pm->data = 0;
+    pm->size = 0;
+#ifdef _WIN32
+    FILE *fp = fopen(file.c_str(), "rb");
+    if (!fp)
+        return false;
+    fseek(fp, 0, SEEK_END);
+    long len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (len > 0) {
+        uint8_t *buf = (uint8_t *)malloc(len);
+        if (buf && (fread(buf, 1, len, fp) == (size_t)len)) {
+            pm->data = buf;
+            pm->size = (size_t)len;
+        } else if (buf) {
+            free(buf);
+        }
+    }
+    fclose(fp);
+#else // !_WIN32
+    struct stat st;
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    if ((fstat(fd, &st) == 0) && (st.st_size > 0)) {
+        void *vp = mmap(0, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (vp != MAP_FAILED) {
+            pm->data = (const uint8_t *)vp;
+            pm->size = (size_t)st.st_size;
+        }
+    }
+    close(fd);
+#endif // _WIN32 y/n
+    return pm->data != 0;
+}
+
+static void unmap_file( PMAPPED pm )
+{
+    if (!pm->data)
+        return;
+#ifdef _WIN32
+    free((void *)pm->data);
+#else
+    munmap((void *)pm->data, pm->size);
+#endif
+    pm->data = 0;
+}
+
+// decode the points of a segment into the json array
+static int add_points( std::string &json, PTRACK_SEG_HDR ph, const uint8_t *p, const uint8_t *end )
+{
+    int64_t v[6], prev[6] = { 0, 0, 0, 0, 0, 0 };
+    char buf[128];
+    int i, n, cnt = 0;
+    for (n = 0; n < ph->count; n++) {
+        for (i = 0; i < 6; i++) {
+            if (!get_varint(&p, end, &v[i]))
+                return cnt;
+            prev[i] += v[i];
+        }
+        prev[5] = ((prev[5] % 360) + 360) % 360;
+        sprintf(buf, "%s[%.2f,%.5f,%.5f,%d,%d,%d]", json.size() && (json[json.size()-1] != '[') ? "," : "",
+            ph->sim_time + (double)prev[0] / TRACKS_SIM_SCALE,
+            (double)prev[1] / TRACKS_LL_SCALE, (double)prev[2] / TRACKS_LL_SCALE,
+            (int)prev[3], (int)prev[4], (int)prev[5]);
+        json += buf;
+        cnt++;
+    }
+    return cnt;
+}
+
+// search the hourly partitions, from the flight's start
+static int get_stored( uint64_t fid, std::string &json, std::string &cs )
+{
+    time_t hour, first = (time_t)(fid / 1000) / 3600;
+    time_t last = cur_hour ? cur_hour : first;
+    int cnt = 0;
+    if (last > first + TRACKS_MAX_HOURS)
+        last = first + TRACKS_MAX_HOURS;
+    for (hour = first; hour <= last; hour++) {
+        MAPPED idx, dat;
+        if (!map_file(part_name(hour, "idx"), &idx))
+            continue;
+        if (map_file(part_name(hour, "dat"), &dat)) {
+            size_t ii, max = idx.size / sizeof(TRACK_IDX_REC);
+            for (ii = 0; ii < max; ii++) {
+                TRACK_IDX_REC rec;
+                TRACK_SEG_HDR hdr;
+                memcpy(&rec, idx.data + ii * sizeof(rec), sizeof(rec));
+                if ((rec.flight_id != fid) || (rec.offset + rec.len > dat.size) ||
+                    (rec.len < sizeof(hdr)))
+                    continue;
+                memcpy(&hdr, dat.data + rec.offset, sizeof(hdr));
+                if (hdr.magic != TRACKS_MAGIC)
+                    continue;
+                if (cs.empty())
+                    cs.assign(hdr.callsign, strnlen(hdr.callsign, TRACKS_CS_LEN));
+                cnt += add_points(json, &hdr, dat.data + rec.offset + sizeof(hdr),
+                    dat.data + rec.offset + rec.len);
+            }
+            unmap_file(&dat);
+        }
+        unmap_file(&idx);
+    }
+    return cnt;
+}
+
+int tracks_get_json( uint64_t fid, std::string &json )
+{
+    std::string pts, cs;
+    char buf[128];
+    int cnt = 0;
+    double t1 = get_seconds();
+    if (tracks_on) {
+        if (dat_fp)
+            fflush(dat_fp);
+        if (idx_fp)
+            fflush(idx_fp);
+        cnt = get_stored(fid, pts, cs);
+        mTRACKSEG::iterator it = mSegs.find(fid);
+        if ((it != mSegs.end()) && it->second.hdr.count) {
+            PTRACK_SEG ps = &it->second;
+            const uint8_t *p = (const uint8_t *)ps->data.data();
+            if (cs.empty())
+                cs.assign(ps->hdr.callsign, strnlen(ps->hdr.callsign, TRACKS_CS_LEN));
+            cnt += add_points(pts, &ps->hdr, p, p + ps->data.size());
+        }
+    }
+    sprintf(buf, "{\"fid\":%llu,\"callsign\":\"", (unsigned long long)fid);
+    json = buf;
+    json += cs;
+    sprintf(buf, "\",\"points\":%d,\"fields\":[\"sim_time\",\"lat\",\"lon\",\"alt_ft\",\"spd_kts\",\"hdg\"],\"track\":[", cnt);
+    json += buf;
+    json += pts;
+    json += "]}\n";
+    queries++;
+    query_secs += get_seconds() - t1;
+    return cnt;
+}
+
+void tracks_show_stats()
+{
+    if (!points && !queries)
+        return;
+    SPRTF("%s: %d points, in %d segments, %.2f bytes per point, %d open, %d queries, avg %.3f ms\n", mod_name,
+        (int)points, (int)segments,
+        seg_points ? (double)bytes / (double)seg_points : 0.0,
+        (int)mSegs.size(), (int)queries,
+        queries ? query_secs * 1000.0 / (double)queries : 0.0 );
+}
+
+// eof - cf_tracks.cxx
@@ -0,0 +1,62 @@
+// cf_tracks.hxx
+// Append-only track store, for 'where was flight X' queries
+// Each accepted position is quantized - lat/lon to 1e-5 degree, alt,
+// speed and heading to whole units, sim time to 1/100 second - and
+// delta, zigzag varint, encoded against the flight's previous position,
+// in a segment of up to TRACKS_SEG_POINTS points. A full segment, or the
+// segment of an expired flight, is appended to the data file of the
+// current hour, and a fixed record to that hour's index file.
+//   <dir>/trk-YYYYMMDDHH.dat - TRACK_SEG_HDR, then the encoded points
+//   <dir>/trk-YYYYMMDDHH.idx - TRACK_IDX_REC per segment
+// Queries map the index and data files of each hour from the flight's
+// start, plus the points not yet written.
+// Not thread safe - add and query only from the packet decode thread.
+#ifndef _CF_TRACKS_HXX_
+#define _CF_TRACKS_HXX_
+#include <stdint.h>
+#include <time.h>
+#include <string>
+
+#define TRACKS_MAGIC      0x47455354    // "TSEG"
+#define TRACKS_CS_LEN     8             // same as MAX_CALLSIGN_LEN
+#ifndef TRACKS_SEG_POINTS
+#define TRACKS_SEG_POINTS 256
+#endif
+#ifndef TRACKS_MAX_HOURS
+#define TRACKS_MAX_HOURS  48    // hours of partitions a query will search
+#endif
+
+// segment header, in the data file - 40 bytes
+typedef struct tagTRACK_SEG_HDR {
+    uint32_t magic;         // TRACKS_MAGIC
+    uint16_t count;         // points
+    uint16_t flags;         // 0
+    uint64_t flight_id;
+    char     callsign[TRACKS_CS_LEN];   // may NOT be zero terminated
+    uint32_t epoch;         // wall time of the first point
+    uint32_t len;           // bytes of encoded points that follow
+    double   sim_time;      // sim time of the first point
+}TRACK_SEG_HDR, *PTRACK_SEG_HDR;
+
+// index record, one per segment - 32 bytes
+typedef struct tagTRACK_IDX_REC {
+    uint64_t flight_id;
+    uint32_t t_first;       // wall time of the first and last points
+    uint32_t t_last;
+    uint64_t offset;        // of the TRACK_SEG_HDR in the data file
+    uint32_t len;           // header and points
+    uint32_t count;         // points
+}TRACK_IDX_REC, *PTRACK_IDX_REC;
+
+extern int tracks_open( const char *dir );  // 0 = success
+extern void tracks_close();                 // write all open segments
+// callsign is TRACKS_CS_LEN chars, zero padded, as CF_Pilot has it
+extern void tracks_add( uint64_t fid, const char *callsign, time_t epoch, double sim_time,
+    double lat, double lon, double alt, double speed, double heading );
+extern void tracks_end( uint64_t fid );     // flight expired, write its segment
+extern int tracks_get_json( uint64_t fid, std::string &json );  // returns points
+extern void tracks_show_stats();
+extern bool tracks_on;
+
+#endif // #ifndef _CF_TRACKS_HXX_
+// eof - cf_tracks.hxx
@@ -11,33 +11,60 @@ typedef unsigned long long uint64_t;
 typedef uint32_t    xdr_data_t;      /* 4 Bytes */
 typedef uint64_t    xdr_data2_t;     /* 8 Bytes */
 
+// host byte order, fixed at compile time. All MSVC targets are little endian
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define XDR_HOST_BIG_ENDIAN 1
+#endif
+#ifdef _MSC_VER
+#include <stdlib.h> // for _byteswap_ushort(), ...
+#endif
+
 inline uint16_t sg_bswap_16(uint16_t x) {
+#if defined(__GNUC__)
+    return __builtin_bswap16(x);
+#elif defined(_MSC_VER)
+    return _byteswap_ushort(x);
+#else
     x = (x >> 8) | (x << 8);
     return x;
+#endif
 }
 
 inline uint32_t sg_bswap_32(uint32_t x) {
+#if defined(__GNUC__)
+    return __builtin_bswap32(x);
+#elif defined(_MSC_VER)
+    return _byteswap_ulong(x);
+#else
     x = ((x >>  8) & 0x00FF00FFL) | ((x <<  8) & 0xFF00FF00L);
     x = (x >> 16) | (x << 16);
     return x;
+#endif
 }
 
 inline uint64_t sg_bswap_64(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_bswap64(x);
+#elif defined(_MSC_VER)
+    return _byteswap_uint64(x);
+#else
     x = ((x >>  8) & 0x00FF00FF00FF00FFLL) | ((x <<  8) & 0xFF00FF00FF00FF00LL);
     x = ((x >> 16) & 0x0000FFFF0000FFFFLL) | ((x << 16) & 0xFFFF0000FFFF0000LL);
     x = (x >> 32) | (x << 32);
     return x;
+#endif
 }
 
-
 inline bool sgIsLittleEndian() {
-    static const int sgEndianTest = 1;
-    return (*((char *) &sgEndianTest ) != 0);
+#ifdef XDR_HOST_BIG_ENDIAN
+    return false;
+#else
+    return true;
+#endif
 }
 
 inline bool sgIsBigEndian() {
-    static const int sgEndianTest = 1;
-    return (*((char *) &sgEndianTest ) == 0);
+    return !sgIsLittleEndian();
 }
 
 inline void sgEndianSwap(uint16_t *x) { *x = sg_bswap_16(*x); }
@@ -45,9 +72,15 @@ inline void sgEndianSwap(uint32_t *x) { *x = sg_bswap_32(*x); }
 inline void sgEndianSwap(uint64_t *x) { *x = sg_bswap_64(*x); }
 
 
-#define SWAP16(arg) sgIsLittleEndian() ? sg_bswap_16(arg) : arg
-#define SWAP32(arg) sgIsLittleEndian() ? sg_bswap_32(arg) : arg
-#define SWAP64(arg) sgIsLittleEndian() ? sg_bswap_64(arg) : arg
+#ifdef XDR_HOST_BIG_ENDIAN
+#define SWAP16(arg) (arg)
+#define SWAP32(arg) (arg)
+#define SWAP64(arg) (arg)
+#else
+#define SWAP16(arg) sg_bswap_16(arg)
+#define SWAP32(arg) sg_bswap_32(arg)
+#define SWAP64(arg) sg_bswap_64(arg)
+#endif
 
 #define XDR_BYTES_PER_UNIT  4
 
@@ -13,70 +13,60 @@
 //      For further reading on XDR read RFC 1832.
 //
 //////////////////////////////////////////////////////////////////////
+//      The byte order is fixed at compile time, in mpMsgs.hxx, the
+//      swaps are single bswap instructions, and the type punning
+//      is by memcpy, which compiles away, in place of unions.
+//////////////////////////////////////////////////////////////////////
+#include <string.h> // for memcpy()
 
 /**
  * xdr encode 8, 16 and 32 Bit values
  */
 template<typename TYPE>
-xdr_data_t XDR_encode ( TYPE Val )
+inline xdr_data_t XDR_encode ( TYPE Val )
 {
-        union
-        {
-                xdr_data_t      encoded;
-                TYPE            raw;
-        } tmp;
-
-        tmp.raw = Val;
-        tmp.encoded = SWAP32(tmp.encoded);
-        return (tmp.encoded);
+        static_assert(sizeof(TYPE) <= sizeof(xdr_data_t), "XDR_encode of more than 32 bits");
+        xdr_data_t encoded = 0;
+        memcpy(&encoded, &Val, sizeof(TYPE));
+        return SWAP32(encoded);
 }
 
 /**
  * xdr decode 8, 16 and 32 Bit values
  */
 template<typename TYPE>
-TYPE XDR_decode ( xdr_data_t Val )
+inline TYPE XDR_decode ( xdr_data_t Val )
 {
-        union
-        {
-                xdr_data_t      encoded;
-                TYPE            raw;
-        } tmp;
-
-        tmp.encoded = SWAP32(Val);
-        return (tmp.raw);
+        static_assert(sizeof(TYPE) <= sizeof(xdr_data_t), "XDR_decode of more than 32 bits");
+        TYPE raw;
+        xdr_data_t decoded = SWAP32(Val);
+        memcpy(&raw, &decoded, sizeof(TYPE));
+        return raw;
 }
 
 /**
  * xdr encode 64 Bit values
  */
 template<typename TYPE>
-xdr_data2_t XDR_encode64 ( TYPE Val )
+inline xdr_data2_t XDR_encode64 ( TYPE Val )
 {
-        union
-        {
-                xdr_data2_t     encoded;
-                TYPE            raw;
-        } tmp;
-
-        tmp.raw = Val;
-        tmp.encoded = SWAP64(tmp.encoded);
-        return (tmp.encoded);
+        static_assert(sizeof(TYPE) <= sizeof(xdr_data2_t), "XDR_encode64 of more than 64 bits");
+        xdr_data2_t encoded = 0;
+        memcpy(&encoded, &Val, sizeof(TYPE));
+        return SWAP64(encoded);
 }
 
 /**
  * xdr decode 64 Bit values
  */
 template<typename TYPE>
-TYPE XDR_decode64 ( xdr_data2_t Val )
+inline TYPE XDR_decode64 ( xdr_data2_t Val )
 {
-        union {
-            xdr_data2_t     encoded;
-            TYPE            raw;
-        } tmp;
-
-        tmp.encoded = SWAP64 (Val);
-        return (tmp.raw);
+        static_assert(sizeof(TYPE) <= sizeof(xdr_data2_t), "XDR_decode64 of more than 64 bits");
+        TYPE raw;
+        xdr_data2_t decoded = SWAP64(Val);
+        memcpy(&raw, &decoded, sizeof(TYPE));
+        return raw;
 }
 
 
@@ -91,17 +81,12 @@ TYPE XDR_decode64 ( xdr_data2_t Val )
  * (actually encodes nothing, just to satisfy the templates)
  */
 template<typename TYPE>
-uint8_t
+inline uint8_t
 NET_encode8 ( TYPE Val )
 {
-        union
-        {
-                uint8_t netbyte;
-                TYPE    raw;
-        } tmp;
-
-        tmp.raw = Val;
-        return (tmp.netbyte);
+        uint8_t netbyte = 0;
+        memcpy(&netbyte, &Val, 1);
+        return netbyte;
 }
 
 /**
@@ -109,121 +94,94 @@ NET_encode8 ( TYPE Val )
  * (actually decodes nothing, just to satisfy the templates)
  */
 template<typename TYPE>
-TYPE
+inline TYPE
 NET_decode8 ( uint8_t Val )
 {
-        union
-        {
-                uint8_t netbyte;
-                TYPE    raw;
-        } tmp;
-
-        tmp.netbyte = Val;
-        return (tmp.raw);
+        static_assert(sizeof(TYPE) == 1, "NET_decode8 of more than 8 bits");
+        TYPE raw;
+        memcpy(&raw, &Val, 1);
+        return raw;
 }
 
 /**
  * encode 16-Bit values to network byte order
  */
 template<typename TYPE>
-uint16_t
+inline uint16_t
 NET_encode16 ( TYPE Val )
 {
-        union
-        {
-                uint16_t        netbyte;
-                TYPE            raw;
-        } tmp;
-
-        tmp.raw = Val;
-        tmp.netbyte = SWAP16(tmp.netbyte);
-        return (tmp.netbyte);
+        static_assert(sizeof(TYPE) <= sizeof(uint16_t), "NET_encode16 of more than 16 bits");
+        uint16_t netbyte = 0;
+        memcpy(&netbyte, &Val, sizeof(TYPE));
+        return SWAP16(netbyte);
 }
 
 /**
  * decode 16-Bit values from network byte order
  */
 template<typename TYPE>
-TYPE
+inline TYPE
 NET_decode16 ( uint16_t Val )
 {
-        union
-        {
-                uint16_t        netbyte;
-                TYPE            raw;
-        } tmp;
-
-        tmp.netbyte = SWAP16(Val);
-        return (tmp.raw);
+        static_assert(sizeof(TYPE) <= sizeof(uint16_t), "NET_decode16 of more than 16 bits");
+        TYPE raw;
+        uint16_t netbyte = SWAP16(Val);
+        memcpy(&raw, &netbyte, sizeof(TYPE));
+        return raw;
 }
 
 /**
  * encode 32-Bit values to network byte order
  */
 template<typename TYPE>
-uint32_t
+inline uint32_t
 NET_encode32 ( TYPE Val )
 {
-        union
-        {
-                uint32_t        netbyte;
-                TYPE            raw;
-        } tmp;
-
-        tmp.raw = Val;
-        tmp.netbyte = SWAP32(tmp.netbyte);
-        return (tmp.netbyte);
+        static_assert(sizeof(TYPE) <= sizeof(uint32_t), "NET_encode32 of more than 32 bits");
+        uint32_t netbyte = 0;
+        memcpy(&netbyte, &Val, sizeof(TYPE));
+        return SWAP32(netbyte);
 }
 
 /**
  * decode 32-Bit values from network byte order
  */
 template<typename TYPE>
-TYPE
+inline TYPE
 NET_decode32 ( uint32_t Val )
 {
-        union
-        {
-                uint32_t        netbyte;
-                TYPE            raw;
-        } tmp;
-
-        tmp.netbyte = SWAP32(Val);
-        return (tmp.raw);
+        static_assert(sizeof(TYPE) <= sizeof(uint32_t), "NET_decode32 of more than 32 bits");
+        TYPE raw;
+        uint32_t netbyte = SWAP32(Val);
+        memcpy(&raw, &netbyte, sizeof(TYPE));
+        return raw;
 }
 
 /**
  * encode 64-Bit values to network byte order
  */
 template<typename TYPE>
-uint64_t
+inline uint64_t
 NET_encode64 ( TYPE Val )
 {
-        union
-        {
-                uint64_t        netbyte;
-                TYPE            raw;
-        } tmp;
-
-        tmp.raw = Val;
-        tmp.netbyte = SWAP64(tmp.netbyte);
-        return (tmp.netbyte);
+        static_assert(sizeof(TYPE) <= sizeof(uint64_t), "NET_encode64 of more than 64 bits");
+        uint64_t netbyte = 0;
+        memcpy(&netbyte, &Val, sizeof(TYPE));
+        return SWAP64(netbyte);
 }
 
 /**
  * decode 64-Bit values from network byte order
  */
 template<typename TYPE>
-TYPE
+inline TYPE
 NET_decode64 ( uint64_t Val )
 {
-        union
-        {
-                uint64_t        netbyte;
-                TYPE            raw;
-        } tmp;
-        tmp.netbyte = SWAP64(Val);
-        return (tmp.raw);
+        static_assert(sizeof(TYPE) <= sizeof(uint64_t), "NET_decode64 of more than 64 bits");
+        TYPE raw;
+        uint64_t netbyte = SWAP64(Val);
+        memcpy(&raw, &netbyte, sizeof(TYPE));
+        return raw;
 }
 
 
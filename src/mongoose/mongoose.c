@@ -114,6 +114,7 @@ typedef SOCKET sock_t;
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <sys/select.h>
+#include <sys/uio.h>    // For writev()
 #define closesocket(x) close(x)
 #define __cdecl
 #define INVALID_SOCKET (-1)
@@ -180,6 +181,9 @@ enum ns_event {
 struct ns_connection;
 typedef void (*ns_callback_t)(struct ns_connection *, enum ns_event, void *evp);
 
+// Called when data passed to ns_send_ref() is no longer referenced
+typedef void (*ns_release_t)(void *ref);
+
 struct ns_server {
   void *server_data;
   sock_t listening_sock;
@@ -200,6 +204,11 @@ struct ns_connection {
   SSL *ssl;
   void *connection_data;
   time_t last_io_time;
+  const char *ref_buf;      // Data sent by reference, see ns_send_ref()
+  size_t ref_len;
+  size_t ref_at;            // Bytes of send_iobuf that go before ref_buf
+  ns_release_t ref_release;
+  void *ref;
   unsigned int flags;
 #define NSF_FINISHED_SENDING_DATA   (1 << 0)
 #define NSF_BUFFER_BUT_DONT_SEND    (1 << 1)
@@ -226,6 +235,8 @@ struct ns_connection *ns_connect(struct ns_server *, const char *host,
                                  int port, int ssl, void *connection_param);
 
 int ns_send(struct ns_connection *, const void *buf, int len);
+int ns_send_ref(struct ns_connection *, const void *buf, int len,
+                ns_release_t release, void *ref);
 int ns_printf(struct ns_connection *, const char *fmt, ...);
 int ns_vprintf(struct ns_connection *, const char *fmt, va_list ap);
 
@@ -416,9 +427,18 @@ static void ns_call(struct ns_connection *conn, enum ns_event ev, void *p) {
   if (conn->server->callback) conn->server->callback(conn, ev, p);
 }
 
+static void ns_release_ref(struct ns_connection *conn) {
+  if (conn->ref_buf != NULL) {
+    conn->ref_buf = NULL;
+    conn->ref_len = conn->ref_at = 0;
+    if (conn->ref_release != NULL) conn->ref_release(conn->ref);
+  }
+}
+
 static void ns_close_conn(struct ns_connection *conn) {
   DBG(("%p %d", conn, conn->flags));
   ns_call(conn, NS_CLOSE, NULL);
+  ns_release_ref(conn);
   ns_remove_conn(conn);
   closesocket(conn->sock);
   iobuf_free(&conn->recv_iobuf);
@@ -742,6 +762,67 @@ static void ns_read_from_socket(struct ns_connection *conn) {
   }
 }
 
+// Gather write of send_iobuf, with the referenced data at ref_at
+static int ns_write_ref(struct ns_connection *conn) {
+  struct iobuf *io = &conn->send_iobuf;
+  const char *p[3];
+  size_t l[3];
+  int i, cnt = 0;
+
+  if (conn->ref_at > 0) {
+    p[cnt] = io->buf;
+    l[cnt++] = conn->ref_at;
+  }
+  p[cnt] = conn->ref_buf;
+  l[cnt++] = conn->ref_len;
+  if (io->len > conn->ref_at) {
+    p[cnt] = io->buf + conn->ref_at;
+    l[cnt++] = io->len - conn->ref_at;
+  }
+#ifdef _WIN32
+  {
+    WSABUF wb[3];
+    DWORD sent = 0;
+    for (i = 0; i < cnt; i++) {
+      wb[i].buf = (char *) p[i];
+      wb[i].len = (ULONG) l[i];
+    }
+    return WSASend(conn->sock, wb, cnt, &sent, 0, NULL, NULL) == 0 ?
+      (int) sent : -1;
+  }
+#else
+  {
+    struct iovec iov[3];
+    for (i = 0; i < cnt; i++) {
+      iov[i].iov_base = (void *) p[i];
+      iov[i].iov_len = l[i];
+    }
+    return (int) writev(conn->sock, iov, cnt);
+  }
+#endif
+}
+
+// Drop n written bytes, from the front of send_iobuf and referenced data
+static void ns_remove_sent(struct ns_connection *conn, size_t n) {
+  struct iobuf *io = &conn->send_iobuf;
+  size_t k;
+
+  if (conn->ref_buf != NULL) {
+    k = n < conn->ref_at ? n : conn->ref_at;
+    iobuf_remove(io, k);
+    conn->ref_at -= k;
+    n -= k;
+    if (conn->ref_at == 0 && n > 0) {
+      k = n < conn->ref_len ? n : conn->ref_len;
+      conn->ref_buf += k;
+      conn->ref_len -= k;
+      n -= k;
+      if (conn->ref_len == 0) ns_release_ref(conn);
+    }
+  }
+  iobuf_remove(io, n);
+}
+
 static void ns_write_to_socket(struct ns_connection *conn) {
   struct iobuf *io = &conn->send_iobuf;
   int n = 0;
@@ -760,6 +841,9 @@ static void ns_write_to_socket(struct ns_connection *conn) {
     }
   } else
 #endif
+  if (conn->ref_buf != NULL) {
+    n = ns_write_ref(conn);
+  } else
   { n = send(conn->sock, io->buf, io->len, 0); }
 
   DBG(("%p -> %d bytes [%.*s%s]", conn, n, io->len < 40 ? io->len : 40,
@@ -769,10 +853,11 @@ static void ns_write_to_socket(struct ns_connection *conn) {
   if (ns_is_error(n)) {
     conn->flags |= NSF_CLOSE_IMMEDIATELY;
   } else if (n > 0) {
-    iobuf_remove(io, n);
+    ns_remove_sent(conn, n);
   }
 
-  if (io->len == 0 && conn->flags & NSF_FINISHED_SENDING_DATA) {
+  if (io->len == 0 && conn->ref_buf == NULL &&
+      conn->flags & NSF_FINISHED_SENDING_DATA) {
     conn->flags |= NSF_CLOSE_IMMEDIATELY;
   }
 }
@@ -781,6 +866,29 @@ int ns_send(struct ns_connection *conn, const void *buf, int len) {
   return iobuf_append(&conn->send_iobuf, buf, len);
 }
 
+// Queue buf to be written straight from the caller's memory, after what
+// is already in send_iobuf. buf must stay valid until release(ref) is
+// called. Only one reference is held per connection; a second, or an
+// SSL connection, gets a copy, and is released at once.
+int ns_send_ref(struct ns_connection *conn, const void *buf, int len,
+                ns_release_t release, void *ref) {
+  if (len <= 0 || conn->ref_buf != NULL
+#ifdef NS_ENABLE_SSL
+      || conn->ssl != NULL
+#endif
+      ) {
+    len = (int) iobuf_append(&conn->send_iobuf, buf, len);
+    if (release != NULL) release(ref);
+    return len;
+  }
+  conn->ref_buf = (const char *) buf;
+  conn->ref_len = len;
+  conn->ref_at = conn->send_iobuf.len;
+  conn->ref_release = release;
+  conn->ref = ref;
+  return len;
+}
+
 static void ns_add_to_set(sock_t sock, fd_set *set, sock_t *max_fd) {
   if (sock != INVALID_SOCKET) {
     FD_SET(sock, set);
@@ -813,7 +921,8 @@ int ns_server_poll(struct ns_server *server, int milli) {
     if (conn->flags & NSF_CONNECTING) {
       ns_add_to_set(conn->sock, &write_set, &max_fd);
     }
-    if (conn->send_iobuf.len > 0 && !(conn->flags & NSF_BUFFER_BUT_DONT_SEND)) {
+    if ((conn->send_iobuf.len > 0 || conn->ref_buf != NULL) &&
+        !(conn->flags & NSF_BUFFER_BUT_DONT_SEND)) {
       ns_add_to_set(conn->sock, &write_set, &max_fd);
     } else if (conn->flags & NSF_CLOSE_IMMEDIATELY) {
       ns_close_conn(conn);
@@ -1131,7 +1240,10 @@ enum {
   HEXDUMP_FILE,
   INDEX_FILES,
 #endif
+  IDLE_TIMEOUT_SECONDS,
   LISTENING_PORT,
+  MAX_CONNECTIONS,
+  MAX_SEND_BUFFER,
 #ifndef _WIN32
   RUN_AS_USER,
 #endif
@@ -1171,7 +1283,10 @@ static const char *static_config_options[] = {
   "hexdump_file", NULL,
   "index_files","index.html,index.htm,index.shtml,index.cgi,index.php,index.lp",
 #endif
+  "idle_timeout_seconds", NULL,
   "listening_port", NULL,
+  "max_connections", NULL,
+  "max_send_buffer", NULL,
 #ifndef _WIN32
   "run_as_user", NULL,
 #endif
@@ -1190,6 +1305,10 @@ struct mg_server {
   union socket_address lsa;   // Listening socket address
   mg_handler_t event_handler;
   char *config_options[NUM_OPTIONS];
+  int idle_timeout;           // Seconds, from "idle_timeout_seconds"
+  int max_connections;        // Accepted connections, 0 for no limit
+  size_t max_send_buffer;     // Output bytes per connection, 0 for no limit
+  struct mg_conn_stats stats;
 };
 
 // Local endpoint representation
@@ -1203,6 +1322,7 @@ enum endpoint_type { EP_NONE, EP_FILE, EP_CGI, EP_USER, EP_PUT, EP_CLIENT };
 #define MG_HEADERS_SENT NSF_USER_1
 #define MG_LONG_RUNNING NSF_USER_2
 #define MG_CGI_CONN NSF_USER_3
+#define MG_OUTPUT_FULL NSF_USER_4   // Request deferred, over max_send_buffer
 
 struct connection {
   struct ns_connection *ns_conn;  // NOTE(lsm): main.c depends on this order
@@ -2347,6 +2467,19 @@ void mg_send_data(struct mg_connection *c, const void *data, int data_len) {
   write_chunk(MG_CONN_2_CONN(c), (const char *) data, data_len);
 }
 
+void mg_send_data_ref(struct mg_connection *c, const void *data, int data_len,
+                      mg_release_t release, void *ref) {
+  struct connection *conn = MG_CONN_2_CONN(c);
+  char chunk_size[50];
+  int n;
+
+  terminate_headers(c);
+  n = mg_snprintf(chunk_size, sizeof(chunk_size), "%X\r\n", data_len);
+  ns_send(conn->ns_conn, chunk_size, n);
+  ns_send_ref(conn->ns_conn, data, data_len, release, ref);
+  ns_send(conn->ns_conn, "\r\n", 2);
+}
+
 void mg_printf_data(struct mg_connection *c, const char *fmt, ...) {
   struct connection *conn = MG_CONN_2_CONN(c);
   va_list ap;
@@ -4083,8 +4216,32 @@ static void try_parse(struct connection *conn) {
   }
 }
 
+// Output still to be sent, including any data sent by reference
+static size_t pending_output(const struct ns_connection *nc) {
+  return nc->send_iobuf.len + (nc->ref_buf != NULL ? nc->ref_len : 0);
+}
+
 static void process_request(struct connection *conn) {
   struct iobuf *io = &conn->ns_conn->recv_iobuf;
+  size_t max_send = conn->server->max_send_buffer;
+
+  // Nothing more is served once closing, as after a 503 for max_connections
+  if (conn->endpoint_type == EP_NONE &&
+      (conn->ns_conn->flags & NSF_FINISHED_SENDING_DATA)) {
+    iobuf_remove(io, io->len);
+    return;
+  }
+
+  // Do not start a new, maybe pipelined, request while the output of the
+  // last is over budget. NS_POLL resumes it once enough has been sent.
+  if (max_send > 0 && conn->endpoint_type == EP_NONE &&
+      pending_output(conn->ns_conn) >= max_send) {
+    if (!(conn->ns_conn->flags & MG_OUTPUT_FULL)) {
+      conn->ns_conn->flags |= MG_OUTPUT_FULL;
+      conn->server->stats.deferred++;
+    }
+    return;
+  }
 
   try_parse(conn);
   DBG(("%p %d %d %d [%.*s]", conn, conn->request_len, io->len,
@@ -4263,7 +4420,8 @@ static void close_local_endpoint(struct connection *conn) {
   if (keep_alive) {
     process_request(conn);  // Can call us recursively if pipelining is used
   } else {
-    conn->ns_conn->flags |= conn->ns_conn->send_iobuf.len == 0 ?
+    conn->ns_conn->flags |= (conn->ns_conn->send_iobuf.len == 0 &&
+                             conn->ns_conn->ref_buf == NULL) ?
       NSF_CLOSE_IMMEDIATELY : NSF_FINISHED_SENDING_DATA;
   }
 }
@@ -4472,6 +4630,15 @@ const char *mg_set_option(struct mg_server *server, const char *name,
     *v = NULL;
   }
 
+  if (ind == IDLE_TIMEOUT_SECONDS) {
+    server->idle_timeout = value == NULL || atoi(value) <= 0 ?
+      MONGOOSE_IDLE_TIMEOUT_SECONDS : atoi(value);
+  } else if (ind == MAX_CONNECTIONS) {
+    server->max_connections = value == NULL ? 0 : atoi(value);
+  } else if (ind == MAX_SEND_BUFFER) {
+    server->max_send_buffer = value == NULL ? 0 : (size_t) to64(value);
+  }
+
   if (value == NULL || value[0] == '\0') return NULL;
 
   *v = mg_strdup(value);
@@ -4556,6 +4723,11 @@ static void hexdump(struct ns_connection *nc, const char *path,
   char *buf;
   int buf_size = num_bytes * 5 + 100;
 
+  // Data sent by reference is not in send_iobuf, so is not dumped
+  if (is_sent && nc->ref_buf != NULL && num_bytes > (int) nc->ref_at) {
+    num_bytes = (int) nc->ref_at;
+    buf_size = num_bytes * 5 + 100;
+  }
   if (path != NULL && num_bytes > 0 && (fp = fopen(path, "a")) != NULL) {
     fprintf(fp, "%lu %s:%d %s %s:%d %d\n", (unsigned long) time(NULL),
             mc->mg_conn.local_ip, mc->mg_conn.local_port,
@@ -4590,6 +4762,19 @@ static void mg_ev_handler(struct ns_connection *nc, enum ns_event ev, void *p) {
   switch (ev) {
     case NS_ACCEPT:
       on_accept(nc, (union socket_address *) p);
+      if (nc->connection_data != NULL) {
+        struct mg_conn_stats *st = &server->stats;
+        st->accepted++;
+        if (++st->active > st->peak) st->peak = st->active;
+        if (server->max_connections > 0 &&
+            st->active > server->max_connections) {
+          static const char busy[] = "HTTP/1.1 503 Service Unavailable\r\n"
+            "Content-Length: 0\r\nConnection: close\r\n\r\n";
+          st->rejected++;
+          ns_send(nc, busy, sizeof(busy) - 1);
+          nc->flags |= NSF_FINISHED_SENDING_DATA;
+        }
+      }
 #ifdef MONGOOSE_SEND_NS_EVENTS
       {
         struct connection *conn = (struct connection *) nc->connection_data;
@@ -4644,6 +4829,7 @@ static void mg_ev_handler(struct ns_connection *nc, enum ns_event ev, void *p) {
 
         call_user(conn, MG_CLOSE);
         close_local_endpoint(conn);
+        if (nc->flags & NSF_ACCEPTED) server->stats.active--;
         free(conn);
       }
       break;
@@ -4657,6 +4843,19 @@ static void mg_ev_handler(struct ns_connection *nc, enum ns_event ev, void *p) {
         transfer_file_data(conn);
       }
 
+      // Resume a deferred request once its output is back under budget,
+      // but drop a client that keeps sending while it is not reading
+      if (conn != NULL && (nc->flags & MG_OUTPUT_FULL)) {
+        if (server->max_send_buffer == 0 ||
+            pending_output(nc) < server->max_send_buffer) {
+          nc->flags &= ~MG_OUTPUT_FULL;
+          process_request(conn);
+        } else if (nc->recv_iobuf.len > MAX_REQUEST_SIZE) {
+          server->stats.flood_closed++;
+          nc->flags |= NSF_CLOSE_IMMEDIATELY;
+        }
+      }
+
       // Expire idle connections
       {
         time_t current_time = * (time_t *) p;
@@ -4665,7 +4864,10 @@ static void mg_ev_handler(struct ns_connection *nc, enum ns_event ev, void *p) {
           ping_idle_websocket_connection(conn, current_time);
         }
 
-        if (nc->last_io_time + MONGOOSE_IDLE_TIMEOUT_SECONDS < current_time) {
+        if (nc->last_io_time + server->idle_timeout < current_time) {
+          if (conn != NULL && (nc->flags & NSF_ACCEPTED)) {
+            server->stats.idle_closed++;
+          }
           mg_ev_handler(nc, NS_CLOSE, NULL);
           nc->flags |= NSF_CLOSE_IMMEDIATELY;
         }
@@ -4702,6 +4904,11 @@ struct mg_server *mg_create_server(void *server_data, mg_handler_t handler) {
   struct mg_server *server = (struct mg_server *) calloc(1, sizeof(*server));
   ns_server_init(&server->ns_server, server_data, mg_ev_handler);
   set_default_option_values(server->config_options);
+  server->idle_timeout = MONGOOSE_IDLE_TIMEOUT_SECONDS;
   server->event_handler = handler;
   return server;
 }
+
+void mg_get_conn_stats(struct mg_server *server, struct mg_conn_stats *st) {
+  *st = server->stats;
+}
@@ -92,6 +92,18 @@ const char *mg_get_option(const struct mg_server *server, const char *name);
 void mg_set_listening_socket(struct mg_server *, int sock);
 int mg_get_listening_socket(struct mg_server *);
 void mg_iterate_over_connections(struct mg_server *, mg_handler_t, void *);
+
+// Accepted connection counts, see the "max_connections",
+// "idle_timeout_seconds" and "max_send_buffer" options
+struct mg_conn_stats {
+  int active, peak;             // Open now, and most open at once
+  unsigned long accepted;       // Total accepted
+  unsigned long rejected;       // Sent 503, over max_connections
+  unsigned long idle_closed;    // Closed after idle_timeout_seconds
+  unsigned long deferred;       // Requests held back, over max_send_buffer
+  unsigned long flood_closed;   // Closed, sending while not reading
+};
+void mg_get_conn_stats(struct mg_server *, struct mg_conn_stats *);
 void mg_wakeup_server(struct mg_server *);
 struct mg_connection *mg_connect(struct mg_server *, const char *, int, int);
 
@@ -99,6 +111,11 @@ struct mg_connection *mg_connect(struct mg_server *, const char *, int, int);
 void mg_send_status(struct mg_connection *, int status_code);
 void mg_send_header(struct mg_connection *, const char *name, const char *val);
 void mg_send_data(struct mg_connection *, const void *data, int data_len);
+// As mg_send_data(), but written straight from data, which must stay valid
+// until release(ref) is called, once sent, or on close.
+typedef void (*mg_release_t)(void *ref);
+void mg_send_data_ref(struct mg_connection *, const void *data, int data_len,
+                      mg_release_t release, void *ref);
 void mg_printf_data(struct mg_connection *, const char *format, ...);
 
 int mg_websocket_write(struct mg_connection *, int opcode,
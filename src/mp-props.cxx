@@ -0,0 +1,1391 @@
+/*\
+ * mp-props.cxx
+ *
+ * Copyright (c) 2015 - Geoff R. McLane
+ * Licence: GNU GPL version 2
+ *
+\*/
+/*\
+ * The MP protocol property id table, and lookups, shared by raw-log and cf-bench
+\*/
+
+#include <stdio.h>
+#include <string.h> // for strlen(), ...
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+#include <algorithm> // for std::sort, ...
+#include "sprtf.hxx"
+#include "mpMsgs.hxx"
+#ifdef USE_SIMGEAR
+#include "xdr_lib/tiny_xdr.hxx"
+#else
+#include "tiny_xdr.hxx"
+#endif
+#include "mp-props.hxx"
+
+#ifndef SPRTF
+#define SPRTF printf
+#endif
+
+#if 0 // 0000000000000000000000000000000000000000
+/*
+* not yet used method to avoid transmitting a string for something that should always have been
+* an integer
+*/
+static int convert_launchbar_state(int direction, xdr_data_t*, FGPropertyData*)
+{
+    return 0; // no conversion performed
+}
+#endif // 000000000000000000000000000000000000000
+
+// A static map of protocol property id values to property paths,
+// This should be extendable dynamically for every specific aircraft ...
+// For now only that static list
+const IdPropertyList sIdPropertyList[] = {
+    { 10,  "sim/multiplay/protocol-version",          simgear::props::INT,   TT_SHORTINT,  V1_1_PROP_ID, NULL },
+    { 100, "surface-positions/left-aileron-pos-norm",  simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 101, "surface-positions/right-aileron-pos-norm", simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 102, "surface-positions/elevator-pos-norm",      simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 103, "surface-positions/rudder-pos-norm",        simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 104, "surface-positions/flap-pos-norm",          simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 105, "surface-positions/speedbrake-pos-norm",    simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 106, "gear/tailhook/position-norm",              simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 107, "gear/launchbar/position-norm",             simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 108, "gear/launchbar/state",                     simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 109, "gear/launchbar/holdback-position-norm",    simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 110, "canopy/position-norm",                     simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 111, "surface-positions/wing-pos-norm",          simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 112, "surface-positions/wing-fold-pos-norm",     simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+
+    { 200, "gear/gear[0]/compression-norm",           simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 201, "gear/gear[0]/position-norm",              simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 210, "gear/gear[1]/compression-norm",           simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 211, "gear/gear[1]/position-norm",              simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 220, "gear/gear[2]/compression-norm",           simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 221, "gear/gear[2]/position-norm",              simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 230, "gear/gear[3]/compression-norm",           simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 231, "gear/gear[3]/position-norm",              simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 240, "gear/gear[4]/compression-norm",           simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+    { 241, "gear/gear[4]/position-norm",              simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
+
+    { 300, "engines/engine[0]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 301, "engines/engine[0]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 302, "engines/engine[0]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 310, "engines/engine[1]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 311, "engines/engine[1]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 312, "engines/engine[1]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 320, "engines/engine[2]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 321, "engines/engine[2]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 322, "engines/engine[2]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 330, "engines/engine[3]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 331, "engines/engine[3]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 332, "engines/engine[3]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 340, "engines/engine[4]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 341, "engines/engine[4]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 342, "engines/engine[4]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 350, "engines/engine[5]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 351, "engines/engine[5]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 352, "engines/engine[5]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 360, "engines/engine[6]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 361, "engines/engine[6]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 362, "engines/engine[6]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 370, "engines/engine[7]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 371, "engines/engine[7]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 372, "engines/engine[7]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 380, "engines/engine[8]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 381, "engines/engine[8]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 382, "engines/engine[8]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 390, "engines/engine[9]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 391, "engines/engine[9]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 392, "engines/engine[9]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+
+    { 800, "rotors/main/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 801, "rotors/tail/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
+    { 810, "rotors/main/blade[0]/position-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
+    { 811, "rotors/main/blade[1]/position-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
+    { 812, "rotors/main/blade[2]/position-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
+    { 813, "rotors/main/blade[3]/position-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
+    { 820, "rotors/main/blade[0]/flap-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
+    { 821, "rotors/main/blade[1]/flap-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
+    { 822, "rotors/main/blade[2]/flap-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
+    { 823, "rotors/main/blade[3]/flap-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
+    { 830, "rotors/tail/blade[0]/position-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
+    { 831, "rotors/tail/blade[1]/position-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
+
+    { 900, "sim/hitches/aerotow/tow/length",                       simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 901, "sim/hitches/aerotow/tow/elastic-constant",             simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 902, "sim/hitches/aerotow/tow/weight-per-m-kg-m",            simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 903, "sim/hitches/aerotow/tow/dist",                         simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 904, "sim/hitches/aerotow/tow/connected-to-property-node",   simgear::props::BOOL, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 905, "sim/hitches/aerotow/tow/connected-to-ai-or-mp-callsign",   simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 906, "sim/hitches/aerotow/tow/brake-force",                  simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 907, "sim/hitches/aerotow/tow/end-force-x",                  simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 908, "sim/hitches/aerotow/tow/end-force-y",                  simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 909, "sim/hitches/aerotow/tow/end-force-z",                  simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 930, "sim/hitches/aerotow/is-slave",                         simgear::props::BOOL, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 931, "sim/hitches/aerotow/speed-in-tow-direction",           simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 932, "sim/hitches/aerotow/open",                             simgear::props::BOOL, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 933, "sim/hitches/aerotow/local-pos-x",                      simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 934, "sim/hitches/aerotow/local-pos-y",                      simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 935, "sim/hitches/aerotow/local-pos-z",                      simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+
+    { 1001, "controls/flight/slats",  simgear::props::FLOAT, TT_SHORT_FLOAT_4,  V1_1_PROP_ID, NULL },
+    { 1002, "controls/flight/speedbrake",  simgear::props::FLOAT, TT_SHORT_FLOAT_4,  V1_1_PROP_ID, NULL },
+    { 1003, "controls/flight/spoilers",  simgear::props::FLOAT, TT_SHORT_FLOAT_4,  V1_1_PROP_ID, NULL },
+    { 1004, "controls/gear/gear-down",  simgear::props::FLOAT, TT_SHORT_FLOAT_4,  V1_1_PROP_ID, NULL },
+    { 1005, "controls/lighting/nav-lights",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
+    { 1006, "controls/armament/station[0]/jettison-all",  simgear::props::BOOL, TT_SHORTINT,  V1_1_PROP_ID, NULL },
+
+    { 1100, "sim/model/variant", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 1101, "sim/model/livery/file", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+
+    { 1200, "environment/wildfire/data", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 1201, "environment/contrail", simgear::props::INT, TT_SHORTINT,  V1_1_PROP_ID, NULL },
+
+    { 1300, "tanker", simgear::props::INT, TT_SHORTINT,  V1_1_PROP_ID, NULL },
+
+    { 1400, "scenery/events", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+
+    { 1500, "instrumentation/transponder/transmitted-id", simgear::props::INT, TT_SHORTINT,  V1_1_PROP_ID, NULL },
+    { 1501, "instrumentation/transponder/altitude", simgear::props::INT, TT_ASIS, V1_1_PROP_ID, NULL },
+    { 1502, "instrumentation/transponder/ident", simgear::props::BOOL, TT_SHORTINT, V1_1_PROP_ID, NULL },
+    { 1503, "instrumentation/transponder/inputs/mode", simgear::props::INT, TT_SHORTINT, V1_1_PROP_ID, NULL },
+
+    { 10001, "sim/multiplay/transmission-freq-hz",  simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10002, "sim/multiplay/chat",  simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+
+    { 10100, "sim/multiplay/generic/string[0]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10101, "sim/multiplay/generic/string[1]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10102, "sim/multiplay/generic/string[2]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10103, "sim/multiplay/generic/string[3]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10104, "sim/multiplay/generic/string[4]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10105, "sim/multiplay/generic/string[5]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10106, "sim/multiplay/generic/string[6]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10107, "sim/multiplay/generic/string[7]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10108, "sim/multiplay/generic/string[8]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10109, "sim/multiplay/generic/string[9]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10110, "sim/multiplay/generic/string[10]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10111, "sim/multiplay/generic/string[11]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10112, "sim/multiplay/generic/string[12]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10113, "sim/multiplay/generic/string[13]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10114, "sim/multiplay/generic/string[14]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10115, "sim/multiplay/generic/string[15]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10116, "sim/multiplay/generic/string[16]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10117, "sim/multiplay/generic/string[17]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10118, "sim/multiplay/generic/string[18]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+    { 10119, "sim/multiplay/generic/string[19]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
+
+    { 10200, "sim/multiplay/generic/float[0]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10201, "sim/multiplay/generic/float[1]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10202, "sim/multiplay/generic/float[2]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10203, "sim/multiplay/generic/float[3]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10204, "sim/multiplay/generic/float[4]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10205, "sim/multiplay/generic/float[5]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10206, "sim/multiplay/generic/float[6]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10207, "sim/multiplay/generic/float[7]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10208, "sim/multiplay/generic/float[8]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10209, "sim/multiplay/generic/float[9]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10210, "sim/multiplay/generic/float[10]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10211, "sim/multiplay/generic/float[11]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10212, "sim/multiplay/generic/float[12]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10213, "sim/multiplay/generic/float[13]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10214, "sim/multiplay/generic/float[14]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10215, "sim/multiplay/generic/float[15]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10216, "sim/multiplay/generic/float[16]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10217, "sim/multiplay/generic/float[17]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10218, "sim/multiplay/generic/float[18]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10219, "sim/multiplay/generic/float[19]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+
+    { 10220, "sim/multiplay/generic/float[20]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10221, "sim/multiplay/generic/float[21]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10222, "sim/multiplay/generic/float[22]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10223, "sim/multiplay/generic/float[23]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10224, "sim/multiplay/generic/float[24]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10225, "sim/multiplay/generic/float[25]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10226, "sim/multiplay/generic/float[26]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10227, "sim/multiplay/generic/float[27]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10228, "sim/multiplay/generic/float[28]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10229, "sim/multiplay/generic/float[29]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10230, "sim/multiplay/generic/float[30]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10231, "sim/multiplay/generic/float[31]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10232, "sim/multiplay/generic/float[32]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10233, "sim/multiplay/generic/float[33]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10234, "sim/multiplay/generic/float[34]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10235, "sim/multiplay/generic/float[35]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10236, "sim/multiplay/generic/float[36]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10237, "sim/multiplay/generic/float[37]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10238, "sim/multiplay/generic/float[38]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10239, "sim/multiplay/generic/float[39]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
+
+    { 10300, "sim/multiplay/generic/int[0]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10301, "sim/multiplay/generic/int[1]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10302, "sim/multiplay/generic/int[2]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10303, "sim/multiplay/generic/int[3]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10304, "sim/multiplay/generic/int[4]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10305, "sim/multiplay/generic/int[5]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10306, "sim/multiplay/generic/int[6]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10307, "sim/multiplay/generic/int[7]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10308, "sim/multiplay/generic/int[8]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10309, "sim/multiplay/generic/int[9]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10310, "sim/multiplay/generic/int[10]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10311, "sim/multiplay/generic/int[11]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10312, "sim/multiplay/generic/int[12]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10313, "sim/multiplay/generic/int[13]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10314, "sim/multiplay/generic/int[14]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10315, "sim/multiplay/generic/int[15]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10316, "sim/multiplay/generic/int[16]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10317, "sim/multiplay/generic/int[17]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10318, "sim/multiplay/generic/int[18]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+    { 10319, "sim/multiplay/generic/int[19]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
+
+    { 10500, "sim/multiplay/generic/short[0]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10501, "sim/multiplay/generic/short[1]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10502, "sim/multiplay/generic/short[2]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10503, "sim/multiplay/generic/short[3]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10504, "sim/multiplay/generic/short[4]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10505, "sim/multiplay/generic/short[5]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10506, "sim/multiplay/generic/short[6]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10507, "sim/multiplay/generic/short[7]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10508, "sim/multiplay/generic/short[8]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10509, "sim/multiplay/generic/short[9]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10510, "sim/multiplay/generic/short[10]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10511, "sim/multiplay/generic/short[11]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10512, "sim/multiplay/generic/short[12]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10513, "sim/multiplay/generic/short[13]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10514, "sim/multiplay/generic/short[14]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10515, "sim/multiplay/generic/short[15]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10516, "sim/multiplay/generic/short[16]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10517, "sim/multiplay/generic/short[17]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10518, "sim/multiplay/generic/short[18]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10519, "sim/multiplay/generic/short[19]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10520, "sim/multiplay/generic/short[20]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10521, "sim/multiplay/generic/short[21]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10522, "sim/multiplay/generic/short[22]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10523, "sim/multiplay/generic/short[23]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10524, "sim/multiplay/generic/short[24]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10525, "sim/multiplay/generic/short[25]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10526, "sim/multiplay/generic/short[26]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10527, "sim/multiplay/generic/short[27]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10528, "sim/multiplay/generic/short[28]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10529, "sim/multiplay/generic/short[29]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10530, "sim/multiplay/generic/short[30]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10531, "sim/multiplay/generic/short[31]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10532, "sim/multiplay/generic/short[32]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10533, "sim/multiplay/generic/short[33]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10534, "sim/multiplay/generic/short[34]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10535, "sim/multiplay/generic/short[35]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10536, "sim/multiplay/generic/short[36]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10537, "sim/multiplay/generic/short[37]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10538, "sim/multiplay/generic/short[38]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10539, "sim/multiplay/generic/short[39]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10540, "sim/multiplay/generic/short[40]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10541, "sim/multiplay/generic/short[41]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10542, "sim/multiplay/generic/short[42]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10543, "sim/multiplay/generic/short[43]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10544, "sim/multiplay/generic/short[44]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10545, "sim/multiplay/generic/short[45]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10546, "sim/multiplay/generic/short[46]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10547, "sim/multiplay/generic/short[47]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10548, "sim/multiplay/generic/short[48]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10549, "sim/multiplay/generic/short[49]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10550, "sim/multiplay/generic/short[50]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10551, "sim/multiplay/generic/short[51]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10552, "sim/multiplay/generic/short[52]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10553, "sim/multiplay/generic/short[53]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10554, "sim/multiplay/generic/short[54]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10555, "sim/multiplay/generic/short[55]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10556, "sim/multiplay/generic/short[56]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10557, "sim/multiplay/generic/short[57]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10558, "sim/multiplay/generic/short[58]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10559, "sim/multiplay/generic/short[59]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10560, "sim/multiplay/generic/short[60]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10561, "sim/multiplay/generic/short[61]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10562, "sim/multiplay/generic/short[62]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10563, "sim/multiplay/generic/short[63]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10564, "sim/multiplay/generic/short[64]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10565, "sim/multiplay/generic/short[65]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10566, "sim/multiplay/generic/short[66]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10567, "sim/multiplay/generic/short[67]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10568, "sim/multiplay/generic/short[68]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10569, "sim/multiplay/generic/short[69]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10570, "sim/multiplay/generic/short[70]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10571, "sim/multiplay/generic/short[71]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10572, "sim/multiplay/generic/short[72]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10573, "sim/multiplay/generic/short[73]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10574, "sim/multiplay/generic/short[74]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10575, "sim/multiplay/generic/short[75]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10576, "sim/multiplay/generic/short[76]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10577, "sim/multiplay/generic/short[77]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10578, "sim/multiplay/generic/short[78]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+    { 10579, "sim/multiplay/generic/short[79]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
+
+};
+
+/*
+* For the 2017.x version 2 protocol the properties are sent in two partitions,
+* the first of these is a V1 protocol packet (which should be fine with all clients), and a V2 partition
+* which will contain the newly supported shortint and fixed string encoding schemes.
+* This is to possibly allow for easier V1/V2 conversion - as the packet can simply be truncated at the
+* first V2 property based on ID.
+*/
+const unsigned int numProperties = (sizeof(sIdPropertyList) / sizeof(sIdPropertyList[0]));
+
+// #else // !USE PROTO_2
+
+
+
+// A static map of protocol property id values to property paths,
+// This should be extendable dynamically for every specific aircraft ...
+// For now only that static list
+const IdPropertyList1 sIdPropertyList1[] = {
+    { 100, "surface-positions/left-aileron-pos-norm",  sgp_FLOAT },
+    { 101, "surface-positions/right-aileron-pos-norm", sgp_FLOAT },
+    { 102, "surface-positions/elevator-pos-norm",      sgp_FLOAT },
+    { 103, "surface-positions/rudder-pos-norm",        sgp_FLOAT },
+    { 104, "surface-positions/flap-pos-norm",          sgp_FLOAT },
+    { 105, "surface-positions/speedbrake-pos-norm",    sgp_FLOAT },
+    { 106, "gear/tailhook/position-norm",              sgp_FLOAT },
+    { 107, "gear/launchbar/position-norm",             sgp_FLOAT },
+    { 108, "gear/launchbar/state",                     sgp_STRING },
+    { 109, "gear/launchbar/holdback-position-norm",    sgp_FLOAT },
+    { 110, "canopy/position-norm",                     sgp_FLOAT },
+    { 111, "surface-positions/wing-pos-norm",          sgp_FLOAT },
+    { 112, "surface-positions/wing-fold-pos-norm",     sgp_FLOAT },
+
+    { 200, "gear/gear[0]/compression-norm",           sgp_FLOAT },
+    { 201, "gear/gear[0]/position-norm",              sgp_FLOAT },
+    { 210, "gear/gear[1]/compression-norm",           sgp_FLOAT },
+    { 211, "gear/gear[1]/position-norm",              sgp_FLOAT },
+    { 220, "gear/gear[2]/compression-norm",           sgp_FLOAT },
+    { 221, "gear/gear[2]/position-norm",              sgp_FLOAT },
+    { 230, "gear/gear[3]/compression-norm",           sgp_FLOAT },
+    { 231, "gear/gear[3]/position-norm",              sgp_FLOAT },
+    { 240, "gear/gear[4]/compression-norm",           sgp_FLOAT },
+    { 241, "gear/gear[4]/position-norm",              sgp_FLOAT },
+
+    { 300, "engines/engine[0]/n1",  sgp_FLOAT },
+    { 301, "engines/engine[0]/n2",  sgp_FLOAT },
+    { 302, "engines/engine[0]/rpm", sgp_FLOAT },
+    { 310, "engines/engine[1]/n1",  sgp_FLOAT },
+    { 311, "engines/engine[1]/n2",  sgp_FLOAT },
+    { 312, "engines/engine[1]/rpm", sgp_FLOAT },
+    { 320, "engines/engine[2]/n1",  sgp_FLOAT },
+    { 321, "engines/engine[2]/n2",  sgp_FLOAT },
+    { 322, "engines/engine[2]/rpm", sgp_FLOAT },
+    { 330, "engines/engine[3]/n1",  sgp_FLOAT },
+    { 331, "engines/engine[3]/n2",  sgp_FLOAT },
+    { 332, "engines/engine[3]/rpm", sgp_FLOAT },
+    { 340, "engines/engine[4]/n1",  sgp_FLOAT },
+    { 341, "engines/engine[4]/n2",  sgp_FLOAT },
+    { 342, "engines/engine[4]/rpm", sgp_FLOAT },
+    { 350, "engines/engine[5]/n1",  sgp_FLOAT },
+    { 351, "engines/engine[5]/n2",  sgp_FLOAT },
+    { 352, "engines/engine[5]/rpm", sgp_FLOAT },
+    { 360, "engines/engine[6]/n1",  sgp_FLOAT },
+    { 361, "engines/engine[6]/n2",  sgp_FLOAT },
+    { 362, "engines/engine[6]/rpm", sgp_FLOAT },
+    { 370, "engines/engine[7]/n1",  sgp_FLOAT },
+    { 371, "engines/engine[7]/n2",  sgp_FLOAT },
+    { 372, "engines/engine[7]/rpm", sgp_FLOAT },
+    { 380, "engines/engine[8]/n1",  sgp_FLOAT },
+    { 381, "engines/engine[8]/n2",  sgp_FLOAT },
+    { 382, "engines/engine[8]/rpm", sgp_FLOAT },
+    { 390, "engines/engine[9]/n1",  sgp_FLOAT },
+    { 391, "engines/engine[9]/n2",  sgp_FLOAT },
+    { 392, "engines/engine[9]/rpm", sgp_FLOAT },
+
+    { 800, "rotors/main/rpm", sgp_FLOAT },
+    { 801, "rotors/tail/rpm", sgp_FLOAT },
+    { 810, "rotors/main/blade[0]/position-deg",  sgp_FLOAT },
+    { 811, "rotors/main/blade[1]/position-deg",  sgp_FLOAT },
+    { 812, "rotors/main/blade[2]/position-deg",  sgp_FLOAT },
+    { 813, "rotors/main/blade[3]/position-deg",  sgp_FLOAT },
+    { 820, "rotors/main/blade[0]/flap-deg",  sgp_FLOAT },
+    { 821, "rotors/main/blade[1]/flap-deg",  sgp_FLOAT },
+    { 822, "rotors/main/blade[2]/flap-deg",  sgp_FLOAT },
+    { 823, "rotors/main/blade[3]/flap-deg",  sgp_FLOAT },
+    { 830, "rotors/tail/blade[0]/position-deg",  sgp_FLOAT },
+    { 831, "rotors/tail/blade[1]/position-deg",  sgp_FLOAT },
+
+    { 900, "sim/hitches/aerotow/tow/length",                       sgp_FLOAT },
+    { 901, "sim/hitches/aerotow/tow/elastic-constant",             sgp_FLOAT },
+    { 902, "sim/hitches/aerotow/tow/weight-per-m-kg-m",            sgp_FLOAT },
+    { 903, "sim/hitches/aerotow/tow/dist",                         sgp_FLOAT },
+    { 904, "sim/hitches/aerotow/tow/connected-to-property-node",   sgp_BOOL },
+    { 905, "sim/hitches/aerotow/tow/connected-to-ai-or-mp-callsign",   sgp_STRING },
+    { 906, "sim/hitches/aerotow/tow/brake-force",                  sgp_FLOAT },
+    { 907, "sim/hitches/aerotow/tow/end-force-x",                  sgp_FLOAT },
+    { 908, "sim/hitches/aerotow/tow/end-force-y",                  sgp_FLOAT },
+    { 909, "sim/hitches/aerotow/tow/end-force-z",                  sgp_FLOAT },
+    { 930, "sim/hitches/aerotow/is-slave",                         sgp_BOOL },
+    { 931, "sim/hitches/aerotow/speed-in-tow-direction",           sgp_FLOAT },
+    { 932, "sim/hitches/aerotow/open",                             sgp_BOOL },
+    { 933, "sim/hitches/aerotow/local-pos-x",                      sgp_FLOAT },
+    { 934, "sim/hitches/aerotow/local-pos-y",                      sgp_FLOAT },
+    { 935, "sim/hitches/aerotow/local-pos-z",                      sgp_FLOAT },
+
+    { 1001, "controls/flight/slats",  sgp_FLOAT },
+    { 1002, "controls/flight/speedbrake",  sgp_FLOAT },
+    { 1003, "controls/flight/spoilers",  sgp_FLOAT },
+    { 1004, "controls/gear/gear-down",  sgp_FLOAT },
+    { 1005, "controls/lighting/nav-lights",  sgp_FLOAT },
+    { 1006, "controls/armament/station[0]/jettison-all",  sgp_BOOL },
+
+    { 1100, "sim/model/variant", sgp_INT },
+    { 1101, "sim/model/livery/file", sgp_STRING },
+
+    { 1200, "environment/wildfire/data", sgp_STRING },
+    { 1201, "environment/contrail", sgp_INT },
+
+    { 1300, "tanker", sgp_INT },
+
+    { 1400, "scenery/events", sgp_STRING },
+
+    { 1500, "instrumentation/transponder/transmitted-id", sgp_INT },
+    { 1501, "instrumentation/transponder/altitude", sgp_INT },
+    { 1502, "instrumentation/transponder/ident", sgp_BOOL },
+    { 1503, "instrumentation/transponder/inputs/mode", sgp_INT },
+
+    { 10001, "sim/multiplay/transmission-freq-hz",  sgp_STRING },
+    { 10002, "sim/multiplay/chat",  sgp_STRING },
+
+    { 10100, "sim/multiplay/generic/string[0]", sgp_STRING },
+    { 10101, "sim/multiplay/generic/string[1]", sgp_STRING },
+    { 10102, "sim/multiplay/generic/string[2]", sgp_STRING },
+    { 10103, "sim/multiplay/generic/string[3]", sgp_STRING },
+    { 10104, "sim/multiplay/generic/string[4]", sgp_STRING },
+    { 10105, "sim/multiplay/generic/string[5]", sgp_STRING },
+    { 10106, "sim/multiplay/generic/string[6]", sgp_STRING },
+    { 10107, "sim/multiplay/generic/string[7]", sgp_STRING },
+    { 10108, "sim/multiplay/generic/string[8]", sgp_STRING },
+    { 10109, "sim/multiplay/generic/string[9]", sgp_STRING },
+    { 10110, "sim/multiplay/generic/string[10]", sgp_STRING },
+    { 10111, "sim/multiplay/generic/string[11]", sgp_STRING },
+    { 10112, "sim/multiplay/generic/string[12]", sgp_STRING },
+    { 10113, "sim/multiplay/generic/string[13]", sgp_STRING },
+    { 10114, "sim/multiplay/generic/string[14]", sgp_STRING },
+    { 10115, "sim/multiplay/generic/string[15]", sgp_STRING },
+    { 10116, "sim/multiplay/generic/string[16]", sgp_STRING },
+    { 10117, "sim/multiplay/generic/string[17]", sgp_STRING },
+    { 10118, "sim/multiplay/generic/string[18]", sgp_STRING },
+    { 10119, "sim/multiplay/generic/string[19]", sgp_STRING },
+
+    { 10200, "sim/multiplay/generic/float[0]", sgp_FLOAT },
+    { 10201, "sim/multiplay/generic/float[1]", sgp_FLOAT },
+    { 10202, "sim/multiplay/generic/float[2]", sgp_FLOAT },
+    { 10203, "sim/multiplay/generic/float[3]", sgp_FLOAT },
+    { 10204, "sim/multiplay/generic/float[4]", sgp_FLOAT },
+    { 10205, "sim/multiplay/generic/float[5]", sgp_FLOAT },
+    { 10206, "sim/multiplay/generic/float[6]", sgp_FLOAT },
+    { 10207, "sim/multiplay/generic/float[7]", sgp_FLOAT },
+    { 10208, "sim/multiplay/generic/float[8]", sgp_FLOAT },
+    { 10209, "sim/multiplay/generic/float[9]", sgp_FLOAT },
+    { 10210, "sim/multiplay/generic/float[10]", sgp_FLOAT },
+    { 10211, "sim/multiplay/generic/float[11]", sgp_FLOAT },
+    { 10212, "sim/multiplay/generic/float[12]", sgp_FLOAT },
+    { 10213, "sim/multiplay/generic/float[13]", sgp_FLOAT },
+    { 10214, "sim/multiplay/generic/float[14]", sgp_FLOAT },
+    { 10215, "sim/multiplay/generic/float[15]", sgp_FLOAT },
+    { 10216, "sim/multiplay/generic/float[16]", sgp_FLOAT },
+    { 10217, "sim/multiplay/generic/float[17]", sgp_FLOAT },
+    { 10218, "sim/multiplay/generic/float[18]", sgp_FLOAT },
+    { 10219, "sim/multiplay/generic/float[19]", sgp_FLOAT },
+
+    { 10300, "sim/multiplay/generic/int[0]", sgp_INT },
+    { 10301, "sim/multiplay/generic/int[1]", sgp_INT },
+    { 10302, "sim/multiplay/generic/int[2]", sgp_INT },
+    { 10303, "sim/multiplay/generic/int[3]", sgp_INT },
+    { 10304, "sim/multiplay/generic/int[4]", sgp_INT },
+    { 10305, "sim/multiplay/generic/int[5]", sgp_INT },
+    { 10306, "sim/multiplay/generic/int[6]", sgp_INT },
+    { 10307, "sim/multiplay/generic/int[7]", sgp_INT },
+    { 10308, "sim/multiplay/generic/int[8]", sgp_INT },
+    { 10309, "sim/multiplay/generic/int[9]", sgp_INT },
+    { 10310, "sim/multiplay/generic/int[10]", sgp_INT },
+    { 10311, "sim/multiplay/generic/int[11]", sgp_INT },
+    { 10312, "sim/multiplay/generic/int[12]", sgp_INT },
+    { 10313, "sim/multiplay/generic/int[13]", sgp_INT },
+    { 10314, "sim/multiplay/generic/int[14]", sgp_INT },
+    { 10315, "sim/multiplay/generic/int[15]", sgp_INT },
+    { 10316, "sim/multiplay/generic/int[16]", sgp_INT },
+    { 10317, "sim/multiplay/generic/int[17]", sgp_INT },
+    { 10318, "sim/multiplay/generic/int[18]", sgp_INT },
+    { 10319, "sim/multiplay/generic/int[19]", sgp_INT }
+};
+
+const unsigned int numProperties1 = (sizeof(sIdPropertyList1)
+    / sizeof(sIdPropertyList1[0]));
+
+/////////////////////////////////////////////////////////////////////////
+// Direct index property lookup
+// The ids fall in a few dense runs (10, 100-1503, 10001-10579), so each
+// table is split into ranges wherever the id gap exceeds PROP_GAP, and
+// each range is a plain array of table indexes. A lookup is then a range
+// compare and one load, in place of the binary search of sIdPropertyList,
+// and the linear scan of sIdPropertyList1. The ranges are built from the
+// tables themselves, before main(), so every id in a table is in a range.
+#define PROP_GAP    256
+#define PROP_NONE   0xffff
+
+typedef struct tagPROPRANGE {
+    unsigned lo, hi;
+    std::vector<uint16_t> idx;
+}PROPRANGE;
+
+typedef std::vector<PROPRANGE> vPROPRANGE;
+
+static vPROPRANGE vPropRanges;
+static vPROPRANGE vPropRanges1;
+
+template<typename LIST>
+static void build_prop_index( const LIST *list, unsigned count, vPROPRANGE &vr )
+{
+    std::vector<unsigned> ids;
+    unsigned ui, id;
+    size_t ii, bgn;
+    for (ui = 0; ui < count; ui++)
+        ids.push_back(list[ui].id);
+    std::sort(ids.begin(), ids.end());
+    for (bgn = 0, ii = 1; ii <= ids.size(); ii++) {
+        if ((ii < ids.size()) && ((ids[ii] - ids[ii - 1]) <= PROP_GAP))
+            continue;
+        PROPRANGE pr;
+        pr.lo = ids[bgn];
+        pr.hi = ids[ii - 1];
+        pr.idx.resize(pr.hi - pr.lo + 1, PROP_NONE);
+        vr.push_back(pr);
+        bgn = ii;
+    }
+    // on any duplicate id, the first in the table wins, as before
+    for (ui = 0; ui < count; ui++) {
+        id = list[ui].id;
+        for (ii = 0; ii < vr.size(); ii++) {
+            PROPRANGE &pr = vr[ii];
+            if ((id >= pr.lo) && (id <= pr.hi)) {
+                if (pr.idx[id - pr.lo] == PROP_NONE)
+                    pr.idx[id - pr.lo] = (uint16_t)ui;
+                break;
+            }
+        }
+    }
+}
+
+static inline int find_prop_index( const vPROPRANGE &vr, unsigned id )
+{
+    size_t ii, max = vr.size();
+    for (ii = 0; ii < max; ii++) {
+        const PROPRANGE &pr = vr[ii];
+        if (id < pr.lo)
+            break;
+        if (id <= pr.hi) {
+            uint16_t ind = pr.idx[id - pr.lo];
+            return (ind == PROP_NONE) ? -1 : (int)ind;
+        }
+    }
+    return -1;
+}
+
+const IdPropertyList* findProperty(unsigned id)
+{
+    int ind = find_prop_index(vPropRanges, id);
+    return (ind < 0) ? 0 : &sIdPropertyList[ind];
+}
+
+const IdPropertyList1* findProperty1(unsigned id)
+{
+    int ind = find_prop_index(vPropRanges1, id);
+    return (ind < 0) ? 0 : &sIdPropertyList1[ind];
+}
+
+/////////////////////////////////////////////////////////////////////////
+// Table driven property decode
+// Each sIdPropertyList entry gets two decoders, chosen once from its type
+// and TransmitAs, one for the plain XDR encoding, and one for when the id
+// word carries a short int. The decoders are instances of PropDecode<>,
+// one per TransmissionType, so decoding a property is an index lookup
+// and an indirect call, with no switch on the type.
+typedef xdr_data_t *(*PROP_DECODE)( xdr_data_t *xdr, int int_value, PMP_PROP_VAL pv );
+
+typedef struct tagPROPDEC {
+    PROP_DECODE plain;
+    PROP_DECODE shorti;
+}PROPDEC;
+
+static std::vector<PROPDEC> vPropDecode;
+static char _s_prop_text[MAX_TEXT_SIZE + 1];
+
+template<int TT> struct PropDecode;
+
+template<> struct PropDecode<TT_INT> {
+    static xdr_data_t *decode( xdr_data_t *xdr, int int_value, PMP_PROP_VAL pv ) {
+        pv->kind = pk_Int;
+        pv->ival = XDR_decode_uint32(*xdr);
+        pv->dt = "INT";
+        return xdr + 1;
+    }
+};
+
+template<> struct PropDecode<TT_FLOAT> {
+    static xdr_data_t *decode( xdr_data_t *xdr, int int_value, PMP_PROP_VAL pv ) {
+        pv->kind = pk_Float;
+        pv->dval = XDR_decode_float(*xdr);
+        pv->dt = "FLOAT";
+        return xdr + 1;
+    }
+};
+
+// length, the chars one per xdr word, then padding to a multiple of 4 words
+template<> struct PropDecode<TT_STRING> {
+    static xdr_data_t *decode( xdr_data_t *xdr, int int_value, PMP_PROP_VAL pv ) {
+        uint32_t i, length = XDR_decode_uint32(*xdr);
+        xdr++;
+        // Old versions truncated the string but left the length unadjusted.
+        if (length > MAX_TEXT_SIZE)
+            length = MAX_TEXT_SIZE;
+        for (i = 0; i < length; i++) {
+            _s_prop_text[i] = (char)XDR_decode_int8(*xdr);
+            xdr++;
+        }
+        _s_prop_text[length] = 0;
+        pv->kind = pk_String;
+        pv->text = _s_prop_text;
+        pv->txtlen = length;
+        pv->dt = "STRING";
+        while ((length % 4) != 0) {
+            xdr++;
+            length++;
+        }
+        return xdr;
+    }
+};
+
+// 32 bools in one word, kept as the int mask
+template<> struct PropDecode<TT_BOOLARRAY> {
+    static xdr_data_t *decode( xdr_data_t *xdr, int int_value, PMP_PROP_VAL pv ) {
+        pv->kind = pk_Int;
+        pv->ival = XDR_decode_uint32(*xdr);
+        pv->dt = "BOOLARRAY";
+        return xdr + 1;
+    }
+};
+
+template<> struct PropDecode<TT_SHORTINT> {
+    static xdr_data_t *decode( xdr_data_t *xdr, int int_value, PMP_PROP_VAL pv ) {
+        pv->kind = pk_Int;
+        pv->ival = int_value;
+        pv->dt = "EINT";
+        return xdr;
+    }
+};
+
+// short int length, then the chars packed one per byte
+template<> struct PropDecode<TT_CHAR> {
+    static xdr_data_t *decode( xdr_data_t *xdr, int int_value, PMP_PROP_VAL pv ) {
+        uint32_t length = (uint32_t)int_value;
+        uint32_t copy = (length > MAX_TEXT_SIZE) ? MAX_TEXT_SIZE : length;
+        memcpy(_s_prop_text, xdr, copy);
+        _s_prop_text[copy] = 0;
+        pv->kind = pk_String;
+        pv->text = _s_prop_text;
+        pv->txtlen = 0;
+        pv->dt = "STRING_N";
+        return (xdr_data_t *)((char *)xdr + length);
+    }
+};
+
+// a float sent as a scaled short int
+template<int TT> struct ShortFloat;
+template<> struct ShortFloat<TT_SHORT_FLOAT_NORM> { static double scale() { return 32767.0; } static const char *name() { return "FLOAT_N"; } };
+template<> struct ShortFloat<TT_SHORT_FLOAT_1> { static double scale() { return 10.0; } static const char *name() { return "FLOAT_1"; } };
+template<> struct ShortFloat<TT_SHORT_FLOAT_2> { static double scale() { return 100.0; } static const char *name() { return "FLOAT_2"; } };
+template<> struct ShortFloat<TT_SHORT_FLOAT_3> { static double scale() { return 1000.0; } static const char *name() { return "FLOAT_3"; } };
+template<> struct ShortFloat<TT_SHORT_FLOAT_4> { static double scale() { return 10000.0; } static const char *name() { return "FLOAT_4"; } };
+
+template<int TT> struct PropDecode {
+    static xdr_data_t *decode( xdr_data_t *xdr, int int_value, PMP_PROP_VAL pv ) {
+        pv->kind = pk_Float;
+        pv->dval = (double)int_value / ShortFloat<TT>::scale();
+        pv->dt = ShortFloat<TT>::name();
+        return xdr;
+    }
+};
+
+// a float short int encoded, but with no short TransmitAs
+static xdr_data_t *decode_short_none( xdr_data_t *xdr, int int_value, PMP_PROP_VAL pv )
+{
+    pv->kind = pk_Float;
+    pv->dval = 0.0;
+    pv->dt = "UNK";
+    return xdr;
+}
+
+// a type not handled, assume there was a following INT!
+static xdr_data_t *decode_unknown( xdr_data_t *xdr, int int_value, PMP_PROP_VAL pv )
+{
+    pv->kind = pk_Unknown;
+    return xdr + 1;
+}
+
+static PROPDEC get_prop_decoder( const IdPropertyList *plist )
+{
+    PROPDEC pd;
+    pd.plain = decode_unknown;
+    pd.shorti = decode_unknown;
+    switch (plist->type) {
+    case simgear::props::INT:
+    case simgear::props::BOOL:
+    case simgear::props::LONG:
+        if (plist->TransmitAs == TT_BOOLARRAY)
+            pd.plain = PropDecode<TT_BOOLARRAY>::decode;
+        else
+            pd.plain = PropDecode<TT_INT>::decode;
+        pd.shorti = PropDecode<TT_SHORTINT>::decode;
+        break;
+    case simgear::props::FLOAT:
+    case simgear::props::DOUBLE:
+        pd.plain = PropDecode<TT_FLOAT>::decode;
+        switch (plist->TransmitAs) {
+        case TT_SHORT_FLOAT_NORM: pd.shorti = PropDecode<TT_SHORT_FLOAT_NORM>::decode; break;
+        case TT_SHORT_FLOAT_1: pd.shorti = PropDecode<TT_SHORT_FLOAT_1>::decode; break;
+        case TT_SHORT_FLOAT_2: pd.shorti = PropDecode<TT_SHORT_FLOAT_2>::decode; break;
+        case TT_SHORT_FLOAT_3: pd.shorti = PropDecode<TT_SHORT_FLOAT_3>::decode; break;
+        case TT_SHORT_FLOAT_4: pd.shorti = PropDecode<TT_SHORT_FLOAT_4>::decode; break;
+        default: pd.shorti = decode_short_none; break;
+        }
+        break;
+    case simgear::props::STRING:
+    case simgear::props::UNSPECIFIED:
+        pd.plain = PropDecode<TT_STRING>::decode;
+        pd.shorti = PropDecode<TT_CHAR>::decode;
+        break;
+    default:
+        break;
+    }
+    return pd;
+}
+
+// text buffer index per table entry, -1 if not a string
+static std::vector<int> vPropTextInd;
+static int num_text_props = 0;
+
+static struct PropIndexInit {
+    PropIndexInit() {
+        unsigned ui;
+        build_prop_index(sIdPropertyList, numProperties, vPropRanges);
+        build_prop_index(sIdPropertyList1, numProperties1, vPropRanges1);
+        for (ui = 0; ui < numProperties; ui++) {
+            vPropDecode.push_back(get_prop_decoder(&sIdPropertyList[ui]));
+            if ((sIdPropertyList[ui].type == simgear::props::STRING) ||
+                (sIdPropertyList[ui].type == simgear::props::UNSPECIFIED))
+                vPropTextInd.push_back(num_text_props++);
+            else
+                vPropTextInd.push_back(-1);
+        }
+    }
+} s_PropIndexInit;
+
+xdr_data_t *Decode_Property( xdr_data_t *xdr, PMP_PROP_VAL pv )
+{
+    // First element is always the ID
+    unsigned id = XDR_decode_uint32(*xdr);
+    int int_value = 0;
+    bool short_int_encoded = false;
+    /*
+    * As we can detect a short int encoded value (by the upper word being non-zero) we can
+    * do the decode here; set the id correctly, extract the integer and set the flag.
+    */
+    if (id & 0xffff0000) {
+        int v1, v2;
+        XDR_decode_shortints32(*xdr, v1, v2);
+        int_value = v2;
+        id = v1;
+        short_int_encoded = true;
+    }
+    xdr++;
+    pv->id = id;
+    pv->txtlen = 0;
+    int ind = find_prop_index(vPropRanges, id);
+    if (ind < 0) {
+        pv->plist = 0;
+        pv->kind = pk_Unknown;
+        return xdr + 1;
+    }
+    pv->plist = &sIdPropertyList[ind];
+    const PROPDEC &pd = vPropDecode[ind];
+    return short_int_encoded ? pd.shorti(xdr, int_value, pv) : pd.plain(xdr, int_value, pv);
+}
+
+
+/////////////////////////////////////////////////////////////////////////
+// Per flight property store
+#define PROP_TEXT_SIZE (MAX_TEXT_SIZE + 1)
+
+typedef struct tagPROP_STORE {
+    uint32_t gen;       // current generation, bumped per packet
+    double sim_time;    // of the current packet
+    PROP_SLOT *slots;   // numProperties
+    char *text;         // num_text_props * PROP_TEXT_SIZE
+}PROP_STORE;
+
+PPROP_STORE prop_store_new()
+{
+    PPROP_STORE ps = new PROP_STORE;
+    ps->gen = 0;
+    ps->sim_time = 0.0;
+    ps->slots = new PROP_SLOT[numProperties];
+    memset(ps->slots, 0, sizeof(PROP_SLOT) * numProperties);
+    ps->text = new char[num_text_props * PROP_TEXT_SIZE];
+    memset(ps->text, 0, num_text_props * PROP_TEXT_SIZE);
+    return ps;
+}
+
+void prop_store_free( PPROP_STORE ps )
+{
+    if (!ps)
+        return;
+    delete [] ps->slots;
+    delete [] ps->text;
+    delete ps;
+}
+
+uint32_t prop_store_begin( PPROP_STORE ps, double sim_time )
+{
+    ps->gen++;
+    ps->sim_time = sim_time;
+    return ps->gen;
+}
+
+uint32_t prop_store_generation( PPROP_STORE ps )
+{
+    return ps->gen;
+}
+
+bool prop_store_set( PPROP_STORE ps, PMP_PROP_VAL pv )
+{
+    if (!pv->plist || (pv->kind == pk_Unknown))
+        return false;
+    int ind = (int)(pv->plist - sIdPropertyList);
+    PPROP_SLOT slot = &ps->slots[ind];
+    bool changed = (slot->gen == 0);
+    switch (pv->kind) {
+    case pk_Int:
+        if (slot->ival != pv->ival)
+            changed = true;
+        slot->ival = pv->ival;
+        break;
+    case pk_Float:
+        if (slot->dval != pv->dval)
+            changed = true;
+        slot->dval = pv->dval;
+        break;
+    case pk_String:
+        {
+            int ti = vPropTextInd[ind];
+            if (ti < 0)
+                return false;
+            char *cp = &ps->text[ti * PROP_TEXT_SIZE];
+            if (strcmp(cp, pv->text)) {
+                strncpy(cp, pv->text, MAX_TEXT_SIZE);
+                cp[MAX_TEXT_SIZE] = 0;
+                changed = true;
+            }
+            slot->txtlen = (uint32_t)strlen(cp);
+        }
+        break;
+    default:
+        return false;
+    }
+    if (changed) {
+        slot->gen = ps->gen;
+        slot->sim_time = ps->sim_time;
+    }
+    return changed;
+}
+
+int prop_store_next_changed( PPROP_STORE ps, uint32_t since, int from )
+{
+    int ind;
+    for (ind = from + 1; ind < (int)numProperties; ind++) {
+        if (ps->slots[ind].gen > since)
+            return ind;
+    }
+    return -1;
+}
+
+const PROP_SLOT *prop_store_slot( PPROP_STORE ps, int ind )
+{
+    if ((ind < 0) || (ind >= (int)numProperties))
+        return 0;
+    return &ps->slots[ind];
+}
+
+const PROP_SLOT *prop_store_get( PPROP_STORE ps, unsigned id )
+{
+    int ind = find_prop_index(vPropRanges, id);
+    return (ind < 0) ? 0 : &ps->slots[ind];
+}
+
+const char *prop_store_text( PPROP_STORE ps, int ind )
+{
+    if ((ind < 0) || (ind >= (int)numProperties) || (vPropTextInd[ind] < 0))
+        return 0;
+    return &ps->text[vPropTextInd[ind] * PROP_TEXT_SIZE];
+}
+
+/////////////////////////////////////////////////////////////////////////
+// Property id use counters
+// One uint32_t per sIdPropertyList entry. Each thread counts into its own
+// shard, created on its first count, so a count is a plain increment,
+// and only prop_count_merge() walks all the shards. A duplicated id is
+// counted against its first entry, as findProperty() returns.
+#ifdef _MSC_VER
+#define PROP_TLS __declspec(thread)
+#else
+#define PROP_TLS __thread
+#endif
+
+static PROP_TLS uint32_t *tls_prop_counts = 0;
+static std::vector<uint32_t *> vPropShards;
+static std::mutex prop_shard_mutex;
+
+static uint32_t *new_prop_shard()
+{
+    uint32_t *pc = new uint32_t[numProperties];
+    memset(pc, 0, sizeof(uint32_t) * numProperties);
+    std::lock_guard<std::mutex> lock(prop_shard_mutex);
+    vPropShards.push_back(pc);
+    tls_prop_counts = pc;
+    return pc;
+}
+
+void prop_count_add( const IdPropertyList *plist )
+{
+    uint32_t *pc = tls_prop_counts;
+    if (!pc)
+        pc = new_prop_shard();
+    pc[plist - sIdPropertyList]++;
+}
+
+void prop_count_merge( vPROPCNT &v )
+{
+    PROP_COUNT pc;
+    size_t ii, jj, kk;
+    std::lock_guard<std::mutex> lock(prop_shard_mutex);
+    v.clear();
+    for (ii = 0; ii < vPropRanges.size(); ii++) {
+        const PROPRANGE &pr = vPropRanges[ii];
+        for (jj = 0; jj < pr.idx.size(); jj++) {
+            uint16_t ind = pr.idx[jj];
+            if (ind == PROP_NONE)
+                continue;
+            pc.id = pr.lo + (unsigned)jj;
+            pc.plist = &sIdPropertyList[ind];
+            pc.count = 0;
+            for (kk = 0; kk < vPropShards.size(); kk++)
+                pc.count += vPropShards[kk][ind];
+            v.push_back(pc);
+        }
+    }
+}
+
+void prop_count_clear()
+{
+    size_t ii;
+    std::lock_guard<std::mutex> lock(prop_shard_mutex);
+    for (ii = 0; ii < vPropShards.size(); ii++)
+        memset(vPropShards[ii], 0, sizeof(uint32_t) * numProperties);
+}
+
+/////////////////////////////////////////////////////////////////////////
+//// Create a full property packet
+// short FGMultiplayMgr::get_scaled_short(double v, double scale)
+static short get_scaled_short(double v, double scale)
+{
+    float nv = v * scale;
+    if (nv >= 32767) return 32767;
+    if (nv <= -32767) return -32767;
+    short rv = (short)nv;
+    return rv;
+}
+
+static int get_nxt_int()
+{
+    static int next_int = 0;
+    next_int++;
+    return next_int;
+}
+static double get_nxt_dbl()
+{
+    static double next_dbl = 0.0;
+    next_dbl += 0.1;
+    return next_dbl;
+}
+
+unsigned int Build_Prop_Packet( char *Msg, int protocolVersion, bool verb,
+    std::vector<uint32_t> &vIdsAdded, int *partcount )
+{
+    unsigned int i, pid;
+    size_t msgHdr = sizeof(T_MsgHdr);
+    size_t posMsg = sizeof(T_PositionMsg);
+    xdr_data_t *ptr = reinterpret_cast<xdr_data_t*>(Msg + msgHdr + posMsg);
+    xdr_data_t *msgEnd = reinterpret_cast<xdr_data_t*>(Msg + (MAX_PACKET_SIZE));
+    xdr_data_t *xdr;
+    int partition = 1;
+    int propsDone = 0;
+    int ival;
+    double dval;
+    const char *pt;
+    const char* lcharptr;
+    uint32_t len, plen;
+    bool overflow = false;
+
+    for (partition = 1; partition <= protocolVersion; partition++)
+    {
+        for (i = 0; i < numProperties; i++)
+        {
+            // std::vector<FGPropertyData*>::const_iterator it = motionInfo.properties.begin();
+            // while (it != motionInfo.properties.end()) {
+            pid = sIdPropertyList[i].id;
+            const struct IdPropertyList* propDef = &sIdPropertyList[i]; // mPropertyDefinition[(*it)->id];
+            
+            //if (pid > 10319)
+            //    break;
+            xdr = ptr;
+            if (propDef->version == partition || propDef->version > protocolVersion) // getProtocolToUse())
+            {
+                if (ptr + 2 >= msgEnd)
+                {
+                    // SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer packet truncated prop id: " << (*it)->id << ": " << propDef->name);
+                    SPRTF("\nWARNING: Multiplayer packet truncated prop id: %d\nnode: %s\n", pid, propDef->name);
+                    overflow = true;
+                    goto escape;
+                }
+
+                // First element is the ID. Write it out when we know we have room for
+                // the whole property.
+                xdr_data_t id = XDR_encode_uint32(pid); // (*it)->id);
+
+
+                /*
+                * 2017.2 protocol has the ability to transmit as a different type (to save space), so
+                * process this when using this protocol (protocolVersion 2) or later
+                */
+                int transmit_type = propDef->type;  // (*it)->type;
+
+                if (propDef->TransmitAs != TT_ASIS && protocolVersion > 1)
+                {
+                    transmit_type = propDef->TransmitAs;
+                }
+#if 0 // 00000000000000000000000000000000000000000
+                if (pMultiPlayDebugLevel->getIntValue() & 2)
+                    SG_LOG(SG_NETWORK, SG_INFO,
+                        "[SEND] pt " << partition <<
+                        ": buf[" << (ptr - data) * sizeof(*ptr)
+                        << "] id=" << (*it)->id << " type " << transmit_type);
+#endif // 0000000000000000000000000000000000000000
+
+                // The actual data representation depends on the type
+                switch (transmit_type) {
+                case TT_SHORTINT:
+                {
+                    if (pid == 10)
+                        ival = protocolVersion;
+                    else
+                        ival = get_nxt_int();
+                    //*ptr++ = XDR_encode_shortints32((*it)->id, (*it)->int_value);
+                    *ptr++ = XDR_encode_shortints32(pid, ival);
+                    propsDone++;
+                    partcount[partition]++;
+                    vIdsAdded.push_back(pid);
+                    plen = (char *)ptr - (char *)xdr;
+                    if (verb)
+                        SPRTF("[v9]: %5d: %s SHORTINT %d (%d)\n", pid, propDef->name, ival, (int)plen);
+                    break;
+                }
+                case TT_SHORT_FLOAT_1:
+                {
+                    //short value = get_scaled_short((*it)->float_value, 10.0);
+                    //*ptr++ = XDR_encode_shortints32((*it)->id, value);
+                    dval = get_nxt_dbl();
+                    short value = get_scaled_short(dval, 10.0);
+                    *ptr++ = XDR_encode_shortints32(pid, value);
+                    propsDone++;
+                    partcount[partition]++;
+                    vIdsAdded.push_back(pid);
+                    plen = (char *)ptr - (char *)xdr;
+                    if (verb)
+                        SPRTF("[v9]: %5d: %s FLOAT_1 %lf (%d)\n", pid, propDef->name, dval, (int)plen);
+                    break;
+                }
+                case TT_SHORT_FLOAT_2:
+                {
+                    //short value = get_scaled_short((*it)->float_value, 100.0);
+                    //*ptr++ = XDR_encode_shortints32((*it)->id, value);
+                    dval = get_nxt_dbl();
+                    short value = get_scaled_short(dval, 100.0);
+                    *ptr++ = XDR_encode_shortints32(pid, value);
+                    propsDone++;
+                    partcount[partition]++;
+                    vIdsAdded.push_back(pid);
+                    plen = (char *)ptr - (char *)xdr;
+                    if (verb)
+                        SPRTF("[v9]: %5d: %s FLOAT_2 %lf (%d)\n", pid, propDef->name, dval, (int)plen);
+                    break;
+                }
+                case TT_SHORT_FLOAT_3:
+                {
+                    //short value = get_scaled_short((*it)->float_value, 1000.0);
+                    //*ptr++ = XDR_encode_shortints32((*it)->id, value);
+                    dval = get_nxt_dbl();
+                    short value = get_scaled_short(dval, 1000.0);
+                    *ptr++ = XDR_encode_shortints32(pid, value);
+                    propsDone++;
+                    partcount[partition]++;
+                    vIdsAdded.push_back(pid);
+                    plen = (char *)ptr - (char *)xdr;
+                    if (verb)
+                        SPRTF("[v9]: %5d: %s FLOAT_3 %lf (%d)\n", pid, propDef->name, dval, (int)plen);
+                    break;
+                }
+                case TT_SHORT_FLOAT_4:
+                {
+                    //short value = get_scaled_short((*it)->float_value, 10000.0);
+                    //*ptr++ = XDR_encode_shortints32((*it)->id, value);
+                    dval = get_nxt_dbl();
+                    short value = get_scaled_short(dval, 10000.0);
+                    *ptr++ = XDR_encode_shortints32(pid, value);
+                    propsDone++;
+                    partcount[partition]++;
+                    vIdsAdded.push_back(pid);
+                    plen = (char *)ptr - (char *)xdr;
+                    if (verb)
+                        SPRTF("[v9]: %5d: %s FLOAT_4 %lf (%d)\n", pid, propDef->name, dval, (int)plen);
+                    break;
+                }
+
+                case TT_SHORT_FLOAT_NORM:
+                {
+                    //short value = get_scaled_short((*it)->float_value, 32767.0);
+                    //*ptr++ = XDR_encode_shortints32((*it)->id, value);
+                    dval = get_nxt_dbl();
+                    short value = get_scaled_short(dval, 32767.0);
+                    *ptr++ = XDR_encode_shortints32(pid, value);
+                    propsDone++;
+                    partcount[partition]++;
+                    vIdsAdded.push_back(pid);
+                    plen = (char *)ptr - (char *)xdr;
+                    if (verb)
+                        SPRTF("[v9]: %5d: %s FLOAT_N %lf (%d)\n", pid, propDef->name, dval, (int)plen);
+                    break;
+                }
+
+                case simgear::props::INT:
+                case simgear::props::BOOL:
+                case simgear::props::LONG:
+                    *ptr++ = id;
+                    //*ptr++ = XDR_encode_uint32((*it)->int_value);
+                    ival = get_nxt_int();
+                    *ptr++ = XDR_encode_uint32(ival);
+                    propsDone++;
+                    partcount[partition]++;
+                    vIdsAdded.push_back(pid);
+                    plen = (char *)ptr - (char *)xdr;
+                    if (verb)
+                        SPRTF("[v9]: %5d: %s LONG %d (%d)\n", pid, propDef->name, ival, (int)plen);
+                    break;
+                case simgear::props::FLOAT:
+                case simgear::props::DOUBLE:
+                    *ptr++ = id;
+                    dval = get_nxt_dbl();
+                    //*ptr++ = XDR_encode_float((*it)->float_value);
+                    *ptr++ = XDR_encode_float(dval);
+                    propsDone++;
+                    partcount[partition]++;
+                    vIdsAdded.push_back(pid);
+                    plen = (char *)ptr - (char *)xdr;
+                    if (verb)
+                        SPRTF("[v9]: %5d: %s DOUBLE %lf (%d)\n", pid, propDef->name, dval, (int)plen);
+                    break;
+                case simgear::props::STRING:
+                case simgear::props::UNSPECIFIED:
+                {
+                    len = 0;
+                    pt = "UNK";
+                    if (protocolVersion > 1)
+                    {
+                        // New string encoding:
+                        // xdr[0] : ID length packed into 32 bit containing two shorts.
+                        // xdr[1..len/4] The string itself (char[length])
+                        //const char* lcharptr = (*it)->string_value;
+                        lcharptr = "";
+                        pt = "STRING_N";
+                        if (lcharptr != 0)
+                        {
+                            len = strlen(lcharptr);
+                            if (len >= MAX_TEXT_SIZE)
+                            {
+                                len = MAX_TEXT_SIZE - 1;
+                                //SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer property truncated at MAX_TEXT_SIZE in string " << (*it)->id);
+                                SPRTF("\nWARNING: Multiplayer property truncated at MAX_TEXT_SIZE in string id %d\n", pid);
+                            }
+
+                            char *encodeStart = (char*)ptr;
+                            char *msgEndbyte = (char*)msgEnd;
+
+                            if (encodeStart + 2 + len >= msgEndbyte)
+                            {
+                                //SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer property not sent (no room) string " << (*it)->id);
+                                SPRTF("\nWARNING: Multiplayer property not sent (no room) string %d\n", pid);
+                                overflow = true;
+                                goto escape;
+                            }
+
+                            //*ptr++ = XDR_encode_shortints32((*it)->id, len);
+                            *ptr++ = XDR_encode_shortints32(pid, len);
+                            encodeStart = (char*)ptr;
+                            if (len != 0)
+                            {
+                                int lcount = 0;
+                                while (*lcharptr && (lcount < MAX_TEXT_SIZE))
+                                {
+                                    if (encodeStart + 2 >= msgEndbyte)
+                                    {
+                                        //SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer packet truncated in string " << (*it)->id << " lcount " << lcount);
+                                        SPRTF("\nWARNING: Multiplayer packet truncated in string %d, lcount %d\n", pid, lcount);
+                                        overflow = true;
+                                        break;
+                                    }
+                                    *encodeStart++ = *lcharptr++;
+                                    lcount++;
+                                }
+                            }
+                            ptr = (xdr_data_t*)encodeStart;
+                            propsDone++;
+                            partcount[partition]++;
+                            vIdsAdded.push_back(pid);
+                        }
+                        else
+                        {
+                            // empty string, just send the id and a zero length
+                            *ptr++ = id;
+                            *ptr++ = XDR_encode_uint32(0);
+                            propsDone++;
+                            partcount[partition]++;
+                            vIdsAdded.push_back(pid);
+                        }
+                    }
+                    else {
+
+                        // String is complicated. It consists of
+                        // The length of the string
+                        // The string itself
+                        // Padding to the nearest 4-bytes.        
+                        // const char* lcharptr = (*it)->string_value;
+                        lcharptr = "";
+                        pt = "STRING";
+                        if (lcharptr != 0)
+                        {
+                            // Add the length         
+                            ////cout << "String length: " << strlen(lcharptr) << "\n";
+                            len = strlen(lcharptr);
+                            if (len >= MAX_TEXT_SIZE)
+                            {
+                                len = MAX_TEXT_SIZE - 1;
+                                //SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer property truncated at MAX_TEXT_SIZE in string " << (*it)->id);
+                                SPRTF("\nWARNING: Multiplayer property truncated at MAX_TEXT_SIZE in string %d\n", pid );
+                            }
+
+                            // XXX This should not be using 4 bytes per character!
+                            // If there's not enough room for this property, drop it
+                            // on the floor.
+                            if (ptr + 2 + ((len + 3) & ~3) >= msgEnd)
+                            {
+                                // SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer property not sent (no room) string " << (*it)->id);
+                                SPRTF("\nWARNING: Multiplayer property not sent (no room) string %d\n", pid );
+                                overflow = true;
+                                goto escape;
+                            }
+                            //cout << "String length unint32: " << len << "\n";
+                            *ptr++ = id;
+                            *ptr++ = XDR_encode_uint32(len);
+                            if (len != 0)
+                            {
+                                // Now the text itself
+                                // XXX This should not be using 4 bytes per character!
+                                int lcount = 0;
+                                while ((*lcharptr != '\0') && (lcount < MAX_TEXT_SIZE))
+                                {
+                                    if (ptr + 2 >= msgEnd)
+                                    {
+                                        //SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer packet truncated in string " << (*it)->id << " lcount " << lcount);
+                                        SPRTF("\nWARNING: Multiplayer packet truncated in string %d, lcount %d\n", pid, lcount);
+                                        overflow = true;
+                                        break;
+                                    }
+                                    *ptr++ = XDR_encode_int8(*lcharptr);
+                                    lcharptr++;
+                                    lcount++;
+                                }
+                                // Now pad if required
+                                while ((lcount % 4) != 0)
+                                {
+                                    if (ptr + 2 >= msgEnd)
+                                    {
+                                        // SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer packet truncated in string " << (*it)->id << " lcount " << lcount);
+                                        SPRTF("\nWARNING: Multiplayer packet truncated in string %d, lcount %d\n", pid, lcount);
+                                        overflow = true;
+                                        break;
+                                    }
+                                    *ptr++ = XDR_encode_int8(0);
+                                    lcount++;
+                                }
+                            }
+                            propsDone++;
+                            partcount[partition]++;
+                            vIdsAdded.push_back(pid);
+                        }
+                        else
+                        {
+                            // Nothing to encode
+                            *ptr++ = id;
+                            *ptr++ = XDR_encode_uint32(0);
+                            propsDone++;
+                            partcount[partition]++;
+                            vIdsAdded.push_back(pid);
+                        }
+                    }
+                    plen = (char *)ptr - (char *)xdr;
+                    if (verb)
+                        SPRTF("[v9]: %5d: %s %s %d (%d)\n", pid, propDef->name, pt, (int)len, (int)plen);
+
+                }
+                break;
+
+                default:
+                    *ptr++ = id;
+                    //*ptr++ = XDR_encode_float((*it)->float_value);;
+                    dval = get_nxt_dbl();
+                    *ptr++ = XDR_encode_float(dval);
+                    propsDone++;
+                    partcount[partition]++;
+                    vIdsAdded.push_back(pid);
+                    plen = (char *)ptr - (char *)xdr;
+                    if (verb)
+                        SPRTF("[v9]: %5d: %s DEF_DOUBLE %lf\n", pid, propDef->name, dval, (int)plen);
+                    break;
+                }
+            }
+            //++it;
+            if (overflow)
+                break;
+        }
+        if (overflow)
+            break;
+    }
+escape:
+    unsigned int msgLen = reinterpret_cast<char*>(ptr) - Msg;   // msgBuf.Msg;
+    return msgLen;
+}
+
+// eof - mp-props.cxx
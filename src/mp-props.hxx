@@ -0,0 +1,249 @@
+/*\
+ * mp-props.hxx
+ *
+ * Copyright (c) 2015 - Geoff R. McLane
+ * Licence: GNU GPL version 2
+ *
+\*/
+/*\
+ * The MP protocol property id table, and lookups, shared by raw-log and cf-bench
+\*/
+#ifndef _MP_PROPS_HXX_
+#define _MP_PROPS_HXX_
+#include <stdint.h>
+#include <vector>
+#include "mpMsgs.hxx"
+
+#ifndef MAX_PACKET_SIZE
+#define MAX_PACKET_SIZE 1200
+#endif
+#ifndef MAX_TEXT_SIZE
+#define MAX_TEXT_SIZE 128
+#endif
+
+enum sgp_Type {
+    sgp_UNKNOW,
+    sgp_FLOAT,
+    sgp_STRING,
+    sgp_BOOL,
+    sgp_INT
+};
+
+namespace simgear
+{
+    namespace props
+    {
+        /**
+        * The possible types of an SGPropertyNode. Types that appear after
+        * EXTENDED are not stored in the SGPropertyNode itself.
+        */
+        enum Type {
+            NONE = 0, /**< The node hasn't been assigned a value yet. */
+            ALIAS, /**< The node "points" to another node. */
+            BOOL,
+            INT,
+            LONG,
+            FLOAT,
+            DOUBLE,
+            STRING,
+            UNSPECIFIED,
+            EXTENDED, /**< The node's value is not stored in the property;
+                      * the actual value and type is retrieved from an
+                      * SGRawValue node. This type is never returned by @see
+                      * SGPropertyNode::getType.
+                      */
+                      // Extended properties
+                      VEC3D,
+                      VEC4D
+        };
+
+        template<typename T> struct PropertyTraits;
+
+#define DEFINTERNALPROP(TYPE, PROP) \
+template<> \
+struct PropertyTraits<TYPE> \
+{ \
+    static const Type type_tag = PROP; \
+    enum  { Internal = 1 }; \
+}
+
+        DEFINTERNALPROP(bool, BOOL);
+        DEFINTERNALPROP(int, INT);
+        DEFINTERNALPROP(long, LONG);
+        DEFINTERNALPROP(float, FLOAT);
+        DEFINTERNALPROP(double, DOUBLE);
+        DEFINTERNALPROP(const char *, STRING);
+        DEFINTERNALPROP(const char[], STRING);
+#undef DEFINTERNALPROP
+
+    };
+
+};
+
+struct FGPropertyData {
+    unsigned id;
+
+    // While the type isn't transmitted, it is needed for the destructor
+    simgear::props::Type type;
+    union {
+        int int_value;
+        float float_value;
+        char* string_value;
+    };
+
+    ~FGPropertyData() {
+        if ((type == simgear::props::STRING) || (type == simgear::props::UNSPECIFIED))
+        {
+            delete[] string_value;
+        }
+    }
+};
+
+
+
+/*
+* With the MP2017(V2) protocol it should be possible to transmit using a different type/encoding than the property has,
+* so it should be possible to transmit a bool as
+*/
+enum TransmissionType {
+    TT_ASIS = 0, // transmit as defined in the property. This is the default
+    TT_BOOL = simgear::props::BOOL,
+    TT_INT = simgear::props::INT,
+    TT_FLOAT = simgear::props::FLOAT,
+    TT_STRING = simgear::props::STRING,
+    TT_SHORTINT = 0x100,
+    TT_SHORT_FLOAT_NORM = 0x101, // -1 .. 1 encoded into a short int (16 bit)
+    TT_SHORT_FLOAT_1 = 0x102, //range -3276.7 .. 3276.7  float encoded into a short int (16 bit) 
+    TT_SHORT_FLOAT_2 = 0x103, //range -327.67 .. 327.67  float encoded into a short int (16 bit) 
+    TT_SHORT_FLOAT_3 = 0x104, //range -32.767 .. 32.767  float encoded into a short int (16 bit) 
+    TT_SHORT_FLOAT_4 = 0x105, //range -3.2767 .. 3.2767  float encoded into a short int (16 bit) 
+    TT_BOOLARRAY,
+    TT_CHAR,
+};
+/*
+* Definitions for the version of the protocol to use to transmit the items defined in the IdPropertyList
+*
+* The MP2017(V2) protocol allows for much better packing of strings, new types that are transmitted in 4bytes by transmitting
+* with short int (sometimes scaled) for the values (a lot of the properties that are transmitted will pack nicely into 16bits).
+* The MP2017(V2) protocol also allows for properties to be transmitted automatically as a different type and the encode/decode will
+* take this into consideration.
+* The pad magic is used to force older clients to use verifyProperties and as the first property transmitted is short int encoded it
+* will cause the rest of the packet to be discarded. This is the section of the packet that contains the properties defined in the list
+* here - the basic motion properties remain compatible, so the older client will see just the model, not chat, not animations etc.
+*/
+const int V1_1_PROP_ID = 1;
+const int V1_1_2_PROP_ID = 2;
+const int V2_PAD_MAGIC = 0x1face002;
+
+/*
+* definition of properties that are to be transmitted.
+* New for 2017.2:
+* 1. TransmitAs - this causes the property to be transmitted on the wire using the
+*    specified format transparently.
+* 2. version - the minimum version of the protocol that is required to transmit a property.
+*    Does not apply to incoming properties - as these will be decoded correctly when received
+* 3. Convert; not implemented. Planned to allow property specific conversion rules to be applied
+*/
+struct IdPropertyList {
+    unsigned id;
+    const char* name;
+    simgear::props::Type type;
+    TransmissionType TransmitAs;
+    int version;
+    int(*convert)(int direction, xdr_data_t*, FGPropertyData*);
+};
+
+struct IdPropertyList1 {
+    unsigned id;
+    const char* name;
+    sgp_Type type;
+};
+
+/*
+* For the 2017.x version 2 protocol the properties are sent in two partitions,
+* the first of these is a V1 protocol packet (which should be fine with all clients), and a V2 partition
+* which will contain the newly supported shortint and fixed string encoding schemes.
+* This is to possibly allow for easier V1/V2 conversion - as the packet can simply be truncated at the
+* first V2 property based on ID.
+*/
+const int MAX_PARTITIONS = 2;
+
+extern const IdPropertyList sIdPropertyList[];
+extern const unsigned int numProperties;
+extern const IdPropertyList* findProperty(unsigned id);
+
+extern const IdPropertyList1 sIdPropertyList1[];
+extern const unsigned int numProperties1;
+extern const IdPropertyList1* findProperty1(unsigned id);
+
+// One decoded property, from Decode_Property()
+enum Prop_Kind {
+    pk_Unknown,     // id not in the table, or type not handled
+    pk_Int,
+    pk_Float,
+    pk_String
+};
+
+typedef struct tagMP_PROP_VAL {
+    unsigned id;
+    const IdPropertyList *plist;    // 0 if id not in the table
+    Prop_Kind kind;
+    const char *dt;     // decode type, for display
+    int ival;
+    double dval;
+    const char *text;   // string value, in a static buffer
+    uint32_t txtlen;
+}MP_PROP_VAL, *PMP_PROP_VAL;
+
+// Decode the property at xdr, through the per id decoder precompiled from
+// its table entry, into pv. Returns the xdr following the property.
+extern xdr_data_t *Decode_Property( xdr_data_t *xdr, PMP_PROP_VAL pv );
+
+// Per flight store of the last decoded property values
+// One fixed slot per sIdPropertyList entry, plus a fixed text buffer per
+// string property, so the memory per flight is bounded, and allocated once.
+// Each packet begins a new generation, and a slot records the generation,
+// and sim time, at which its value last changed.
+typedef struct tagPROP_SLOT {
+    uint32_t gen;       // generation of the last change, 0 = never seen
+    uint32_t txtlen;    // string length, for pk_String
+    union {
+        int ival;
+        double dval;
+    };
+    double sim_time;    // sim time of the last change
+}PROP_SLOT, *PPROP_SLOT;
+
+typedef struct tagPROP_STORE *PPROP_STORE;
+
+extern PPROP_STORE prop_store_new();
+extern void prop_store_free( PPROP_STORE ps );
+extern uint32_t prop_store_begin( PPROP_STORE ps, double sim_time ); // start a packet, returns its generation
+extern bool prop_store_set( PPROP_STORE ps, PMP_PROP_VAL pv ); // true if the value changed
+extern uint32_t prop_store_generation( PPROP_STORE ps );
+// next slot index after 'from' changed since generation 'since', or -1. Start with from = -1
+extern int prop_store_next_changed( PPROP_STORE ps, uint32_t since, int from );
+extern const PROP_SLOT *prop_store_slot( PPROP_STORE ps, int ind ); // the sIdPropertyList[ind] slot
+extern const PROP_SLOT *prop_store_get( PPROP_STORE ps, unsigned id ); // 0 if not a known id
+extern const char *prop_store_text( PPROP_STORE ps, int ind ); // string value, or 0
+
+// Property id use counters
+// a flat count per table entry, counted per thread, merged for the report
+typedef struct tagPROP_COUNT {
+    unsigned id;
+    const IdPropertyList *plist;
+    uint32_t count;
+}PROP_COUNT;
+typedef std::vector<PROP_COUNT> vPROPCNT;
+
+extern void prop_count_add( const IdPropertyList *plist ); // plist from findProperty() or Decode_Property()
+extern void prop_count_merge( vPROPCNT &v ); // one per unique id, in id order, summed over threads
+extern void prop_count_clear();
+
+// Encode every property in the table, with test values, after the header and
+// position message in Msg, which must be MAX_PACKET_SIZE. Returns the message length.
+extern unsigned int Build_Prop_Packet( char *Msg, int protocolVersion, bool verb,
+    std::vector<uint32_t> &vIdsAdded, int *partcount );
+
+#endif // #ifndef _MP_PROPS_HXX_
+// eof - mp-props.hxx
@@ -46,6 +46,14 @@
 #include "tiny_xdr.hxx"
 #endif
 #include "cf_misc.hxx"
+#include "cf_trace.hxx"
+#include "cf_clock.hxx"
+#include "cf_rawframe.hxx"
+#include "cf_reclog.hxx"
+#ifdef USE_BLOCK_LOG
+#include "cf_blklog.hxx"
+#endif
+#include "mp-props.hxx"
 
 #ifndef SPRTF
 #define SPRTF printf
@@ -65,8 +73,6 @@ static const char *module = "raw-log";
 #define MEOL "\n"
 #endif
 #endif
-#define MAX_PACKET_SIZE 1200
-#define MAX_TEXT_SIZE 128
 
 static int verbosity = 1;
 #define VERB1 (verbosity >= 1)
@@ -76,16 +82,24 @@ static int verbosity = 1;
 
 static const char *def_log = "tempraw.txt";
 static const char *def_dump = "tempdump.pkt";
+static const char *journal = 0;   // binary pilot event journal, if any
+static const char *convert = 0;   // write the input as a recording, or a recording as raw
+#ifdef USE_BLOCK_LOG
+static const char *zip_out = 0;   // write the input as a block compressed log
+static PBLKLOG blk_log = 0;     // the input is a block compressed log
+#endif
 static const char *usr_input = 0;
 static struct stat sbuf;
-static FILE *raw_log_fp = 0;
-static char *raw_log_buffer = 0;
-static size_t raw_block_size = 0;
-static size_t raw_data_size = 0;
+static PRAWFRAME raw_frame = 0;  // the raw log, framed, and read ahead
+static char *raw_packet = 0;    // its next packet
+static int raw_len = 0;
 static double raw_bgn_secs = 0.0;   // start of raw log reading
 static size_t raw_log_size = 0;
 static size_t raw_log_remaining = 0;
 static size_t packet_cnt = 0;
+static PRECLOG rec_log = 0;     // the input is a compact recording
+static char *rec_packet = 0;    // its next packet
+static int rec_len = 0;
 static int show_consumed_bytes = 0;
 #if !defined(NDEBUG) && defined(_MSC_VER)
 static const char *sample = "F:\\Projects\\cf-log\\data\\sampleudp01.log";
@@ -109,22 +123,7 @@ int add_2_list(char *msg)
     return 1;   // signal it is new and added
 }
 
-static vUINT vIdsUsed;
-void add_id_count(unsigned int id);
-int add_2_ids(uint32_t id)
-{
-    add_id_count(id);
-    size_t ii, len = vIdsUsed.size();
-    uint32_t ui;
-    for (ii = 0; ii < len; ii++) {
-        ui = vIdsUsed[ii];
-        if (ui == id)
-            return 0;
-    }
-    vIdsUsed.push_back(id);
-    return 1;
-}
-
+void add_id_count(const IdPropertyList *plist);
 void show_warnings()
 {
     std::string s;
@@ -221,9 +220,22 @@ void give_help( char *name )
     SPRTF(" --verb[n]     (-v) = Bump or set verbosity to n. Values 0,1,2,5,9 (def=%d)\n", verbosity);
     SPRTF(" --log <file>  (-l) = Set name of output log. (def=%s)\n", def_log);
     SPRTF(" --test        (-t) = Do packet test, and exit(1) (def=%d)\n", do_packet_test);
+    SPRTF(" --journal <file> (-j) = Write a binary journal of pilot events. (def=%s)\n",
+        (journal ? journal : "none"));
+    SPRTF(" --convert <file> (-c) = Write a raw log input as a compact recording, or a recording as a raw log, and exit.\n");
+#ifdef USE_BLOCK_LOG
+    SPRTF(" --zip <file>  (-z) = Write a raw log input as a block compressed, seekable, log, and exit.\n");
+    SPRTF("                      --convert of a block compressed log writes it as a raw log.\n");
+#endif
     SPRTF("\n");
     SPRTF("Description:\n");
     SPRTF(" Read and decode a raw log of FGFS mp packets, and output information found.\n");
+    SPRTF(" The input can also be a compact recording, written by --convert, which is\n");
+    SPRTF(" typically 5 to 10 times smaller than the raw log, and faster to read.\n");
+#ifdef USE_BLOCK_LOG
+    SPRTF(" Or a block compressed log, written by --zip, which cf-server can replay from\n");
+    SPRTF(" any time offset, with --at.\n");
+#endif
     SPRTF(" To be fully effective, this utility needs to link with SimGearCore.lib, but has some\n");
     SPRTF(" not so well tested alterative maths and xdr decoding available.\n");
     SPRTF("\n");
@@ -277,6 +289,38 @@ int parse_args( int argc, char **argv )
             case 't':
                 do_packet_test = 1;
                 break;
+            case 'j':
+                if (i2 < argc) {
+                    i++;
+                    journal = strdup(argv[i]);
+                }
+                else {
+                    SPRTF("%s: Expected journal file to follow '%s'!\n", module, arg);
+                    return 1;
+                }
+                break;
+            case 'c':
+                if (i2 < argc) {
+                    i++;
+                    convert = strdup(argv[i]);
+                }
+                else {
+                    SPRTF("%s: Expected output file to follow '%s'!\n", module, arg);
+                    return 1;
+                }
+                break;
+#ifdef USE_BLOCK_LOG
+            case 'z':
+                if (i2 < argc) {
+                    i++;
+                    zip_out = strdup(argv[i]);
+                }
+                else {
+                    SPRTF("%s: Expected output file to follow '%s'!\n", module, arg);
+                    return 1;
+                }
+                break;
+#endif
                 // TODO: Other arguments
             default:
                 SPRTF("%s: Unknown argument '%s'. Try -? for help...\n", module, arg);
@@ -359,6 +403,7 @@ typedef struct tagCF_Pilot {
     double          total_nm, cumm_nm;   // total distance since start
     time_t          exp_time;    // time expired - epoch secs
     time_t          last_seen;  // last packet seen - epoch secs
+    PPROP_STORE     props;      // last property values of this flight
 }CF_Pilot, *PCF_Pilot;
 
 typedef std::vector<CF_Pilot> vCFP;
@@ -428,6 +473,28 @@ void print_pilot(PCF_Pilot pp, char *pm, Pilot_Type pt)
     SPRTF(cp);
 }
 
+///////////////////////////////////////////////////////////////////////////
+// Add the pilot event to the binary journal, if one is open
+static void trace_pilot(PCF_Pilot pp, Trace_Event ev)
+{
+    CF_TRACE_REC rec;
+    if (!trace_on)
+        return;
+    rec.epoch_usecs = clock_now_usecs();  // cached, virtual in a fast replay
+    rec.sim_time = pp->sim_time;
+    rec.flight_id = pp->flight_id;
+    memcpy(rec.callsign, pp->callsign, CF_TRACE_CS_LEN);
+    rec.lat = pp->lat;
+    rec.lon = pp->lon;
+    rec.alt = (float)pp->alt;
+    rec.speed = (float)pp->speed;
+    rec.value = 0;
+    rec.event = (uint8_t)ev;
+    rec.reason = (uint8_t)trr_None;
+    rec.heading = (uint16_t)(int)(pp->heading + 0.5);
+    trace_add(&rec);
+}
+
 
 //////////////////////////////////////////////////////////////////////
 // Rather rough service to remove leading PATH
@@ -459,13 +526,6 @@ char *get_Model(char *pm)
     return cp;
 }
 
-enum sgp_Type {
-    sgp_UNKNOW,
-    sgp_FLOAT,
-    sgp_STRING,
-    sgp_BOOL,
-    sgp_INT
-};
 
 #ifndef USE_SIMGEAR
 typedef struct tagT2STG {
@@ -500,56 +560,6 @@ static const char *type2stg(sgp_Type t)
 
 #ifdef USE_PROTO_2
 
-namespace simgear
-{
-    namespace props
-    {
-        /**
-        * The possible types of an SGPropertyNode. Types that appear after
-        * EXTENDED are not stored in the SGPropertyNode itself.
-        */
-        enum Type {
-            NONE = 0, /**< The node hasn't been assigned a value yet. */
-            ALIAS, /**< The node "points" to another node. */
-            BOOL,
-            INT,
-            LONG,
-            FLOAT,
-            DOUBLE,
-            STRING,
-            UNSPECIFIED,
-            EXTENDED, /**< The node's value is not stored in the property;
-                      * the actual value and type is retrieved from an
-                      * SGRawValue node. This type is never returned by @see
-                      * SGPropertyNode::getType.
-                      */
-                      // Extended properties
-                      VEC3D,
-                      VEC4D
-        };
-
-        template<typename T> struct PropertyTraits;
-
-#define DEFINTERNALPROP(TYPE, PROP) \
-template<> \
-struct PropertyTraits<TYPE> \
-{ \
-    static const Type type_tag = PROP; \
-    enum  { Internal = 1 }; \
-}
-
-        DEFINTERNALPROP(bool, BOOL);
-        DEFINTERNALPROP(int, INT);
-        DEFINTERNALPROP(long, LONG);
-        DEFINTERNALPROP(float, FLOAT);
-        DEFINTERNALPROP(double, DOUBLE);
-        DEFINTERNALPROP(const char *, STRING);
-        DEFINTERNALPROP(const char[], STRING);
-#undef DEFINTERNALPROP
-
-    };
-
-};
 
 // try to avoid gcc warning about missing enums...
 static const char *type2stg(simgear::props::Type t)
@@ -585,388 +595,11 @@ static const char *type2stg(simgear::props::Type t)
     return pt;
 }
 
-struct FGPropertyData {
-    unsigned id;
-
-    // While the type isn't transmitted, it is needed for the destructor
-    simgear::props::Type type;
-    union {
-        int int_value;
-        float float_value;
-        char* string_value;
-    };
-
-    ~FGPropertyData() {
-        if ((type == simgear::props::STRING) || (type == simgear::props::UNSPECIFIED))
-        {
-            delete[] string_value;
-        }
-    }
-};
-
 
 
-/*
-* With the MP2017(V2) protocol it should be possible to transmit using a different type/encoding than the property has,
-* so it should be possible to transmit a bool as
-*/
-enum TransmissionType {
-    TT_ASIS = 0, // transmit as defined in the property. This is the default
-    TT_BOOL = simgear::props::BOOL,
-    TT_INT = simgear::props::INT,
-    TT_FLOAT = simgear::props::FLOAT,
-    TT_STRING = simgear::props::STRING,
-    TT_SHORTINT = 0x100,
-    TT_SHORT_FLOAT_NORM = 0x101, // -1 .. 1 encoded into a short int (16 bit)
-    TT_SHORT_FLOAT_1 = 0x102, //range -3276.7 .. 3276.7  float encoded into a short int (16 bit) 
-    TT_SHORT_FLOAT_2 = 0x103, //range -327.67 .. 327.67  float encoded into a short int (16 bit) 
-    TT_SHORT_FLOAT_3 = 0x104, //range -32.767 .. 32.767  float encoded into a short int (16 bit) 
-    TT_SHORT_FLOAT_4 = 0x105, //range -3.2767 .. 3.2767  float encoded into a short int (16 bit) 
-    TT_BOOLARRAY,
-    TT_CHAR,
-};
-/*
-* Definitions for the version of the protocol to use to transmit the items defined in the IdPropertyList
-*
-* The MP2017(V2) protocol allows for much better packing of strings, new types that are transmitted in 4bytes by transmitting
-* with short int (sometimes scaled) for the values (a lot of the properties that are transmitted will pack nicely into 16bits).
-* The MP2017(V2) protocol also allows for properties to be transmitted automatically as a different type and the encode/decode will
-* take this into consideration.
-* The pad magic is used to force older clients to use verifyProperties and as the first property transmitted is short int encoded it
-* will cause the rest of the packet to be discarded. This is the section of the packet that contains the properties defined in the list
-* here - the basic motion properties remain compatible, so the older client will see just the model, not chat, not animations etc.
-*/
-const int V1_1_PROP_ID = 1;
-const int V1_1_2_PROP_ID = 2;
-const int V2_PAD_MAGIC = 0x1face002;
-
-/*
-* definition of properties that are to be transmitted.
-* New for 2017.2:
-* 1. TransmitAs - this causes the property to be transmitted on the wire using the
-*    specified format transparently.
-* 2. version - the minimum version of the protocol that is required to transmit a property.
-*    Does not apply to incoming properties - as these will be decoded correctly when received
-* 3. Convert; not implemented. Planned to allow property specific conversion rules to be applied
-*/
-struct IdPropertyList {
-    unsigned id;
-    const char* name;
-    simgear::props::Type type;
-    TransmissionType TransmitAs;
-    int version;
-    int(*convert)(int direction, xdr_data_t*, FGPropertyData*);
-};
-
-static const IdPropertyList* findProperty(unsigned id);
-
-#if 0 // 0000000000000000000000000000000000000000
-/*
-* not yet used method to avoid transmitting a string for something that should always have been
-* an integer
-*/
-static int convert_launchbar_state(int direction, xdr_data_t*, FGPropertyData*)
-{
-    return 0; // no conversion performed
-}
-#endif // 000000000000000000000000000000000000000
-
-// A static map of protocol property id values to property paths,
-// This should be extendable dynamically for every specific aircraft ...
-// For now only that static list
-static const IdPropertyList sIdPropertyList[] = {
-    { 10,  "sim/multiplay/protocol-version",          simgear::props::INT,   TT_SHORTINT,  V1_1_PROP_ID, NULL },
-    { 100, "surface-positions/left-aileron-pos-norm",  simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 101, "surface-positions/right-aileron-pos-norm", simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 102, "surface-positions/elevator-pos-norm",      simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 103, "surface-positions/rudder-pos-norm",        simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 104, "surface-positions/flap-pos-norm",          simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 105, "surface-positions/speedbrake-pos-norm",    simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 106, "gear/tailhook/position-norm",              simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 107, "gear/launchbar/position-norm",             simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 108, "gear/launchbar/state",                     simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 109, "gear/launchbar/holdback-position-norm",    simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 110, "canopy/position-norm",                     simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 111, "surface-positions/wing-pos-norm",          simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 112, "surface-positions/wing-fold-pos-norm",     simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-
-    { 200, "gear/gear[0]/compression-norm",           simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 201, "gear/gear[0]/position-norm",              simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 210, "gear/gear[1]/compression-norm",           simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 211, "gear/gear[1]/position-norm",              simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 220, "gear/gear[2]/compression-norm",           simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 221, "gear/gear[2]/position-norm",              simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 230, "gear/gear[3]/compression-norm",           simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 231, "gear/gear[3]/position-norm",              simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 240, "gear/gear[4]/compression-norm",           simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-    { 241, "gear/gear[4]/position-norm",              simgear::props::FLOAT, TT_SHORT_FLOAT_NORM,  V1_1_PROP_ID, NULL },
-
-    { 300, "engines/engine[0]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 301, "engines/engine[0]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 302, "engines/engine[0]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 310, "engines/engine[1]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 311, "engines/engine[1]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 312, "engines/engine[1]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 320, "engines/engine[2]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 321, "engines/engine[2]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 322, "engines/engine[2]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 330, "engines/engine[3]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 331, "engines/engine[3]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 332, "engines/engine[3]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 340, "engines/engine[4]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 341, "engines/engine[4]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 342, "engines/engine[4]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 350, "engines/engine[5]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 351, "engines/engine[5]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 352, "engines/engine[5]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 360, "engines/engine[6]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 361, "engines/engine[6]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 362, "engines/engine[6]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 370, "engines/engine[7]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 371, "engines/engine[7]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 372, "engines/engine[7]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 380, "engines/engine[8]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 381, "engines/engine[8]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 382, "engines/engine[8]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 390, "engines/engine[9]/n1",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 391, "engines/engine[9]/n2",  simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 392, "engines/engine[9]/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-
-    { 800, "rotors/main/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 801, "rotors/tail/rpm", simgear::props::FLOAT, TT_SHORT_FLOAT_1,  V1_1_PROP_ID, NULL },
-    { 810, "rotors/main/blade[0]/position-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
-    { 811, "rotors/main/blade[1]/position-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
-    { 812, "rotors/main/blade[2]/position-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
-    { 813, "rotors/main/blade[3]/position-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
-    { 820, "rotors/main/blade[0]/flap-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
-    { 821, "rotors/main/blade[1]/flap-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
-    { 822, "rotors/main/blade[2]/flap-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
-    { 823, "rotors/main/blade[3]/flap-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
-    { 830, "rotors/tail/blade[0]/position-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
-    { 831, "rotors/tail/blade[1]/position-deg",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
-
-    { 900, "sim/hitches/aerotow/tow/length",                       simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 901, "sim/hitches/aerotow/tow/elastic-constant",             simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 902, "sim/hitches/aerotow/tow/weight-per-m-kg-m",            simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 903, "sim/hitches/aerotow/tow/dist",                         simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 904, "sim/hitches/aerotow/tow/connected-to-property-node",   simgear::props::BOOL, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 905, "sim/hitches/aerotow/tow/connected-to-ai-or-mp-callsign",   simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 906, "sim/hitches/aerotow/tow/brake-force",                  simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 907, "sim/hitches/aerotow/tow/end-force-x",                  simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 908, "sim/hitches/aerotow/tow/end-force-y",                  simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 909, "sim/hitches/aerotow/tow/end-force-z",                  simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 930, "sim/hitches/aerotow/is-slave",                         simgear::props::BOOL, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 931, "sim/hitches/aerotow/speed-in-tow-direction",           simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 932, "sim/hitches/aerotow/open",                             simgear::props::BOOL, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 933, "sim/hitches/aerotow/local-pos-x",                      simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 934, "sim/hitches/aerotow/local-pos-y",                      simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 935, "sim/hitches/aerotow/local-pos-z",                      simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-
-    { 1001, "controls/flight/slats",  simgear::props::FLOAT, TT_SHORT_FLOAT_4,  V1_1_PROP_ID, NULL },
-    { 1002, "controls/flight/speedbrake",  simgear::props::FLOAT, TT_SHORT_FLOAT_4,  V1_1_PROP_ID, NULL },
-    { 1003, "controls/flight/spoilers",  simgear::props::FLOAT, TT_SHORT_FLOAT_4,  V1_1_PROP_ID, NULL },
-    { 1004, "controls/gear/gear-down",  simgear::props::FLOAT, TT_SHORT_FLOAT_4,  V1_1_PROP_ID, NULL },
-    { 1005, "controls/lighting/nav-lights",  simgear::props::FLOAT, TT_SHORT_FLOAT_3,  V1_1_PROP_ID, NULL },
-    { 1006, "controls/armament/station[0]/jettison-all",  simgear::props::BOOL, TT_SHORTINT,  V1_1_PROP_ID, NULL },
-
-    { 1100, "sim/model/variant", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 1101, "sim/model/livery/file", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-
-    { 1200, "environment/wildfire/data", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 1201, "environment/contrail", simgear::props::INT, TT_SHORTINT,  V1_1_PROP_ID, NULL },
-
-    { 1300, "tanker", simgear::props::INT, TT_SHORTINT,  V1_1_PROP_ID, NULL },
-
-    { 1400, "scenery/events", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-
-    { 1500, "instrumentation/transponder/transmitted-id", simgear::props::INT, TT_SHORTINT,  V1_1_PROP_ID, NULL },
-    { 1501, "instrumentation/transponder/altitude", simgear::props::INT, TT_ASIS, V1_1_PROP_ID, NULL },
-    { 1502, "instrumentation/transponder/ident", simgear::props::BOOL, TT_SHORTINT, V1_1_PROP_ID, NULL },
-    { 1503, "instrumentation/transponder/inputs/mode", simgear::props::INT, TT_SHORTINT, V1_1_PROP_ID, NULL },
-
-    { 10001, "sim/multiplay/transmission-freq-hz",  simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10002, "sim/multiplay/chat",  simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-
-    { 10100, "sim/multiplay/generic/string[0]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10101, "sim/multiplay/generic/string[1]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10102, "sim/multiplay/generic/string[2]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10103, "sim/multiplay/generic/string[3]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10104, "sim/multiplay/generic/string[4]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10105, "sim/multiplay/generic/string[5]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10106, "sim/multiplay/generic/string[6]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10107, "sim/multiplay/generic/string[7]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10108, "sim/multiplay/generic/string[8]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10109, "sim/multiplay/generic/string[9]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10110, "sim/multiplay/generic/string[10]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10111, "sim/multiplay/generic/string[11]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10112, "sim/multiplay/generic/string[12]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10113, "sim/multiplay/generic/string[13]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10114, "sim/multiplay/generic/string[14]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10115, "sim/multiplay/generic/string[15]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10116, "sim/multiplay/generic/string[16]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10117, "sim/multiplay/generic/string[17]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10118, "sim/multiplay/generic/string[18]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-    { 10119, "sim/multiplay/generic/string[19]", simgear::props::STRING, TT_ASIS,  V1_1_2_PROP_ID, NULL },
-
-    { 10200, "sim/multiplay/generic/float[0]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10201, "sim/multiplay/generic/float[1]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10202, "sim/multiplay/generic/float[2]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10203, "sim/multiplay/generic/float[3]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10204, "sim/multiplay/generic/float[4]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10205, "sim/multiplay/generic/float[5]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10206, "sim/multiplay/generic/float[6]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10207, "sim/multiplay/generic/float[7]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10208, "sim/multiplay/generic/float[8]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10209, "sim/multiplay/generic/float[9]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10210, "sim/multiplay/generic/float[10]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10211, "sim/multiplay/generic/float[11]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10212, "sim/multiplay/generic/float[12]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10213, "sim/multiplay/generic/float[13]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10214, "sim/multiplay/generic/float[14]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10215, "sim/multiplay/generic/float[15]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10216, "sim/multiplay/generic/float[16]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10217, "sim/multiplay/generic/float[17]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10218, "sim/multiplay/generic/float[18]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10219, "sim/multiplay/generic/float[19]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-
-    { 10220, "sim/multiplay/generic/float[20]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10221, "sim/multiplay/generic/float[21]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10222, "sim/multiplay/generic/float[22]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10223, "sim/multiplay/generic/float[23]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10224, "sim/multiplay/generic/float[24]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10225, "sim/multiplay/generic/float[25]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10226, "sim/multiplay/generic/float[26]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10227, "sim/multiplay/generic/float[27]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10228, "sim/multiplay/generic/float[28]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10229, "sim/multiplay/generic/float[29]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10230, "sim/multiplay/generic/float[30]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10231, "sim/multiplay/generic/float[31]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10232, "sim/multiplay/generic/float[32]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10233, "sim/multiplay/generic/float[33]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10234, "sim/multiplay/generic/float[34]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10235, "sim/multiplay/generic/float[35]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10236, "sim/multiplay/generic/float[36]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10237, "sim/multiplay/generic/float[37]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10238, "sim/multiplay/generic/float[38]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10239, "sim/multiplay/generic/float[39]", simgear::props::FLOAT, TT_ASIS,  V1_1_PROP_ID, NULL },
-
-    { 10300, "sim/multiplay/generic/int[0]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10301, "sim/multiplay/generic/int[1]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10302, "sim/multiplay/generic/int[2]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10303, "sim/multiplay/generic/int[3]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10304, "sim/multiplay/generic/int[4]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10305, "sim/multiplay/generic/int[5]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10306, "sim/multiplay/generic/int[6]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10307, "sim/multiplay/generic/int[7]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10308, "sim/multiplay/generic/int[8]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10309, "sim/multiplay/generic/int[9]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10310, "sim/multiplay/generic/int[10]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10311, "sim/multiplay/generic/int[11]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10312, "sim/multiplay/generic/int[12]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10313, "sim/multiplay/generic/int[13]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10314, "sim/multiplay/generic/int[14]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10315, "sim/multiplay/generic/int[15]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10316, "sim/multiplay/generic/int[16]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10317, "sim/multiplay/generic/int[17]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10318, "sim/multiplay/generic/int[18]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-    { 10319, "sim/multiplay/generic/int[19]", simgear::props::INT, TT_ASIS,  V1_1_PROP_ID, NULL },
-
-    { 10500, "sim/multiplay/generic/short[0]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10501, "sim/multiplay/generic/short[1]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10502, "sim/multiplay/generic/short[2]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10503, "sim/multiplay/generic/short[3]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10504, "sim/multiplay/generic/short[4]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10505, "sim/multiplay/generic/short[5]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10506, "sim/multiplay/generic/short[6]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10507, "sim/multiplay/generic/short[7]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10508, "sim/multiplay/generic/short[8]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10509, "sim/multiplay/generic/short[9]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10510, "sim/multiplay/generic/short[10]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10511, "sim/multiplay/generic/short[11]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10512, "sim/multiplay/generic/short[12]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10513, "sim/multiplay/generic/short[13]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10514, "sim/multiplay/generic/short[14]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10515, "sim/multiplay/generic/short[15]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10516, "sim/multiplay/generic/short[16]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10517, "sim/multiplay/generic/short[17]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10518, "sim/multiplay/generic/short[18]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10519, "sim/multiplay/generic/short[19]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10520, "sim/multiplay/generic/short[20]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10521, "sim/multiplay/generic/short[21]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10522, "sim/multiplay/generic/short[22]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10523, "sim/multiplay/generic/short[23]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10524, "sim/multiplay/generic/short[24]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10525, "sim/multiplay/generic/short[25]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10526, "sim/multiplay/generic/short[26]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10527, "sim/multiplay/generic/short[27]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10528, "sim/multiplay/generic/short[28]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10529, "sim/multiplay/generic/short[29]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10530, "sim/multiplay/generic/short[30]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10531, "sim/multiplay/generic/short[31]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10532, "sim/multiplay/generic/short[32]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10533, "sim/multiplay/generic/short[33]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10534, "sim/multiplay/generic/short[34]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10535, "sim/multiplay/generic/short[35]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10536, "sim/multiplay/generic/short[36]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10537, "sim/multiplay/generic/short[37]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10538, "sim/multiplay/generic/short[38]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10539, "sim/multiplay/generic/short[39]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10540, "sim/multiplay/generic/short[40]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10541, "sim/multiplay/generic/short[41]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10542, "sim/multiplay/generic/short[42]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10543, "sim/multiplay/generic/short[43]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10544, "sim/multiplay/generic/short[44]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10545, "sim/multiplay/generic/short[45]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10546, "sim/multiplay/generic/short[46]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10547, "sim/multiplay/generic/short[47]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10548, "sim/multiplay/generic/short[48]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10549, "sim/multiplay/generic/short[49]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10550, "sim/multiplay/generic/short[50]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10551, "sim/multiplay/generic/short[51]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10552, "sim/multiplay/generic/short[52]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10553, "sim/multiplay/generic/short[53]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10554, "sim/multiplay/generic/short[54]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10555, "sim/multiplay/generic/short[55]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10556, "sim/multiplay/generic/short[56]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10557, "sim/multiplay/generic/short[57]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10558, "sim/multiplay/generic/short[58]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10559, "sim/multiplay/generic/short[59]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10560, "sim/multiplay/generic/short[60]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10561, "sim/multiplay/generic/short[61]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10562, "sim/multiplay/generic/short[62]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10563, "sim/multiplay/generic/short[63]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10564, "sim/multiplay/generic/short[64]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10565, "sim/multiplay/generic/short[65]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10566, "sim/multiplay/generic/short[66]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10567, "sim/multiplay/generic/short[67]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10568, "sim/multiplay/generic/short[68]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10569, "sim/multiplay/generic/short[69]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10570, "sim/multiplay/generic/short[70]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10571, "sim/multiplay/generic/short[71]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10572, "sim/multiplay/generic/short[72]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10573, "sim/multiplay/generic/short[73]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10574, "sim/multiplay/generic/short[74]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10575, "sim/multiplay/generic/short[75]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10576, "sim/multiplay/generic/short[76]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10577, "sim/multiplay/generic/short[77]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10578, "sim/multiplay/generic/short[78]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
-    { 10579, "sim/multiplay/generic/short[79]", simgear::props::INT, TT_SHORTINT,  V1_1_2_PROP_ID, NULL },
 
-};
-
-/*
-* For the 2017.x version 2 protocol the properties are sent in two partitions,
-* the first of these is a V1 protocol packet (which should be fine with all clients), and a V2 partition
-* which will contain the newly supported shortint and fixed string encoding schemes.
-* This is to possibly allow for easier V1/V2 conversion - as the packet can simply be truncated at the
-* first V2 property based on ID.
-*/
-const int MAX_PARTITIONS = 2;
-const unsigned int numProperties = (sizeof(sIdPropertyList) / sizeof(sIdPropertyList[0]));
-
-static mINTINT mIdCounts;
 static int done_init = 0;
-void init_full_map()
+void init_id_counts()
 {
     if (done_init)
         return;
@@ -976,11 +609,7 @@ void init_full_map()
     for (i = 0; i < numProperties; i++)
     {
         id = sIdPropertyList[i].id;
-        iINTINT j = mIdCounts.find(id);
-        if (j == mIdCounts.end()) {
-            mIdCounts[id] = 0;
-        }
-        else {
+        if (findProperty(id) != &sIdPropertyList[i]) {
             dupe_cnt++;
             dupes.push_back(id);
         }
@@ -997,251 +626,12 @@ void init_full_map()
     }
 }
 
-void add_id_count(unsigned int id)
+// flat per thread counters, by table index, see prop_count_add()
+void add_id_count(const IdPropertyList *plist)
 {
     if (!done_init)
-        init_full_map();
-    mIdCounts[id]++;
-}
-
-// Look up a property ID using binary search.
-namespace
-{
-    struct ComparePropertyId
-    {
-        bool operator()(const IdPropertyList& lhs,
-            const IdPropertyList& rhs)
-        {
-            return lhs.id < rhs.id;
-        }
-        bool operator()(const IdPropertyList& lhs,
-            unsigned id)
-        {
-            return lhs.id < id;
-        }
-        bool operator()(unsigned id,
-            const IdPropertyList& rhs)
-        {
-            return id < rhs.id;
-        }
-    };
-}
-
-const IdPropertyList* findProperty(unsigned id)
-{
-    std::pair<const IdPropertyList*, const IdPropertyList*> result
-        = std::equal_range(sIdPropertyList, sIdPropertyList + numProperties, id,
-            ComparePropertyId());
-    if (result.first == result.second) {
-        return 0;
-    }
-    else {
-        return result.first;
-    }
-}
-
-
-
-
-// #else // !USE PROTO_2
-
-struct IdPropertyList1 {
-    unsigned id;
-    const char* name;
-    sgp_Type type;
-};
-
-static const IdPropertyList1* findProperty1(unsigned id);
-
-// A static map of protocol property id values to property paths,
-// This should be extendable dynamically for every specific aircraft ...
-// For now only that static list
-static const IdPropertyList1 sIdPropertyList1[] = {
-    { 100, "surface-positions/left-aileron-pos-norm",  sgp_FLOAT },
-    { 101, "surface-positions/right-aileron-pos-norm", sgp_FLOAT },
-    { 102, "surface-positions/elevator-pos-norm",      sgp_FLOAT },
-    { 103, "surface-positions/rudder-pos-norm",        sgp_FLOAT },
-    { 104, "surface-positions/flap-pos-norm",          sgp_FLOAT },
-    { 105, "surface-positions/speedbrake-pos-norm",    sgp_FLOAT },
-    { 106, "gear/tailhook/position-norm",              sgp_FLOAT },
-    { 107, "gear/launchbar/position-norm",             sgp_FLOAT },
-    { 108, "gear/launchbar/state",                     sgp_STRING },
-    { 109, "gear/launchbar/holdback-position-norm",    sgp_FLOAT },
-    { 110, "canopy/position-norm",                     sgp_FLOAT },
-    { 111, "surface-positions/wing-pos-norm",          sgp_FLOAT },
-    { 112, "surface-positions/wing-fold-pos-norm",     sgp_FLOAT },
-
-    { 200, "gear/gear[0]/compression-norm",           sgp_FLOAT },
-    { 201, "gear/gear[0]/position-norm",              sgp_FLOAT },
-    { 210, "gear/gear[1]/compression-norm",           sgp_FLOAT },
-    { 211, "gear/gear[1]/position-norm",              sgp_FLOAT },
-    { 220, "gear/gear[2]/compression-norm",           sgp_FLOAT },
-    { 221, "gear/gear[2]/position-norm",              sgp_FLOAT },
-    { 230, "gear/gear[3]/compression-norm",           sgp_FLOAT },
-    { 231, "gear/gear[3]/position-norm",              sgp_FLOAT },
-    { 240, "gear/gear[4]/compression-norm",           sgp_FLOAT },
-    { 241, "gear/gear[4]/position-norm",              sgp_FLOAT },
-
-    { 300, "engines/engine[0]/n1",  sgp_FLOAT },
-    { 301, "engines/engine[0]/n2",  sgp_FLOAT },
-    { 302, "engines/engine[0]/rpm", sgp_FLOAT },
-    { 310, "engines/engine[1]/n1",  sgp_FLOAT },
-    { 311, "engines/engine[1]/n2",  sgp_FLOAT },
-    { 312, "engines/engine[1]/rpm", sgp_FLOAT },
-    { 320, "engines/engine[2]/n1",  sgp_FLOAT },
-    { 321, "engines/engine[2]/n2",  sgp_FLOAT },
-    { 322, "engines/engine[2]/rpm", sgp_FLOAT },
-    { 330, "engines/engine[3]/n1",  sgp_FLOAT },
-    { 331, "engines/engine[3]/n2",  sgp_FLOAT },
-    { 332, "engines/engine[3]/rpm", sgp_FLOAT },
-    { 340, "engines/engine[4]/n1",  sgp_FLOAT },
-    { 341, "engines/engine[4]/n2",  sgp_FLOAT },
-    { 342, "engines/engine[4]/rpm", sgp_FLOAT },
-    { 350, "engines/engine[5]/n1",  sgp_FLOAT },
-    { 351, "engines/engine[5]/n2",  sgp_FLOAT },
-    { 352, "engines/engine[5]/rpm", sgp_FLOAT },
-    { 360, "engines/engine[6]/n1",  sgp_FLOAT },
-    { 361, "engines/engine[6]/n2",  sgp_FLOAT },
-    { 362, "engines/engine[6]/rpm", sgp_FLOAT },
-    { 370, "engines/engine[7]/n1",  sgp_FLOAT },
-    { 371, "engines/engine[7]/n2",  sgp_FLOAT },
-    { 372, "engines/engine[7]/rpm", sgp_FLOAT },
-    { 380, "engines/engine[8]/n1",  sgp_FLOAT },
-    { 381, "engines/engine[8]/n2",  sgp_FLOAT },
-    { 382, "engines/engine[8]/rpm", sgp_FLOAT },
-    { 390, "engines/engine[9]/n1",  sgp_FLOAT },
-    { 391, "engines/engine[9]/n2",  sgp_FLOAT },
-    { 392, "engines/engine[9]/rpm", sgp_FLOAT },
-
-    { 800, "rotors/main/rpm", sgp_FLOAT },
-    { 801, "rotors/tail/rpm", sgp_FLOAT },
-    { 810, "rotors/main/blade[0]/position-deg",  sgp_FLOAT },
-    { 811, "rotors/main/blade[1]/position-deg",  sgp_FLOAT },
-    { 812, "rotors/main/blade[2]/position-deg",  sgp_FLOAT },
-    { 813, "rotors/main/blade[3]/position-deg",  sgp_FLOAT },
-    { 820, "rotors/main/blade[0]/flap-deg",  sgp_FLOAT },
-    { 821, "rotors/main/blade[1]/flap-deg",  sgp_FLOAT },
-    { 822, "rotors/main/blade[2]/flap-deg",  sgp_FLOAT },
-    { 823, "rotors/main/blade[3]/flap-deg",  sgp_FLOAT },
-    { 830, "rotors/tail/blade[0]/position-deg",  sgp_FLOAT },
-    { 831, "rotors/tail/blade[1]/position-deg",  sgp_FLOAT },
-
-    { 900, "sim/hitches/aerotow/tow/length",                       sgp_FLOAT },
-    { 901, "sim/hitches/aerotow/tow/elastic-constant",             sgp_FLOAT },
-    { 902, "sim/hitches/aerotow/tow/weight-per-m-kg-m",            sgp_FLOAT },
-    { 903, "sim/hitches/aerotow/tow/dist",                         sgp_FLOAT },
-    { 904, "sim/hitches/aerotow/tow/connected-to-property-node",   sgp_BOOL },
-    { 905, "sim/hitches/aerotow/tow/connected-to-ai-or-mp-callsign",   sgp_STRING },
-    { 906, "sim/hitches/aerotow/tow/brake-force",                  sgp_FLOAT },
-    { 907, "sim/hitches/aerotow/tow/end-force-x",                  sgp_FLOAT },
-    { 908, "sim/hitches/aerotow/tow/end-force-y",                  sgp_FLOAT },
-    { 909, "sim/hitches/aerotow/tow/end-force-z",                  sgp_FLOAT },
-    { 930, "sim/hitches/aerotow/is-slave",                         sgp_BOOL },
-    { 931, "sim/hitches/aerotow/speed-in-tow-direction",           sgp_FLOAT },
-    { 932, "sim/hitches/aerotow/open",                             sgp_BOOL },
-    { 933, "sim/hitches/aerotow/local-pos-x",                      sgp_FLOAT },
-    { 934, "sim/hitches/aerotow/local-pos-y",                      sgp_FLOAT },
-    { 935, "sim/hitches/aerotow/local-pos-z",                      sgp_FLOAT },
-
-    { 1001, "controls/flight/slats",  sgp_FLOAT },
-    { 1002, "controls/flight/speedbrake",  sgp_FLOAT },
-    { 1003, "controls/flight/spoilers",  sgp_FLOAT },
-    { 1004, "controls/gear/gear-down",  sgp_FLOAT },
-    { 1005, "controls/lighting/nav-lights",  sgp_FLOAT },
-    { 1006, "controls/armament/station[0]/jettison-all",  sgp_BOOL },
-
-    { 1100, "sim/model/variant", sgp_INT },
-    { 1101, "sim/model/livery/file", sgp_STRING },
-
-    { 1200, "environment/wildfire/data", sgp_STRING },
-    { 1201, "environment/contrail", sgp_INT },
-
-    { 1300, "tanker", sgp_INT },
-
-    { 1400, "scenery/events", sgp_STRING },
-
-    { 1500, "instrumentation/transponder/transmitted-id", sgp_INT },
-    { 1501, "instrumentation/transponder/altitude", sgp_INT },
-    { 1502, "instrumentation/transponder/ident", sgp_BOOL },
-    { 1503, "instrumentation/transponder/inputs/mode", sgp_INT },
-
-    { 10001, "sim/multiplay/transmission-freq-hz",  sgp_STRING },
-    { 10002, "sim/multiplay/chat",  sgp_STRING },
-
-    { 10100, "sim/multiplay/generic/string[0]", sgp_STRING },
-    { 10101, "sim/multiplay/generic/string[1]", sgp_STRING },
-    { 10102, "sim/multiplay/generic/string[2]", sgp_STRING },
-    { 10103, "sim/multiplay/generic/string[3]", sgp_STRING },
-    { 10104, "sim/multiplay/generic/string[4]", sgp_STRING },
-    { 10105, "sim/multiplay/generic/string[5]", sgp_STRING },
-    { 10106, "sim/multiplay/generic/string[6]", sgp_STRING },
-    { 10107, "sim/multiplay/generic/string[7]", sgp_STRING },
-    { 10108, "sim/multiplay/generic/string[8]", sgp_STRING },
-    { 10109, "sim/multiplay/generic/string[9]", sgp_STRING },
-    { 10110, "sim/multiplay/generic/string[10]", sgp_STRING },
-    { 10111, "sim/multiplay/generic/string[11]", sgp_STRING },
-    { 10112, "sim/multiplay/generic/string[12]", sgp_STRING },
-    { 10113, "sim/multiplay/generic/string[13]", sgp_STRING },
-    { 10114, "sim/multiplay/generic/string[14]", sgp_STRING },
-    { 10115, "sim/multiplay/generic/string[15]", sgp_STRING },
-    { 10116, "sim/multiplay/generic/string[16]", sgp_STRING },
-    { 10117, "sim/multiplay/generic/string[17]", sgp_STRING },
-    { 10118, "sim/multiplay/generic/string[18]", sgp_STRING },
-    { 10119, "sim/multiplay/generic/string[19]", sgp_STRING },
-
-    { 10200, "sim/multiplay/generic/float[0]", sgp_FLOAT },
-    { 10201, "sim/multiplay/generic/float[1]", sgp_FLOAT },
-    { 10202, "sim/multiplay/generic/float[2]", sgp_FLOAT },
-    { 10203, "sim/multiplay/generic/float[3]", sgp_FLOAT },
-    { 10204, "sim/multiplay/generic/float[4]", sgp_FLOAT },
-    { 10205, "sim/multiplay/generic/float[5]", sgp_FLOAT },
-    { 10206, "sim/multiplay/generic/float[6]", sgp_FLOAT },
-    { 10207, "sim/multiplay/generic/float[7]", sgp_FLOAT },
-    { 10208, "sim/multiplay/generic/float[8]", sgp_FLOAT },
-    { 10209, "sim/multiplay/generic/float[9]", sgp_FLOAT },
-    { 10210, "sim/multiplay/generic/float[10]", sgp_FLOAT },
-    { 10211, "sim/multiplay/generic/float[11]", sgp_FLOAT },
-    { 10212, "sim/multiplay/generic/float[12]", sgp_FLOAT },
-    { 10213, "sim/multiplay/generic/float[13]", sgp_FLOAT },
-    { 10214, "sim/multiplay/generic/float[14]", sgp_FLOAT },
-    { 10215, "sim/multiplay/generic/float[15]", sgp_FLOAT },
-    { 10216, "sim/multiplay/generic/float[16]", sgp_FLOAT },
-    { 10217, "sim/multiplay/generic/float[17]", sgp_FLOAT },
-    { 10218, "sim/multiplay/generic/float[18]", sgp_FLOAT },
-    { 10219, "sim/multiplay/generic/float[19]", sgp_FLOAT },
-
-    { 10300, "sim/multiplay/generic/int[0]", sgp_INT },
-    { 10301, "sim/multiplay/generic/int[1]", sgp_INT },
-    { 10302, "sim/multiplay/generic/int[2]", sgp_INT },
-    { 10303, "sim/multiplay/generic/int[3]", sgp_INT },
-    { 10304, "sim/multiplay/generic/int[4]", sgp_INT },
-    { 10305, "sim/multiplay/generic/int[5]", sgp_INT },
-    { 10306, "sim/multiplay/generic/int[6]", sgp_INT },
-    { 10307, "sim/multiplay/generic/int[7]", sgp_INT },
-    { 10308, "sim/multiplay/generic/int[8]", sgp_INT },
-    { 10309, "sim/multiplay/generic/int[9]", sgp_INT },
-    { 10310, "sim/multiplay/generic/int[10]", sgp_INT },
-    { 10311, "sim/multiplay/generic/int[11]", sgp_INT },
-    { 10312, "sim/multiplay/generic/int[12]", sgp_INT },
-    { 10313, "sim/multiplay/generic/int[13]", sgp_INT },
-    { 10314, "sim/multiplay/generic/int[14]", sgp_INT },
-    { 10315, "sim/multiplay/generic/int[15]", sgp_INT },
-    { 10316, "sim/multiplay/generic/int[16]", sgp_INT },
-    { 10317, "sim/multiplay/generic/int[17]", sgp_INT },
-    { 10318, "sim/multiplay/generic/int[18]", sgp_INT },
-    { 10319, "sim/multiplay/generic/int[19]", sgp_INT }
-};
-
-const unsigned int numProperties1 = (sizeof(sIdPropertyList1)
-    / sizeof(sIdPropertyList1[0]));
-
-static const IdPropertyList1* findProperty1(unsigned id) {
-    unsigned int ui;
-    for (ui = 0; ui < numProperties1; ui++) {
-        if (sIdPropertyList1[ui].id == id)
-            return &sIdPropertyList1[ui];
-    }
-    return 0;
+        init_id_counts();
+    prop_count_add(plist);
 }
 
 #endif // USE_PROTO_2 y/n
@@ -1260,170 +650,42 @@ static double elapsed_sim_time = 0.0;
 static bool got_sim_time = false;
 
 #ifdef USE_PROTO_2
-int Deal_With_Properties(xdr_data_t * xdr, xdr_data_t * msgEnd, xdr_data_t * propsEnd)
+// decode the properties, keeping the values in the flight store, if given
+int Deal_With_Properties(xdr_data_t * xdr, xdr_data_t * msgEnd, xdr_data_t * propsEnd, PPROP_STORE ps)
 {
-    static char _s_text[MAX_TEXT_SIZE];
+    MP_PROP_VAL pv;
     char *cp;
     int prop_cnt = 0;
     xdr_data_t * bgn_xdr;
     while (xdr < msgEnd) {
         bgn_xdr = xdr;  // Keep the start location
-        // First element is always the ID
-        // int id = XDR_decode<int>(*xdr);
-#ifdef USE_SIMGEAR
-        unsigned id = XDR_decode_uint32(*xdr);
-        /*
-        * As we can detect a short int encoded value (by the upper word being non-zero) we can
-        * do the decode here; set the id correctly, extract the integer and set the flag.
-        * This can then be picked up by the normal processing based on the flag
-        */
-        int int_value = 0;
-        bool short_int_encoded = false;
-        if (id & 0xffff0000)
-        {
-            int v1, v2;
-            XDR_decode_shortints32(*xdr, v1, v2);
-            int_value = v2;
-            id = v1;
-            short_int_encoded = true;
-        }
-#else 
-        unsigned id = XDR_decode<int>(*xdr);
-#endif
-        //cout << pData->id << " ";
-        xdr++;
-        const IdPropertyList* plist = findProperty(id);
-        const IdPropertyList1* plist1 = findProperty1(id);  // get the previous 'list', if there is one...
+        // decode through the table driven per id decoder
+        xdr = Decode_Property(xdr, &pv);
+        unsigned id = pv.id;
+        const IdPropertyList* plist = pv.plist;
         if (plist)
         {
-            const char *dt = "UNK";
-            int ival = 0;
-            double val = 0.0;
-            // uint32_t length = 0;
-            uint32_t txtlen = 0;
-            // uint32_t offset = 0;
-            add_2_ids(id);
-            // How we decode the remainder of the property depends on the type
-            switch (plist->type) {
-            case simgear::props::INT:
-            case simgear::props::BOOL:
-            case simgear::props::LONG:
-                if (short_int_encoded)
-                {
-                    ival = int_value;
-                    dt = "EINT";
-                    //pData->type = simgear::props::INT;
-                }
-                else
-                {
-                    ival = XDR_decode_uint32(*xdr);
-                    xdr++;
-                    dt = "INT";
-                }
+            add_id_count(plist);
+            if (ps)
+                prop_store_set(ps, &pv);
+            switch (pv.kind) {
+            case pk_Int:
                 if (VERB5) {
-                    SPRTF("[v5]: %u %s %s %d\n", id, plist->name, dt, ival);
+                    SPRTF("[v5]: %u %s %s %d\n", id, plist->name, pv.dt, pv.ival);
                 }
-                //cout << pData->int_value << "\n";
                 prop_cnt++;
                 break;
-            case simgear::props::FLOAT:
-            case simgear::props::DOUBLE:
-                if (short_int_encoded)
-                {
-                    switch (plist->TransmitAs)
-                    {
-                    case TT_SHORT_FLOAT_1:
-                        val = (double)int_value / 10.0;
-                        // pData->float_value = (double)int_value / 10.0;
-                        dt = "FLOAT_1";
-                        break;
-                    case TT_SHORT_FLOAT_2:
-                        val = (double)int_value / 100.0;
-                        dt = "FLOAT_2";
-                        break;
-                    case TT_SHORT_FLOAT_3:
-                        val = (double)int_value / 1000.0;
-                        dt = "FLOAT_3";
-                        break;
-                    case TT_SHORT_FLOAT_4:
-                        val = (double)int_value / 10000.0;
-                        dt = "FLOAT_4";
-                        break;
-                    case TT_SHORT_FLOAT_NORM:
-                        val = (double)int_value / 32767.0;
-                        dt = "FLOAT_N";
-                        break;
-                    default:
-                        break;
-                    }
-                }
-                else
-                {
-                    val = XDR_decode_float(*xdr);
-                    xdr++;
-                    dt = "FLOAT";
-                }
+            case pk_Float:
                 if (VERB5) {
-                    SPRTF("[v5]: %u %s %s %lf\n", id, plist->name, dt, val);
+                    SPRTF("[v5]: %u %s %s %lf\n", id, plist->name, pv.dt, pv.dval);
                 }
                 prop_cnt++;
                 break;
-            case simgear::props::STRING:
-            case simgear::props::UNSPECIFIED:
-                // if the string is using short int encoding then it is in the new format.
-                if (short_int_encoded)
-                {
-                    uint32_t length = int_value;
-                    //pData->string_value = new char[length + 1];
-                    cp = _s_text;
-                    char *cptr = (char*)xdr;
-                    for (unsigned i = 0; i < length; i++)
-                    {
-                        //pData->string_value[i] = *cptr++;
-                        cp[i] = *cptr++;
-                    }
-                    //pData->string_value[length] = '\0';
-                    cp[length] = 0;
-                    xdr = (xdr_data_t*)cptr;
-                    dt = "STRING_N";
-                }
-                else {
-                    // String is complicated. It consists of
-                    // The length of the string
-                    // The string itself
-                    // Padding to the nearest 4-bytes.    
-                    uint32_t length = XDR_decode_uint32(*xdr);
-                    xdr++;
-                    //cout << length << " ";
-                    // Old versions truncated the string but left the length unadjusted.
-                    if (length > MAX_TEXT_SIZE)
-                        length = MAX_TEXT_SIZE;
-                    //pData->string_value = new char[length + 1];
-                    cp = _s_text;
-                    //cout << " String: ";
-                    for (unsigned i = 0; i < length; i++)
-                    {
-                        //pData->string_value[i] = (char)XDR_decode_int8(*xdr);
-                        cp[i] = (char)XDR_decode_int8(*xdr);
-                        xdr++;
-                    }
-
-                    cp[length] = '\0';
-                    txtlen = length;
-                    // Now handle the padding
-                    while ((length % 4) != 0)
-                    {
-                        xdr++;
-                        length++;
-                        //cout << "0";
-                    }
-                    dt = "STRING";
-                    //cout << "\n";
-                }
+            case pk_String:
                 if (VERB9) {
-                    SPRTF("[v5]: %u %s %s len %d: '%s'\n", id, plist->name, dt, txtlen, cp);
+                    SPRTF("[v5]: %u %s %s len %d: '%s'\n", id, plist->name, pv.dt, pv.txtlen, pv.text);
                 } else if (VERB5) {
-                    SPRTF("[v5]: %u %s %s len %d\n", id, plist->name, dt, txtlen);
+                    SPRTF("[v5]: %u %s %s len %d\n", id, plist->name, pv.dt, pv.txtlen);
                 }
                 prop_cnt++;
                 break;
@@ -1432,23 +694,21 @@ int Deal_With_Properties(xdr_data_t * xdr, xdr_data_t * msgEnd, xdr_data_t * pro
                 sprintf(cp, "%s: Unknown Prop type %d\n", module, (int)id);
                 if (add_2_list(cp))
                     SPRTF("%s", cp);
-                xdr++;  // assume there was a following INT!
                 break;
             }
-            if (plist1)
-            {
-                // This will probably be the SAME???
-                if (strcmp(plist->name, plist1->name)) {
-                    if (VERB9) {
+            if (VERB9) {
+                // compare with the previous 'list', if there is one...
+                const IdPropertyList1* plist1 = findProperty1(id);
+                if (plist1)
+                {
+                    // This will probably be the SAME???
+                    if (strcmp(plist->name, plist1->name)) {
                         SPRTF("[v9]: %5d: Strings are different!\n", id);
                         SPRTF("1: %s\n", plist1->name);
                         SPRTF("2: %s\n", plist->name);
                     }
                 }
-            }
-            else
-            {
-                if (VERB9 && show_not_in_version1)
+                else if (show_not_in_version1)
                 {
                     SPRTF("[v9]: %5d: Such a property did NOT exist in Version 1!\n", id);
                 }
@@ -1459,7 +719,6 @@ int Deal_With_Properties(xdr_data_t * xdr, xdr_data_t * msgEnd, xdr_data_t * pro
             sprintf(cp, "%s: %u: Not in the Prop list...\n", module, id);
             if (add_2_list(cp))
                 SPRTF("%s", cp);
-            xdr++;
         }
         if (VERB9 && show_consumed_bytes) {
             size_t consumed = ((char *)xdr - (char *)bgn_xdr);
@@ -1471,7 +730,7 @@ int Deal_With_Properties(xdr_data_t * xdr, xdr_data_t * msgEnd, xdr_data_t * pro
 
 #else // !USE_PROTO_2
 
-int Deal_With_Properties(xdr_data_t * xdr, xdr_data_t * msgEnd, xdr_data_t * propsEnd)
+int Deal_With_Properties(xdr_data_t * xdr, xdr_data_t * msgEnd, xdr_data_t * propsEnd, PPROP_STORE ps)
 {
     static char _s_text[MAX_TEXT_SIZE];
     xdr_data_t * txd;
@@ -1632,14 +891,17 @@ Packet_Type Deal_With_Packet(char *packet, int len)
     uint32_t        MsgLen;
     uint32_t        MsgProto;
     T_PositionMsg*  PosMsg;
+#ifndef USE_SIMGEAR
+    T_PositionNative PosNat;
+#endif
     PT_MsgHdr       MsgHdr;
-    PCF_Pilot       pp, pp2;
+    PCF_Pilot       pp, pp2 = 0;
     size_t          max, ii;
     //char           *upd_by;
     double          sseconds;
     // char           *tb = _s_tdchk;
     //bool            revived;
-    time_t          curr_time = time(0);
+    time_t          curr_time = clock_now();
     double          lat, lon, alt;
     double          px, py, pz;
     char           *pcs;
@@ -1699,7 +961,8 @@ Packet_Type Deal_With_Packet(char *packet, int len)
 #ifdef USE_SIMGEAR
         pp->sim_time = XDR_decode_double(PosMsg->time); // get SIM time
 #else
-        pp->sim_time = XDR_decode64<double>(PosMsg->time); // get SIM time
+        XDR_decode_position(PosMsg, &PosNat); // all the numeric fields, in one pass
+        pp->sim_time = PosNat.time; // get SIM time
 #endif
         pm = get_Model(PosMsg->Model);
         strcpy(pp->aircraft, pm);
@@ -1719,12 +982,12 @@ Packet_Type Deal_With_Packet(char *packet, int len)
 #else
         pp->SenderAddress = XDR_decode<uint32_t>(MsgHdr->ReplyAddress);
         pp->SenderPort = XDR_decode<uint32_t>(MsgHdr->ReplyPort);
-        px = XDR_decode64<double>(PosMsg->position[X]);
-        py = XDR_decode64<double>(PosMsg->position[Y]);
-        pz = XDR_decode64<double>(PosMsg->position[Z]);
-        pp->ox = XDR_decode<float>(PosMsg->orientation[X]);
-        pp->oy = XDR_decode<float>(PosMsg->orientation[Y]);
-        pp->oz = XDR_decode<float>(PosMsg->orientation[Z]);
+        px = PosNat.position[X];
+        py = PosNat.position[Y];
+        pz = PosNat.position[Z];
+        pp->ox = PosNat.orientation[X];
+        pp->oy = PosNat.orientation[Y];
+        pp->oz = PosNat.orientation[Z];
 #endif
         if ((px == 0.0) || (py == 0.0) || (pz == 0.0)) {
             failed_cnt++;
@@ -1801,24 +1064,24 @@ Packet_Type Deal_With_Packet(char *packet, int len)
             &pp->heading, &pp->pitch, &pp->roll);
 
         pp->linearVel.Set(
-            XDR_decode<float>(PosMsg->linearVel[X]),
-            XDR_decode<float>(PosMsg->linearVel[Y]),
-            XDR_decode<float>(PosMsg->linearVel[Z])
+            PosNat.linearVel[X],
+            PosNat.linearVel[Y],
+            PosNat.linearVel[Z]
         );
         pp->angularVel.Set(
-            XDR_decode<float>(PosMsg->angularVel[X]),
-            XDR_decode<float>(PosMsg->angularVel[Y]),
-            XDR_decode<float>(PosMsg->angularVel[Z])
+            PosNat.angularVel[X],
+            PosNat.angularVel[Y],
+            PosNat.angularVel[Z]
         );
         pp->linearAccel.Set(
-            XDR_decode<float>(PosMsg->linearAccel[X]),
-            XDR_decode<float>(PosMsg->linearAccel[Y]),
-            XDR_decode<float>(PosMsg->linearAccel[Z])
+            PosNat.linearAccel[X],
+            PosNat.linearAccel[Y],
+            PosNat.linearAccel[Z]
         );
         pp->angularAccel.Set(
-            XDR_decode<float>(PosMsg->angularAccel[X]),
-            XDR_decode<float>(PosMsg->angularAccel[Y]),
-            XDR_decode<float>(PosMsg->angularAccel[Z])
+            PosNat.angularAccel[X],
+            PosNat.angularAccel[Y],
+            PosNat.angularAccel[Z]
         );
         pp->speed = cf_norm(pp->linearVel) * SG_METER_TO_NM * 3600.0;
 #endif // #ifdef USE_SIMGEAR
@@ -1872,6 +1135,7 @@ Packet_Type Deal_With_Packet(char *packet, int len)
                 pp->total_nm = pp2->total_nm + (pp->dist_m * SG_METER_TO_NM);
                 SETPREVPOS(pp, pp2);  // copy POS to PrevPos to get distance travelled
                 pp->curr_time = curr_time; // set CURRENT packet time
+                pp->props = pp2->props; // keep the flight property store
                 *pp2 = *pp;     // UPDATE the RECORD with latest info
                 // print_pilot(pp2, upd_by, pt_Pos);
                 //if (revived)
@@ -1886,6 +1150,7 @@ Packet_Type Deal_With_Packet(char *packet, int len)
             //  print_pilot(pp2,upd_by,pt_Pos);
             // print_pilot(pp, (char *)"C", pt_Pos);
             print_pilot(pp2, (char *)"S", pt_Pos);
+            trace_pilot(pp2, tev_Pos);
         }
         else {
             pp->packetCount = 1;
@@ -1897,8 +1162,11 @@ Packet_Type Deal_With_Packet(char *packet, int len)
             pp->flight_id = get_epoch_id(); // establish UNIQUE ID for flight
             pp->dist_m = 0.0;
             pp->total_nm = 0.0;
+            pp->props = prop_store_new();
             vPilots.push_back(*pp);
+            pp2 = &vPilots.back();
             print_pilot(pp, (char *)"N", pt_Pos);
+            trace_pilot(pp, tev_New);
 
         }
 
@@ -1907,9 +1175,13 @@ Packet_Type Deal_With_Packet(char *packet, int len)
         xdr_data_t * xdr =(xdr_data_t *)(packet + sizeof(T_MsgHdr) + sizeof(T_PositionMsg));
         xdr_data_t * msgEnd = (xdr_data_t *)(packet + len);
         xdr_data_t * propsEnd = (xdr_data_t *)(packet + MAX_PACKET_SIZE);
-        int prop_cnt = Deal_With_Properties(xdr, msgEnd, propsEnd);
+        uint32_t gen = prop_store_begin(pp2->props, pp2->sim_time);
+        int prop_cnt = Deal_With_Properties(xdr, msgEnd, propsEnd, pp2->props);
         if (VERB5) {
-            SPRTF("[v5]: Done position packet: len %d bytes, %d props...\n", len, prop_cnt);
+            int ind, changed = 0;
+            for (ind = -1; (ind = prop_store_next_changed(pp2->props, gen - 1, ind)) >= 0; )
+                changed++;
+            SPRTF("[v5]: Done position packet: len %d bytes, %d props, %d changed...\n", len, prop_cnt, changed);
         }
         return pkt_Pos;
 
@@ -1923,34 +1195,6 @@ Packet_Type Deal_With_Packet(char *packet, int len)
  return pkt_Invalid;
 }
 
-static bool isFGFS(char *cp)
-{
-    if ((cp[0] == 'F') && (cp[1] == 'G') &&
-        (cp[2] == 'F') && (cp[3] == 'S'))
-        return true;
-    return false;
-}
-
-//#define RELAY_MAGIC 0x53464746    // GSGF
-static bool isRELAY(char *cp)
-{
-    if ((cp[0] == 'S') && (cp[1] == 'F') &&
-        (cp[2] == 'G') && (cp[3] == 'F'))
-        return true;
-    return false;
-
-}
-
-static bool isMagicHdr(char *cp)
-{
-    if ((isFGFS(cp) || isRELAY(cp)) &&
-        (cp[4] == 0) && (cp[5] == 1) &&
-        (cp[6] == 0) && (cp[7] == 1)) {
-        return true;
-    }
-    return false;
-}
-
 /////////////////////////////////////////////////////////////////
 // int get_next_block()
 //
@@ -1959,8 +1203,8 @@ static bool isMagicHdr(char *cp)
 // whihc 'decodes' the udp packet, and stores the 'live'
 // pilots into the vector vPilots.
 //
-// Then will read any remaining data from the file to re-fill
-// the buffer, and search for the 'next' udp packet.
+// Then will frame the 'next' udp packet, by its MsgLen, skipping,
+// and counting, any damage, see cf_rawframe.hxx.
 //
 // If fails to find 'next' udp packet will return 0 - sort of
 // like end of file.
@@ -1979,76 +1223,96 @@ static bool isMagicHdr(char *cp)
 //
 /////////////////////////////////////////////////////////////////
 
-static int get_next_block()
+static void close_rec()
+{
+    if (rec_log)
+        reclog_close(rec_log);
+    rec_log = 0;
+#ifdef USE_BLOCK_LOG
+    if (blk_log) {
+        if (VERB1)
+            blklog_show_stats(blk_log);
+        blklog_close(blk_log);
+    }
+    blk_log = 0;
+#endif
+    rec_len = 0;
+}
+
+static int read_rec()
+{
+#ifdef USE_BLOCK_LOG
+    if (blk_log)
+        return blklog_read(blk_log, &rec_packet, 0);
+#endif
+    return reclog_read(rec_log, &rec_packet, 0);
+}
+
+static int get_next_rec()
 {
-    int key = 0;
     Packet_Type pt;
-    size_t i, j, size = raw_data_size;  // MAX_RAW_LOG;
-    char *cp = raw_log_buffer;
-    if (cp && raw_block_size) {
-        pt = Deal_With_Packet(cp, raw_block_size);  // deal with this known 'packet'
-        packet_cnt++;
-        if (pt < pkt_Max) sPktStr[pt].count++;  // set the packet stats
-        j = 0;
-        for (i = raw_block_size; i < size; i++) {
-            cp[j++] = cp[i];    // move remainder up to head of buffer, ready for next read if more...
-        }
-        raw_log_remaining -= raw_block_size;    // reduce remaining in raw log
-        raw_data_size = raw_data_size - raw_block_size;  // set size of remaining raw data after this packet
-        if (raw_log_fp) {
-            size = raw_block_size;  // size to read at end of buffer
-            if (raw_log_remaining < size) {
-                size = raw_log_remaining;
-            }
-            // load more dat at offset of used bloc size, potentially fill buffer
-            size_t rd = fread(&cp[raw_data_size], 1, size, raw_log_fp);
-            raw_block_size = 0;
-            if (rd == size) {
-                raw_data_size += size;  // bump by this read
-                i = 0;
-                // this has to be true - just a debug check
-                //if (!isMagicHdr(&cp[i])) {
-                //    goto Bad_Read;
-                //}
-                for (i = 4; i < raw_data_size; i++) {
-                    if (isMagicHdr(&cp[i])) {
-                        break;
-                    }
-                    if (cp[i] == 0)
-                        g_null_count++; // keep absolute count of NULL (0) in the file
-                }
-                raw_block_size = i; // either found next, or out of data, 
-                key = 1;    // but have next block
-            }
-            else {
- // Bad_Read:
-                if (feof(raw_log_fp)) {
-                    if (VERB9)
-                    {
-                        SPRTF("[v9]: %s: Reached EOF!\n", module);
-                    }
-                }
-                else {
-                    SPRTF("%s: Failed to get the next raw block!\n", module);
+    if (!rec_len)
+        return 0;
+    pt = Deal_With_Packet(rec_packet, rec_len);
+    packet_cnt++;
+    if (pt < pkt_Max) sPktStr[pt].count++;  // set the packet stats
+    rec_len = read_rec();
+    if (rec_len <= 0) {
+        if (rec_len < 0)
+            SPRTF("%s: Failed to get the next recorded packet!\n", module);
+        close_rec();
+        return 0;
+    }
+    return 1;
+}
 
-                }
-                fclose(raw_log_fp);
-                raw_log_fp = 0;
-                free(raw_log_buffer);
-                raw_log_buffer = 0;
-            }
-        }
+static void close_raw()
+{
+    if (raw_frame) {
+        if (VERB1 || rawframe_has_damage(raw_frame))
+            rawframe_show_stats(raw_frame);
+        rawframe_close(raw_frame);
     }
-    return key;
+    raw_frame = 0;
+    raw_len = 0;
+}
+
+static int get_next_block()
+{
+    Packet_Type pt;
+    int i;
+    if (rec_len)
+        return get_next_rec();
+    if (!raw_len)
+        return 0;
+    pt = Deal_With_Packet(raw_packet, raw_len);  // deal with this known 'packet'
+    packet_cnt++;
+    if (pt < pkt_Max) sPktStr[pt].count++;  // set the packet stats
+    for (i = 4; i < raw_len; i++) {
+        if (raw_packet[i] == 0)
+            g_null_count++; // keep absolute count of NULL (0) in the file
+    }
+    raw_log_remaining -= raw_len;   // reduce remaining in raw log
+    raw_len = rawframe_next(raw_frame, &raw_packet);
+    if (raw_len <= 0) {
+        if (raw_len < 0)
+            SPRTF("%s: Failed to get the next raw block!\n", module);
+        else if (VERB9)
+            SPRTF("[v9]: %s: Reached EOF!\n", module);
+        close_raw();
+        return 0;
+    }
+    return 1;
 }
 
 
 /////////////////////////////////////////////////////////////////
 // int open_raw_log()
 // 
-// Open the raw log 'rb', allocate a read buffer, and
-// search for the first udp block/packet.
-// Search up to the *next* isMagicHdr
+// Open the raw log, framed and read ahead, see cf_rawframe.hxx,
+// and frame the first udp block/packet.
+// A compact recording, or block compressed log, is opened, and its
+// first packet read, instead.
 //
 // If successful return 0, else 1 is an error
 //
@@ -2064,76 +1328,50 @@ static int open_raw_log()
         return 1;
     }
     size_t size = sbuf.st_size;
-    if (size <= MAX_RAW_LOG) {
-        SPRTF("%s: Files '%s' too small! Only %u bytes!\n", module, tf, (int)size);
-        return 1;
-
+#ifdef USE_BLOCK_LOG
+    if (blklog_is_blk(tf)) {
+        blk_log = blklog_open(tf);
+        if (!blk_log)
+            return 1;
+    } else
+#endif
+    if (reclog_is_rec(tf)) {
+        rec_log = reclog_open(tf);
+        if (!rec_log)
+            return 1;
     }
-    raw_log_size = size;
-    raw_log_remaining = size;
-    if (size > MAX_RAW_LOG) {
-        size = MAX_RAW_LOG;
+    if (rec_log
+#ifdef USE_BLOCK_LOG
+        || blk_log
+#endif
+        ) {
+        rec_len = read_rec();
+        if (rec_len <= 0) {
+            SPRTF("%s: Failed to read the first packet of '%s'!\n", module, tf);
+            close_rec();
+            return 1;
+        }
+        raw_log_size = size;
+        raw_bgn_secs = get_seconds();   // start of raw log reading
+        return 0;
     }
-    char *cp = (char *)malloc(size);
-    if (!cp) {
-        SPRTF("%s: memory allocation FAILED\n", module);
+    if (!size) {
+        SPRTF("%s: Files '%s' has no size!\n", module, tf);
         return 1;
     }
-    FILE *fp = fopen(tf, "rb");
-    if (!fp) {
-        SPRTF("%s: Failed to open '%s'!\n", module, tf);
-        free(cp);
+    raw_log_size = size;
+    raw_log_remaining = size;
+    raw_frame = rawframe_open(tf, VERB2 ? 100 : 0);
+    if (!raw_frame)
         return 1;
-    }
-    size_t rd = fread(cp, 1, size, fp);
-    if (rd != size) {
-        SPRTF("%s: Failed read of '%s'! Req %u, got %u?\n", module, tf, (int)size, (int)rd);
-        fclose(fp);
-        free(cp);
+    raw_len = rawframe_next(raw_frame, &raw_packet);
+    if (raw_len <= 0) {
+        SPRTF("%s: Failed find first udp packet in '%s'!\n", module, tf);
+        close_raw();
         return 1;
     }
-
-    size_t i, j, bgn;
-    for (i = 0; i < size; i++) {
-        if (isMagicHdr(&cp[i])) {
-            if (i) {
-                // UGH, not at head - move ALL data up to head
-                bgn = i;
-                j = 0;
-                for (; i < size; i++) {
-                    if (cp[i] == 0)
-                        g_null_count++; // keep absolute count of NULL (0) in the file
-                    cp[j++] = cp[i];
-                }
-                rd = fread(&cp[j], 1, bgn, fp);    // top up the buffer from the file
-                if (rd != bgn) {
-                    SPRTF("%s: Failed read of '%s'! Req %u, got %u?\n", module, tf, (int)bgn, (int)rd);
-                    fclose(fp);
-                    free(cp);
-                    return 1;
-                }
-            }
-            // search for next
-            for (i = 4; i < size; i++) {
-                if (isMagicHdr(&cp[i])) {
-                    // end of first block
-                    raw_log_fp = fp;
-                    raw_log_buffer = cp;
-                    raw_block_size = i;
-                    raw_data_size = size;
-                    raw_bgn_secs = get_seconds();   // start of raw log reading
-                    return 0;
-                }
-                if (cp[i] == 0)
-                    g_null_count++; // keep absolute count of NULL (0) in the file
-            }
-        }
-    }
-    free(cp);
-    if (fp)
-        fclose(fp);
-    SPRTF("%s: Failed find first udp packet in '%s'!\n", module, tf);
-    return 1;
+    raw_bgn_secs = get_seconds();   // start of raw log reading
+    return 0;
 }
 
 static int process_log() // actions of app
@@ -2142,11 +1380,19 @@ static int process_log() // actions of app
     if (open_raw_log())
         return 1;
     while (get_next_block()) {
+        clock_tick();
         blk_cnt++;
     }
     if (VERB1)
     {
-        size_t ii, len = vIdsUsed.size();
+        vPROPCNT vCounts;
+        size_t ii, len = 0, max;
+        prop_count_merge(vCounts);
+        max = vCounts.size();
+        for (ii = 0; ii < max; ii++) {
+            if (vCounts[ii].count)
+                len++;
+        }
         SPRTF("%s: Processed %d mp packets... using %d of %d prop ids...\n", module,
             (int)(blk_cnt ? blk_cnt + 1 : blk_cnt),
             (int)len,
@@ -2154,13 +1400,12 @@ static int process_log() // actions of app
         );
         if (len) {
             uint32_t id, cnt, havecnt = 0, total = 0;
-            iINTINT p;
             const char *pt;
             const IdPropertyList *list;
             if (VERB5) {
-                for (p = mIdCounts.begin(); p != mIdCounts.end(); p++)
+                for (ii = 0; ii < max; ii++)
                 {
-                    cnt = p->second;
+                    cnt = vCounts[ii].count;
                     if (cnt)
                         havecnt++;
                     total++;
@@ -2168,48 +1413,40 @@ static int process_log() // actions of app
                 SPRTF("[v5]: Show of %d of %d properties that have a count...\n", (int)havecnt, (int)total);
                      //    10    20 sim/multiplay/protocol-version
                 SPRTF("Id     Count Property\n");
-                for (p = mIdCounts.begin(); p != mIdCounts.end(); p++)
+                for (ii = 0; ii < max; ii++)
                 {
-                    id = p->first;
-                    cnt = p->second;
+                    id = vCounts[ii].id;
+                    cnt = vCounts[ii].count;
                     if (cnt) {
-                        list = findProperty(id);
-                        if (list) {
-                            pt = type2stg(list->type);
-                            SPRTF("%5u %5u %s %s\n", id, cnt, list->name, pt);
-                        }
-                        else
-                            SPRTF("%5u %5u\n", id, cnt);
+                        list = vCounts[ii].plist;
+                        pt = type2stg(list->type);
+                        SPRTF("%5u %5u %s %s\n", id, cnt, list->name, pt);
                     }
                 }
                 if (VERB9) {
                     // show all entries that have NO count
                     SPRTF("[v9]: Show of %d of %d properties that have NO count...\n", (int)(total - havecnt), (int)total);
                     SPRTF("Id     Count Property\n");
-                    for (p = mIdCounts.begin(); p != mIdCounts.end(); p++)
+                    for (ii = 0; ii < max; ii++)
                     {
-                        id = p->first;
-                        cnt = p->second;
+                        id = vCounts[ii].id;
+                        cnt = vCounts[ii].count;
                         if (!cnt) {
-                            list = findProperty(id);
-                            if (list) {
-                                pt = type2stg(list->type);
-                                SPRTF("%5u %5u %s %s\n", id, cnt, list->name, pt);
-                            }
-                            else
-                                SPRTF("%5u %5u\n", id, cnt);
+                            list = vCounts[ii].plist;
+                            pt = type2stg(list->type);
+                            SPRTF("%5u %5u %s %s\n", id, cnt, list->name, pt);
                         }
 
                     }
                 }
             }
             else if (VERB2) {
-                // using default comparison (operator <):
-                std::sort(vIdsUsed.begin(), vIdsUsed.end());           //(12 32 45 71)26 80 53 33
-                // just show simple oneline list - no counts
+                // counts are in id order, so just show simple oneline list - no counts
                 SPRTF("[v2]: Props %d ids: ", (int)len);
-                for (ii = 0; ii < len; ii++)
-                    SPRTF("%d ", vIdsUsed[ii]);
+                for (ii = 0; ii < max; ii++) {
+                    if (vCounts[ii].count)
+                        SPRTF("%d ", vCounts[ii].id);
+                }
                 SPRTF("\n");
             }
         }
@@ -2261,12 +1498,16 @@ int chk_log_file(int argc, char **argv)
 void clean_up()
 {
     vWarnings.clear();
-    vIdsUsed.clear();
+    size_t ii, max = vPilots.size();
+    for (ii = 0; ii < max; ii++)
+        prop_store_free(vPilots[ii].props);
     vPilots.clear();
-    mIdCounts.clear();
+    prop_count_clear();
+    trace_close();
 }
 
 void Create_Prop_Packet();
+int Test_XDR_Round_Trip();
 
 // main() OS entry
 int main( int argc, char **argv )
@@ -2283,9 +1524,25 @@ int main( int argc, char **argv )
     }
 
     if (do_packet_test) {
+        Test_XDR_Round_Trip();
         Create_Prop_Packet();
     }
 
+#ifdef USE_BLOCK_LOG
+    if (zip_out)
+        return blklog_from_raw(usr_input, zip_out);
+    if (convert && blklog_is_blk(usr_input))
+        return blklog_to_raw(usr_input, convert);
+#endif
+    if (convert) {
+        if (reclog_is_rec(usr_input))
+            return reclog_to_raw(usr_input, convert);
+        return reclog_from_raw(usr_input, convert);
+    }
+
+    if (journal && trace_open(journal))
+        return 1;
+
     iret = process_log(); // TODO: actions of app
     show_packet_stats();
     show_warnings();
@@ -2294,30 +1551,7 @@ int main( int argc, char **argv )
 }
 
 /////////////////////////////////////////////////////////////////////////
-//// Create a full property packet
-// short FGMultiplayMgr::get_scaled_short(double v, double scale)
-short get_scaled_short(double v, double scale)
-{
-    float nv = v * scale;
-    if (nv >= 32767) return 32767;
-    if (nv <= -32767) return -32767;
-    short rv = (short)nv;
-    return rv;
-}
-
-int get_nxt_int()
-{
-    static int next_int = 0;
-    next_int++;
-    return next_int;
-}
-double get_nxt_dbl()
-{
-    static double next_dbl = 0.0;
-    next_dbl += 0.1;
-    return next_dbl;
-}
-
+//// Create a full property packet, show it, and decode it
 void Create_Prop_Packet()
 {
     int protocolVersion = 2;
@@ -2325,20 +1559,11 @@ void Create_Prop_Packet()
     char Msg[MAX_PACKET_SIZE];
     size_t msgHdr = sizeof(T_MsgHdr);
     size_t posMsg = sizeof(T_PositionMsg);
-    xdr_data_t *ptr = reinterpret_cast<xdr_data_t*>(Msg + msgHdr + posMsg);
-    xdr_data_t *msgEnd = reinterpret_cast<xdr_data_t*>(Msg + (MAX_PACKET_SIZE));
+    xdr_data_t *msgEnd;
     xdr_data_t *xdr;
-    int partition = 1;
-    int propsDone = 0;
     int partcount[4];
     vUINT vIdsAdded;
-    int ival;
-    double dval;
-    const char *pt;
-    const char* lcharptr;
-    uint32_t len, plen;
     char fill = (char)0xee;
-    bool overflow = false;
 
     SPRTF("Packet pad bytes %d, hdr %d, pos %d, rem %d bytes, for 'props'\n", (int)sizeof(Msg), (int)msgHdr, (int)posMsg,
         (sizeof(Msg) - msgHdr - posMsg));
@@ -2348,352 +1573,9 @@ void Create_Prop_Packet()
     for (i = 0; i < 4; i++)
         partcount[i] = 0;
 
-    for (partition = 1; partition <= protocolVersion; partition++)
-    {
-        for (i = 0; i < numProperties; i++)
-        {
-            // std::vector<FGPropertyData*>::const_iterator it = motionInfo.properties.begin();
-            // while (it != motionInfo.properties.end()) {
-            pid = sIdPropertyList[i].id;
-            const struct IdPropertyList* propDef = &sIdPropertyList[i]; // mPropertyDefinition[(*it)->id];
-            
-            //if (pid > 10319)
-            //    break;
-            xdr = ptr;
-            if (propDef->version == partition || propDef->version > protocolVersion) // getProtocolToUse())
-            {
-                if (ptr + 2 >= msgEnd)
-                {
-                    // SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer packet truncated prop id: " << (*it)->id << ": " << propDef->name);
-                    SPRTF("\nWARNING: Multiplayer packet truncated prop id: %d\nnode: %s\n", pid, propDef->name);
-                    overflow = true;
-                    goto escape;
-                }
-
-                // First element is the ID. Write it out when we know we have room for
-                // the whole property.
-                xdr_data_t id = XDR_encode_uint32(pid); // (*it)->id);
-
-
-                /*
-                * 2017.2 protocol has the ability to transmit as a different type (to save space), so
-                * process this when using this protocol (protocolVersion 2) or later
-                */
-                int transmit_type = propDef->type;  // (*it)->type;
-
-                if (propDef->TransmitAs != TT_ASIS && protocolVersion > 1)
-                {
-                    transmit_type = propDef->TransmitAs;
-                }
-#if 0 // 00000000000000000000000000000000000000000
-                if (pMultiPlayDebugLevel->getIntValue() & 2)
-                    SG_LOG(SG_NETWORK, SG_INFO,
-                        "[SEND] pt " << partition <<
-                        ": buf[" << (ptr - data) * sizeof(*ptr)
-                        << "] id=" << (*it)->id << " type " << transmit_type);
-#endif // 0000000000000000000000000000000000000000
-
-                // The actual data representation depends on the type
-                switch (transmit_type) {
-                case TT_SHORTINT:
-                {
-                    if (pid == 10)
-                        ival = protocolVersion;
-                    else
-                        ival = get_nxt_int();
-                    //*ptr++ = XDR_encode_shortints32((*it)->id, (*it)->int_value);
-                    *ptr++ = XDR_encode_shortints32(pid, ival);
-                    propsDone++;
-                    partcount[partition]++;
-                    vIdsAdded.push_back(pid);
-                    plen = (char *)ptr - (char *)xdr;
-                    if (VERB9)
-                        SPRTF("[v9]: %5d: %s SHORTINT %d (%d)\n", pid, propDef->name, ival, (int)plen);
-                    break;
-                }
-                case TT_SHORT_FLOAT_1:
-                {
-                    //short value = get_scaled_short((*it)->float_value, 10.0);
-                    //*ptr++ = XDR_encode_shortints32((*it)->id, value);
-                    dval = get_nxt_dbl();
-                    short value = get_scaled_short(dval, 10.0);
-                    *ptr++ = XDR_encode_shortints32(pid, value);
-                    propsDone++;
-                    partcount[partition]++;
-                    vIdsAdded.push_back(pid);
-                    plen = (char *)ptr - (char *)xdr;
-                    if (VERB9)
-                        SPRTF("[v9]: %5d: %s FLOAT_1 %lf (%d)\n", pid, propDef->name, dval, (int)plen);
-                    break;
-                }
-                case TT_SHORT_FLOAT_2:
-                {
-                    //short value = get_scaled_short((*it)->float_value, 100.0);
-                    //*ptr++ = XDR_encode_shortints32((*it)->id, value);
-                    dval = get_nxt_dbl();
-                    short value = get_scaled_short(dval, 100.0);
-                    *ptr++ = XDR_encode_shortints32(pid, value);
-                    propsDone++;
-                    partcount[partition]++;
-                    vIdsAdded.push_back(pid);
-                    plen = (char *)ptr - (char *)xdr;
-                    if (VERB9)
-                        SPRTF("[v9]: %5d: %s FLOAT_2 %lf (%d)\n", pid, propDef->name, dval, (int)plen);
-                    break;
-                }
-                case TT_SHORT_FLOAT_3:
-                {
-                    //short value = get_scaled_short((*it)->float_value, 1000.0);
-                    //*ptr++ = XDR_encode_shortints32((*it)->id, value);
-                    dval = get_nxt_dbl();
-                    short value = get_scaled_short(dval, 1000.0);
-                    *ptr++ = XDR_encode_shortints32(pid, value);
-                    propsDone++;
-                    partcount[partition]++;
-                    vIdsAdded.push_back(pid);
-                    plen = (char *)ptr - (char *)xdr;
-                    if (VERB9)
-                        SPRTF("[v9]: %5d: %s FLOAT_3 %lf (%d)\n", pid, propDef->name, dval, (int)plen);
-                    break;
-                }
-                case TT_SHORT_FLOAT_4:
-                {
-                    //short value = get_scaled_short((*it)->float_value, 10000.0);
-                    //*ptr++ = XDR_encode_shortints32((*it)->id, value);
-                    dval = get_nxt_dbl();
-                    short value = get_scaled_short(dval, 10000.0);
-                    *ptr++ = XDR_encode_shortints32(pid, value);
-                    propsDone++;
-                    partcount[partition]++;
-                    vIdsAdded.push_back(pid);
-                    plen = (char *)ptr - (char *)xdr;
-                    if (VERB9)
-                        SPRTF("[v9]: %5d: %s FLOAT_4 %lf (%d)\n", pid, propDef->name, dval, (int)plen);
-                    break;
-                }
-
-                case TT_SHORT_FLOAT_NORM:
-                {
-                    //short value = get_scaled_short((*it)->float_value, 32767.0);
-                    //*ptr++ = XDR_encode_shortints32((*it)->id, value);
-                    dval = get_nxt_dbl();
-                    short value = get_scaled_short(dval, 32767.0);
-                    *ptr++ = XDR_encode_shortints32(pid, value);
-                    propsDone++;
-                    partcount[partition]++;
-                    vIdsAdded.push_back(pid);
-                    plen = (char *)ptr - (char *)xdr;
-                    if (VERB9)
-                        SPRTF("[v9]: %5d: %s FLOAT_N %lf (%d)\n", pid, propDef->name, dval, (int)plen);
-                    break;
-                }
-
-                case simgear::props::INT:
-                case simgear::props::BOOL:
-                case simgear::props::LONG:
-                    *ptr++ = id;
-                    //*ptr++ = XDR_encode_uint32((*it)->int_value);
-                    ival = get_nxt_int();
-                    *ptr++ = XDR_encode_uint32(ival);
-                    propsDone++;
-                    partcount[partition]++;
-                    vIdsAdded.push_back(pid);
-                    plen = (char *)ptr - (char *)xdr;
-                    if (VERB9)
-                        SPRTF("[v9]: %5d: %s LONG %d (%d)\n", pid, propDef->name, ival, (int)plen);
-                    break;
-                case simgear::props::FLOAT:
-                case simgear::props::DOUBLE:
-                    *ptr++ = id;
-                    dval = get_nxt_dbl();
-                    //*ptr++ = XDR_encode_float((*it)->float_value);
-                    *ptr++ = XDR_encode_float(dval);
-                    propsDone++;
-                    partcount[partition]++;
-                    vIdsAdded.push_back(pid);
-                    plen = (char *)ptr - (char *)xdr;
-                    if (VERB9)
-                        SPRTF("[v9]: %5d: %s DOUBLE %lf (%d)\n", pid, propDef->name, dval, (int)plen);
-                    break;
-                case simgear::props::STRING:
-                case simgear::props::UNSPECIFIED:
-                {
-                    len = 0;
-                    pt = "UNK";
-                    if (protocolVersion > 1)
-                    {
-                        // New string encoding:
-                        // xdr[0] : ID length packed into 32 bit containing two shorts.
-                        // xdr[1..len/4] The string itself (char[length])
-                        //const char* lcharptr = (*it)->string_value;
-                        lcharptr = "";
-                        pt = "STRING_N";
-                        if (lcharptr != 0)
-                        {
-                            len = strlen(lcharptr);
-                            if (len >= MAX_TEXT_SIZE)
-                            {
-                                len = MAX_TEXT_SIZE - 1;
-                                //SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer property truncated at MAX_TEXT_SIZE in string " << (*it)->id);
-                                SPRTF("\nWARNING: Multiplayer property truncated at MAX_TEXT_SIZE in string id %d\n", pid);
-                            }
-
-                            char *encodeStart = (char*)ptr;
-                            char *msgEndbyte = (char*)msgEnd;
-
-                            if (encodeStart + 2 + len >= msgEndbyte)
-                            {
-                                //SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer property not sent (no room) string " << (*it)->id);
-                                SPRTF("\nWARNING: Multiplayer property not sent (no room) string %d\n", pid);
-                                overflow = true;
-                                goto escape;
-                            }
-
-                            //*ptr++ = XDR_encode_shortints32((*it)->id, len);
-                            *ptr++ = XDR_encode_shortints32(pid, len);
-                            encodeStart = (char*)ptr;
-                            if (len != 0)
-                            {
-                                int lcount = 0;
-                                while (*lcharptr && (lcount < MAX_TEXT_SIZE))
-                                {
-                                    if (encodeStart + 2 >= msgEndbyte)
-                                    {
-                                        //SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer packet truncated in string " << (*it)->id << " lcount " << lcount);
-                                        SPRTF("\nWARNING: Multiplayer packet truncated in string %d, lcount %d\n", pid, lcount);
-                                        overflow = true;
-                                        break;
-                                    }
-                                    *encodeStart++ = *lcharptr++;
-                                    lcount++;
-                                }
-                            }
-                            ptr = (xdr_data_t*)encodeStart;
-                            propsDone++;
-                            partcount[partition]++;
-                            vIdsAdded.push_back(pid);
-                        }
-                        else
-                        {
-                            // empty string, just send the id and a zero length
-                            *ptr++ = id;
-                            *ptr++ = XDR_encode_uint32(0);
-                            propsDone++;
-                            partcount[partition]++;
-                            vIdsAdded.push_back(pid);
-                        }
-                    }
-                    else {
-
-                        // String is complicated. It consists of
-                        // The length of the string
-                        // The string itself
-                        // Padding to the nearest 4-bytes.        
-                        // const char* lcharptr = (*it)->string_value;
-                        lcharptr = "";
-                        pt = "STRING";
-                        if (lcharptr != 0)
-                        {
-                            // Add the length         
-                            ////cout << "String length: " << strlen(lcharptr) << "\n";
-                            len = strlen(lcharptr);
-                            if (len >= MAX_TEXT_SIZE)
-                            {
-                                len = MAX_TEXT_SIZE - 1;
-                                //SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer property truncated at MAX_TEXT_SIZE in string " << (*it)->id);
-                                SPRTF("\nWARNING: Multiplayer property truncated at MAX_TEXT_SIZE in string %d\n", pid );
-                            }
-
-                            // XXX This should not be using 4 bytes per character!
-                            // If there's not enough room for this property, drop it
-                            // on the floor.
-                            if (ptr + 2 + ((len + 3) & ~3) >= msgEnd)
-                            {
-                                // SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer property not sent (no room) string " << (*it)->id);
-                                SPRTF("\nWARNING: Multiplayer property not sent (no room) string %d\n", pid );
-                                overflow = true;
-                                goto escape;
-                            }
-                            //cout << "String length unint32: " << len << "\n";
-                            *ptr++ = id;
-                            *ptr++ = XDR_encode_uint32(len);
-                            if (len != 0)
-                            {
-                                // Now the text itself
-                                // XXX This should not be using 4 bytes per character!
-                                int lcount = 0;
-                                while ((*lcharptr != '\0') && (lcount < MAX_TEXT_SIZE))
-                                {
-                                    if (ptr + 2 >= msgEnd)
-                                    {
-                                        //SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer packet truncated in string " << (*it)->id << " lcount " << lcount);
-                                        SPRTF("\nWARNING: Multiplayer packet truncated in string %d, lcount %d\n", pid, lcount);
-                                        overflow = true;
-                                        break;
-                                    }
-                                    *ptr++ = XDR_encode_int8(*lcharptr);
-                                    lcharptr++;
-                                    lcount++;
-                                }
-                                // Now pad if required
-                                while ((lcount % 4) != 0)
-                                {
-                                    if (ptr + 2 >= msgEnd)
-                                    {
-                                        // SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer packet truncated in string " << (*it)->id << " lcount " << lcount);
-                                        SPRTF("\nWARNING: Multiplayer packet truncated in string %d, lcount %d\n", pid, lcount);
-                                        overflow = true;
-                                        break;
-                                    }
-                                    *ptr++ = XDR_encode_int8(0);
-                                    lcount++;
-                                }
-                            }
-                            propsDone++;
-                            partcount[partition]++;
-                            vIdsAdded.push_back(pid);
-                        }
-                        else
-                        {
-                            // Nothing to encode
-                            *ptr++ = id;
-                            *ptr++ = XDR_encode_uint32(0);
-                            propsDone++;
-                            partcount[partition]++;
-                            vIdsAdded.push_back(pid);
-                        }
-                    }
-                    plen = (char *)ptr - (char *)xdr;
-                    if (VERB9)
-                        SPRTF("[v9]: %5d: %s %s %d (%d)\n", pid, propDef->name, pt, (int)len, (int)plen);
-
-                }
-                break;
-
-                default:
-                    *ptr++ = id;
-                    //*ptr++ = XDR_encode_float((*it)->float_value);;
-                    dval = get_nxt_dbl();
-                    *ptr++ = XDR_encode_float(dval);
-                    propsDone++;
-                    partcount[partition]++;
-                    vIdsAdded.push_back(pid);
-                    plen = (char *)ptr - (char *)xdr;
-                    if (VERB9)
-                        SPRTF("[v9]: %5d: %s DEF_DOUBLE %lf\n", pid, propDef->name, dval, (int)plen);
-                    break;
-                }
-            }
-            //++it;
-            if (overflow)
-                break;
-        }
-        if (overflow)
-            break;
-    }
-escape:
-    unsigned int msgLen = reinterpret_cast<char*>(ptr) - Msg;   // msgBuf.Msg;
-    SPRTF("Done %d of %d v2 properties (v1=%d)... partition %d... ", propsDone, numProperties, numProperties1, partition);
+    unsigned int msgLen = Build_Prop_Packet( Msg, protocolVersion, VERB9, vIdsAdded, partcount );
+    int propsDone = (int)vIdsAdded.size();
+    SPRTF("Done %d of %d v2 properties (v1=%d)... protocol %d... ", propsDone, numProperties, numProperties1, protocolVersion);
     for (i = 0; i < 4; i++) {
         if (partcount[i])
             SPRTF("%d: %d ", i, partcount[i]);
@@ -2745,7 +1627,7 @@ escape:
     ////////////////////////////////////////////////////////////////////////////
     SPRTF("\nShow decode of props part of packet created...\n");
     verbosity = 9;
-    int prop_cnt = Deal_With_Properties(xdr, msgEnd, propsEnd);
+    int prop_cnt = Deal_With_Properties(xdr, msgEnd, propsEnd, 0);
     if (VERB5) {
         SPRTF("[v5]: Done packet: len %d bytes, %d props...\n", msgLen, prop_cnt);
     }
@@ -2753,4 +1635,177 @@ escape:
     exit(1);
 }
 
+/////////////////////////////////////////////////////////////////////////
+//// Round trip every tiny_xdr template instantiation, and check the wire order
+#ifndef USE_SIMGEAR
+static int xdr_checks = 0;
+static int xdr_fails = 0;
+
+static void xdr_check( bool ok, const char *what, int ind )
+{
+    xdr_checks++;
+    if (!ok) {
+        xdr_fails++;
+        SPRTF("XDR FAILED: %s, value %d\n", what, ind);
+    }
+}
+
+// compare as bytes, so float/double compare exactly
+#define XDR_SAME(a,b) (memcmp(&(a), &(b), sizeof(a)) == 0)
+
+// the narrower templates static_assert on wider types,
+// so each is only instantiated for the sizes it accepts
+template<typename TYPE, int SIZE> struct XdrRT;
+template<typename TYPE> struct XdrRT<TYPE,1> {
+    static TYPE x32(TYPE v) { return XDR_decode<TYPE>(XDR_encode<TYPE>(v)); }
+    static TYPE n8(TYPE v) { return NET_decode8<TYPE>(NET_encode8<TYPE>(v)); }
+    static TYPE n16(TYPE v) { return NET_decode16<TYPE>(NET_encode16<TYPE>(v)); }
+    static TYPE n32(TYPE v) { return NET_decode32<TYPE>(NET_encode32<TYPE>(v)); }
+};
+template<typename TYPE> struct XdrRT<TYPE,2> {
+    static TYPE x32(TYPE v) { return XDR_decode<TYPE>(XDR_encode<TYPE>(v)); }
+    static TYPE n8(TYPE v) { return v; }
+    static TYPE n16(TYPE v) { return NET_decode16<TYPE>(NET_encode16<TYPE>(v)); }
+    static TYPE n32(TYPE v) { return NET_decode32<TYPE>(NET_encode32<TYPE>(v)); }
+};
+template<typename TYPE> struct XdrRT<TYPE,4> {
+    static TYPE x32(TYPE v) { return XDR_decode<TYPE>(XDR_encode<TYPE>(v)); }
+    static TYPE n8(TYPE v) { return v; }
+    static TYPE n16(TYPE v) { return v; }
+    static TYPE n32(TYPE v) { return NET_decode32<TYPE>(NET_encode32<TYPE>(v)); }
+};
+template<typename TYPE> struct XdrRT<TYPE,8> {
+    static TYPE x32(TYPE v) { return v; }
+    static TYPE n8(TYPE v) { return v; }
+    static TYPE n16(TYPE v) { return v; }
+    static TYPE n32(TYPE v) { return v; }
+};
+template<typename TYPE>
+static void xdr_round_trip( const TYPE *vals, int cnt, const char *name )
+{
+    typedef XdrRT<TYPE, sizeof(TYPE)> RT;
+    char what[64];
+    int i;
+    for (i = 0; i < cnt; i++) {
+        TYPE v = vals[i], r;
+        if (sizeof(TYPE) <= 4) {
+            sprintf(what, "XDR_encode/decode<%s>", name);
+            r = RT::x32(v);
+            xdr_check(XDR_SAME(r, v), what, i);
+        }
+        sprintf(what, "XDR_encode64/decode64<%s>", name);
+        r = XDR_decode64<TYPE>(XDR_encode64<TYPE>(v));
+        xdr_check(XDR_SAME(r, v), what, i);
+        if (sizeof(TYPE) == 1) {
+            sprintf(what, "NET_encode8/decode8<%s>", name);
+            r = RT::n8(v);
+            xdr_check(XDR_SAME(r, v), what, i);
+        }
+        if (sizeof(TYPE) <= 2) {
+            sprintf(what, "NET_encode16/decode16<%s>", name);
+            r = RT::n16(v);
+            xdr_check(XDR_SAME(r, v), what, i);
+        }
+        if (sizeof(TYPE) <= 4) {
+            sprintf(what, "NET_encode32/decode32<%s>", name);
+            r = RT::n32(v);
+            xdr_check(XDR_SAME(r, v), what, i);
+        }
+        sprintf(what, "NET_encode64/decode64<%s>", name);
+        r = NET_decode64<TYPE>(NET_encode64<TYPE>(v));
+        xdr_check(XDR_SAME(r, v), what, i);
+    }
+}
+
+#endif // #ifndef USE_SIMGEAR
+
+int Test_XDR_Round_Trip()
+{
+#ifndef USE_SIMGEAR
+    static const int8_t i8[] = { 0, 1, -1, 127, -128 };
+    static const uint8_t u8[] = { 0, 1, 0x7f, 0x80, 0xff };
+    static const int16_t i16[] = { 0, 1, -1, 32767, -32768, 0x1234 };
+    static const uint16_t u16[] = { 0, 1, 0x7fff, 0x8000, 0xffff, 0x1234 };
+    static const int32_t i32[] = { 0, 1, -1, 0x7fffffff, (int32_t)0x80000000, 0x12345678 };
+    static const uint32_t u32[] = { 0, 1, 0x7fffffff, 0x80000000, 0xffffffff, 0x12345678 };
+    static const float f32[] = { 0.0f, -0.0f, 1.0f, -1.5f, 3.4e38f, 1.2e-38f, 0.1f };
+    static const int64_t i64[] = { 0, 1, -1, 0x7fffffffffffffffLL, (int64_t)0x8000000000000000ULL, 0x123456789abcdef0LL };
+    static const uint64_t u64[] = { 0, 1, 0x7fffffffffffffffULL, 0x8000000000000000ULL, 0xffffffffffffffffULL, 0x123456789abcdef0ULL };
+    static const double f64[] = { 0.0, -0.0, 1.0, -1.5, 1.7e308, 2.3e-308, 0.1, 6378137.0 };
+    unsigned char *cp;
+    xdr_data_t x;
+    xdr_data2_t x2;
+    uint16_t n16;
+    int i, v1, v2;
+    xdr_checks = xdr_fails = 0;
+
+    xdr_round_trip(i8, (int)(sizeof(i8) / sizeof(i8[0])), "int8_t");
+    xdr_round_trip(u8, (int)(sizeof(u8) / sizeof(u8[0])), "uint8_t");
+    xdr_round_trip(i16, (int)(sizeof(i16) / sizeof(i16[0])), "int16_t");
+    xdr_round_trip(u16, (int)(sizeof(u16) / sizeof(u16[0])), "uint16_t");
+    xdr_round_trip(i32, (int)(sizeof(i32) / sizeof(i32[0])), "int32_t");
+    xdr_round_trip(u32, (int)(sizeof(u32) / sizeof(u32[0])), "uint32_t");
+    xdr_round_trip(f32, (int)(sizeof(f32) / sizeof(f32[0])), "float");
+    xdr_round_trip(i64, (int)(sizeof(i64) / sizeof(i64[0])), "int64_t");
+    xdr_round_trip(u64, (int)(sizeof(u64) / sizeof(u64[0])), "uint64_t");
+    xdr_round_trip(f64, (int)(sizeof(f64) / sizeof(f64[0])), "double");
+
+    // big endian on the wire
+    x = XDR_encode<uint32_t>(0x01020304);
+    cp = (unsigned char *)&x;
+    xdr_check((cp[0] == 1) && (cp[1] == 2) && (cp[2] == 3) && (cp[3] == 4), "XDR_encode wire order", 0);
+    x2 = XDR_encode64<uint64_t>(0x0102030405060708ULL);
+    cp = (unsigned char *)&x2;
+    for (i = 0; i < 8; i++) {
+        if (cp[i] != (i + 1))
+            break;
+    }
+    xdr_check(i == 8, "XDR_encode64 wire order", 0);
+    n16 = NET_encode16<uint16_t>(0x0102);
+    cp = (unsigned char *)&n16;
+    xdr_check((cp[0] == 1) && (cp[1] == 2), "NET_encode16 wire order", 0);
+    x = XDR_encode<uint32_t>(RELAY_MAGIC);
+    xdr_check(memcmp(&x, "SFGF", 4) == 0, "XDR_encode RELAY_MAGIC", 0);
+
+    // packed short ints
+    for (i = 0; i < 6; i++) {
+        XDR_decode_shortints32(XDR_encode_shortints32(i16[i], i16[5 - i]), v1, v2);
+        xdr_check((v1 == XDR_convert_int_to_short(i16[i])) &&
+            (v2 == XDR_convert_int_to_short(i16[5 - i])), "XDR_encode/decode_shortints32", i);
+    }
+
+    // bulk position decode against the scalar decodes
+    T_PositionMsg pm;
+    T_PositionNative pn;
+    memset(&pm, 0, sizeof(pm));
+    pm.time = XDR_encode64<double>(f64[7]);
+    pm.lag = XDR_encode64<double>(f64[6]);
+    for (i = 0; i < 3; i++) {
+        pm.position[i] = XDR_encode64<double>(f64[i + 2] * 1000.0);
+        pm.orientation[i] = XDR_encode<float>(f32[i + 2]);
+        pm.linearVel[i] = XDR_encode<float>(f32[i + 3]);
+        pm.angularVel[i] = XDR_encode<float>(f32[i + 4]);
+        pm.linearAccel[i] = XDR_encode<float>(-f32[i + 2]);
+        pm.angularAccel[i] = XDR_encode<float>((float)(i + 1));
+    }
+    XDR_decode_position(&pm, &pn);
+    bool ok = (pn.time == XDR_decode64<double>(pm.time)) && (pn.lag == XDR_decode64<double>(pm.lag));
+    for (i = 0; i < 3; i++) {
+        ok = ok && (pn.position[i] == XDR_decode64<double>(pm.position[i]));
+        ok = ok && (pn.orientation[i] == XDR_decode<float>(pm.orientation[i]));
+        ok = ok && (pn.linearVel[i] == XDR_decode<float>(pm.linearVel[i]));
+        ok = ok && (pn.angularVel[i] == XDR_decode<float>(pm.angularVel[i]));
+        ok = ok && (pn.linearAccel[i] == XDR_decode<float>(pm.linearAccel[i]));
+        ok = ok && (pn.angularAccel[i] == XDR_decode<float>(pm.angularAccel[i]));
+    }
+    xdr_check(ok, "XDR_decode_position", 0);
+
+    SPRTF("XDR round trip: %d checks, %d failed. (%s endian host)\n", xdr_checks, xdr_fails,
+        (sgIsLittleEndian() ? "little" : "big"));
+    return xdr_fails;
+#else // USE_SIMGEAR
+    return 0;
+#endif // USE_SIMGEAR y/n
+}
+
 // eof = raw-log.cxx
@@ -16,70 +16,60 @@
 //      For further reading on XDR read RFC 1832.
 //
 //////////////////////////////////////////////////////////////////////
+//      The byte order is fixed at compile time, in mpMsgs.hxx, the
+//      swaps are single bswap instructions, and the type punning
+//      is by memcpy, which compiles away, in place of unions.
+//////////////////////////////////////////////////////////////////////
+#include <string.h> // for memcpy()
 
 /**
  * xdr encode 8, 16 and 32 Bit values
  */
 template<typename TYPE>
-xdr_data_t XDR_encode ( TYPE Val )
+inline xdr_data_t XDR_encode ( TYPE Val )
 {
-        union
-        {
-                xdr_data_t      encoded;
-                TYPE            raw;
-        } tmp;
-
-        tmp.raw = Val;
-        tmp.encoded = SWAP32(tmp.encoded);
-        return (tmp.encoded);
+        static_assert(sizeof(TYPE) <= sizeof(xdr_data_t), "XDR_encode of more than 32 bits");
+        xdr_data_t encoded = 0;
+        memcpy(&encoded, &Val, sizeof(TYPE));
+        return SWAP32(encoded);
 }
 
 /**
  * xdr decode 8, 16 and 32 Bit values
  */
 template<typename TYPE>
-TYPE XDR_decode ( xdr_data_t Val )
+inline TYPE XDR_decode ( xdr_data_t Val )
 {
-        union
-        {
-                xdr_data_t      encoded;
-                TYPE            raw;
-        } tmp;
-
-        tmp.encoded = SWAP32(Val);
-        return (tmp.raw);
+        static_assert(sizeof(TYPE) <= sizeof(xdr_data_t), "XDR_decode of more than 32 bits");
+        TYPE raw;
+        xdr_data_t decoded = SWAP32(Val);
+        memcpy(&raw, &decoded, sizeof(TYPE));
+        return raw;
 }
 
 /**
  * xdr encode 64 Bit values
  */
 template<typename TYPE>
-xdr_data2_t XDR_encode64 ( TYPE Val )
+inline xdr_data2_t XDR_encode64 ( TYPE Val )
 {
-        union
-        {
-                xdr_data2_t     encoded;
-                TYPE            raw;
-        } tmp;
-
-        tmp.raw = Val;
-        tmp.encoded = SWAP64(tmp.encoded);
-        return (tmp.encoded);
+        static_assert(sizeof(TYPE) <= sizeof(xdr_data2_t), "XDR_encode64 of more than 64 bits");
+        xdr_data2_t encoded = 0;
+        memcpy(&encoded, &Val, sizeof(TYPE));
+        return SWAP64(encoded);
 }
 
 /**
  * xdr decode 64 Bit values
  */
 template<typename TYPE>
-TYPE XDR_decode64 ( xdr_data2_t Val )
+inline TYPE XDR_decode64 ( xdr_data2_t Val )
 {
-        union {
-            xdr_data2_t     encoded;
-            TYPE            raw;
-        } tmp;
-
-        tmp.encoded = SWAP64 (Val);
-        return (tmp.raw);
+        static_assert(sizeof(TYPE) <= sizeof(xdr_data2_t), "XDR_decode64 of more than 64 bits");
+        TYPE raw;
+        xdr_data2_t decoded = SWAP64(Val);
+        memcpy(&raw, &decoded, sizeof(TYPE));
+        return raw;
 }
 
 
@@ -94,17 +84,12 @@ TYPE XDR_decode64 ( xdr_data2_t Val )
  * (actually encodes nothing, just to satisfy the templates)
  */
 template<typename TYPE>
-uint8_t
+inline uint8_t
 NET_encode8 ( TYPE Val )
 {
-        union
-        {
-                uint8_t netbyte;
-                TYPE    raw;
-        } tmp;
-
-        tmp.raw = Val;
-        return (tmp.netbyte);
+        uint8_t netbyte = 0;
+        memcpy(&netbyte, &Val, 1);
+        return netbyte;
 }
 
 /**
@@ -112,123 +97,209 @@ NET_encode8 ( TYPE Val )
  * (actually decodes nothing, just to satisfy the templates)
  */
 template<typename TYPE>
-TYPE
+inline TYPE
 NET_decode8 ( uint8_t Val )
 {
-        union
-        {
-                uint8_t netbyte;
-                TYPE    raw;
-        } tmp;
-
-        tmp.netbyte = Val;
-        return (tmp.raw);
+        static_assert(sizeof(TYPE) == 1, "NET_decode8 of more than 8 bits");
+        TYPE raw;
+        memcpy(&raw, &Val, 1);
+        return raw;
 }
 
 /**
  * encode 16-Bit values to network byte order
  */
 template<typename TYPE>
-uint16_t
+inline uint16_t
 NET_encode16 ( TYPE Val )
 {
-        union
-        {
-                uint16_t        netbyte;
-                TYPE            raw;
-        } tmp;
-
-        tmp.raw = Val;
-        tmp.netbyte = SWAP16(tmp.netbyte);
-        return (tmp.netbyte);
+        static_assert(sizeof(TYPE) <= sizeof(uint16_t), "NET_encode16 of more than 16 bits");
+        uint16_t netbyte = 0;
+        memcpy(&netbyte, &Val, sizeof(TYPE));
+        return SWAP16(netbyte);
 }
 
 /**
  * decode 16-Bit values from network byte order
  */
 template<typename TYPE>
-TYPE
+inline TYPE
 NET_decode16 ( uint16_t Val )
 {
-        union
-        {
-                uint16_t        netbyte;
-                TYPE            raw;
-        } tmp;
-
-        tmp.netbyte = SWAP16(Val);
-        return (tmp.raw);
+        static_assert(sizeof(TYPE) <= sizeof(uint16_t), "NET_decode16 of more than 16 bits");
+        TYPE raw;
+        uint16_t netbyte = SWAP16(Val);
+        memcpy(&raw, &netbyte, sizeof(TYPE));
+        return raw;
 }
 
 /**
  * encode 32-Bit values to network byte order
  */
 template<typename TYPE>
-uint32_t
+inline uint32_t
 NET_encode32 ( TYPE Val )
 {
-        union
-        {
-                uint32_t        netbyte;
-                TYPE            raw;
-        } tmp;
-
-        tmp.raw = Val;
-        tmp.netbyte = SWAP32(tmp.netbyte);
-        return (tmp.netbyte);
+        static_assert(sizeof(TYPE) <= sizeof(uint32_t), "NET_encode32 of more than 32 bits");
+        uint32_t netbyte = 0;
+        memcpy(&netbyte, &Val, sizeof(TYPE));
+        return SWAP32(netbyte);
 }
 
 /**
  * decode 32-Bit values from network byte order
  */
 template<typename TYPE>
-TYPE
+inline TYPE
 NET_decode32 ( uint32_t Val )
 {
-        union
-        {
-                uint32_t        netbyte;
-                TYPE            raw;
-        } tmp;
-
-        tmp.netbyte = SWAP32(Val);
-        return (tmp.raw);
+        static_assert(sizeof(TYPE) <= sizeof(uint32_t), "NET_decode32 of more than 32 bits");
+        TYPE raw;
+        uint32_t netbyte = SWAP32(Val);
+        memcpy(&raw, &netbyte, sizeof(TYPE));
+        return raw;
 }
 
 /**
  * encode 64-Bit values to network byte order
  */
 template<typename TYPE>
-uint64_t
+inline uint64_t
 NET_encode64 ( TYPE Val )
 {
-        union
-        {
-                uint64_t        netbyte;
-                TYPE            raw;
-        } tmp;
-
-        tmp.raw = Val;
-        tmp.netbyte = SWAP64(tmp.netbyte);
-        return (tmp.netbyte);
+        static_assert(sizeof(TYPE) <= sizeof(uint64_t), "NET_encode64 of more than 64 bits");
+        uint64_t netbyte = 0;
+        memcpy(&netbyte, &Val, sizeof(TYPE));
+        return SWAP64(netbyte);
 }
 
 /**
  * decode 64-Bit values from network byte order
  */
 template<typename TYPE>
-TYPE
+inline TYPE
 NET_decode64 ( uint64_t Val )
 {
-        union
-        {
-                uint64_t        netbyte;
-                TYPE            raw;
-        } tmp;
-        tmp.netbyte = SWAP64(Val);
-        return (tmp.raw);
+        static_assert(sizeof(TYPE) <= sizeof(uint64_t), "NET_decode64 of more than 64 bits");
+        TYPE raw;
+        uint64_t netbyte = SWAP64(Val);
+        memcpy(&raw, &netbyte, sizeof(TYPE));
+        return raw;
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+//      named helpers, as xdr_lib provides them when USE_SIMGEAR,
+//      so the same decode/encode code compiles either way
+//
+//////////////////////////////////////////////////////////////////////
+inline xdr_data_t XDR_encode_int8    ( const int8_t & n_Val )   { return XDR_encode<int32_t>(n_Val); }
+inline int8_t     XDR_decode_int8    ( const xdr_data_t & n_Val ) { return static_cast<int8_t>(XDR_decode<int32_t>(n_Val)); }
+inline xdr_data_t XDR_encode_int32   ( const int32_t & n_Val )  { return XDR_encode<int32_t>(n_Val); }
+inline xdr_data_t XDR_encode_uint32  ( const uint32_t & n_Val ) { return XDR_encode<uint32_t>(n_Val); }
+inline int32_t    XDR_decode_int32   ( const xdr_data_t & n_Val ) { return XDR_decode<int32_t>(n_Val); }
+inline uint32_t   XDR_decode_uint32  ( const xdr_data_t & n_Val ) { return XDR_decode<uint32_t>(n_Val); }
+inline xdr_data_t XDR_encode_float   ( const float & f_Val )    { return XDR_encode<float>(f_Val); }
+inline float      XDR_decode_float   ( const xdr_data_t & f_Val ) { return XDR_decode<float>(f_Val); }
+inline xdr_data2_t XDR_encode_double ( const double & d_Val )   { return XDR_encode64<double>(d_Val); }
+inline double     XDR_decode_double  ( const xdr_data2_t & d_Val ) { return XDR_decode64<double>(d_Val); }
+
+/*
+ * Pack two 16bit shorts into a 32 bit int. By convention v1 is packed in the highword
+ */
+inline short XDR_convert_int_to_short(int v1)
+{
+    if (v1 < -32767)
+        v1 = -32767;
+    if (v1 > 32767)
+        v1 = 32767;
+    return (short)v1;
+}
+
+inline xdr_data_t XDR_encode_shortints32(const int v1, const int v2)
+{
+    return XDR_encode_uint32(((XDR_convert_int_to_short(v1) << 16) & 0xffff0000) | ((XDR_convert_int_to_short(v2)) & 0xffff));
+}
+
+/* Decode packed shorts into two ints. V1 in the highword ($V1..V2..)*/
+inline void XDR_decode_shortints32(const xdr_data_t & n_Val, int &v1, int &v2)
+{
+    int _v1 = XDR_decode_int32(n_Val);
+    short s2 = (short)(_v1 & 0xffff);
+    short s1 = (short)(_v1 >> 16);
+    v1 = s1;
+    v2 = s2;
 }
 
+//////////////////////////////////////////////////////////////////////
+//
+//      bulk decode of the fixed layout numeric block of a
+//      T_PositionMsg, time through angularAccel, into native
+//      values in one pass, in place of some 20 scalar decodes.
+//      The doubles are swapped as 3 x 16 bytes and the floats as
+//      4 x 16 bytes, with pshufb when SSSE3 is enabled at compile
+//      time, else a plain bswap loop. The extra bytes each group
+//      touches are within the message, and land in the pad members.
+//
+//////////////////////////////////////////////////////////////////////
+#include <stddef.h> // for offsetof()
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+struct T_PositionNative {
+    double time;
+    double lag;
+    double position[3];
+    double pad_d;           // takes the 6th double swapped
+    float orientation[3];
+    float linearVel[3];
+    float angularVel[3];
+    float linearAccel[3];
+    float angularAccel[3];
+    float pad_f;            // takes the message pad
+};
+
+#define XDR_POS_DBL_OFF  offsetof(T_PositionMsg, time)
+#define XDR_POS_FLT_OFF  offsetof(T_PositionMsg, orientation)
+static_assert(XDR_POS_DBL_OFF + 48 <= sizeof(T_PositionMsg), "position doubles swap overruns T_PositionMsg");
+static_assert(XDR_POS_FLT_OFF + 64 <= sizeof(T_PositionMsg), "position floats swap overruns T_PositionMsg");
+static_assert(sizeof(T_PositionNative) == 112, "T_PositionNative must be packed");
+
+inline void XDR_decode_position( const T_PositionMsg *PosMsg, T_PositionNative *pn )
+{
+    const char *src = (const char *)PosMsg;
+#if defined(XDR_HOST_BIG_ENDIAN)
+    memcpy(&pn->time, src + XDR_POS_DBL_OFF, 5 * sizeof(double));
+    memcpy(pn->orientation, src + XDR_POS_FLT_OFF, 15 * sizeof(float));
+#elif defined(__SSSE3__)
+    const __m128i swap64 = _mm_set_epi8(8,9,10,11,12,13,14,15, 0,1,2,3,4,5,6,7);
+    const __m128i swap32 = _mm_set_epi8(12,13,14,15, 8,9,10,11, 4,5,6,7, 0,1,2,3);
+    const __m128i *dsrc = (const __m128i *)(src + XDR_POS_DBL_OFF);
+    const __m128i *fsrc = (const __m128i *)(src + XDR_POS_FLT_OFF);
+    __m128i *ddst = (__m128i *)&pn->time;
+    __m128i *fdst = (__m128i *)pn->orientation;
+    _mm_storeu_si128(ddst + 0, _mm_shuffle_epi8(_mm_loadu_si128(dsrc + 0), swap64));
+    _mm_storeu_si128(ddst + 1, _mm_shuffle_epi8(_mm_loadu_si128(dsrc + 1), swap64));
+    _mm_storeu_si128(ddst + 2, _mm_shuffle_epi8(_mm_loadu_si128(dsrc + 2), swap64));
+    _mm_storeu_si128(fdst + 0, _mm_shuffle_epi8(_mm_loadu_si128(fsrc + 0), swap32));
+    _mm_storeu_si128(fdst + 1, _mm_shuffle_epi8(_mm_loadu_si128(fsrc + 1), swap32));
+    _mm_storeu_si128(fdst + 2, _mm_shuffle_epi8(_mm_loadu_si128(fsrc + 2), swap32));
+    _mm_storeu_si128(fdst + 3, _mm_shuffle_epi8(_mm_loadu_si128(fsrc + 3), swap32));
+#else
+    uint64_t d[5];
+    uint32_t f[15];
+    int i;
+    memcpy(d, src + XDR_POS_DBL_OFF, sizeof(d));
+    memcpy(f, src + XDR_POS_FLT_OFF, sizeof(f));
+    for (i = 0; i < 5; i++)
+        d[i] = sg_bswap_64(d[i]);
+    for (i = 0; i < 15; i++)
+        f[i] = sg_bswap_32(f[i]);
+    memcpy(&pn->time, d, sizeof(d));
+    memcpy(pn->orientation, f, sizeof(f));
+#endif
+}
 
 #endif // #ifndef _TINY_XDR_HXX_
 //////////////////////////////////////////////////////////////////////////////////////////////